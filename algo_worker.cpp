@@ -0,0 +1,290 @@
+/* algo_worker.cpp - background traversals streamed back through an SPSC ring */
+#include "algo_worker.h"
+
+#include <chrono>
+
+using namespace std;
+
+shared_ptr<const CsrGraph> CsrSnapshot::get(const Graph &g){
+    unique_lock<mutex> lk(m);
+    idle.wait(lk, [this]{ return holds == 0; });
+    if(!frozen || epoch != g.epoch){
+        frozen = make_shared<const CsrGraph>(buildCsr(g));
+        epoch = g.epoch;
+        buildCount++;
+    }
+    return frozen;
+}
+
+bool CsrSnapshot::current(const Graph &g){
+    lock_guard<mutex> lk(m);
+    return holds == 0 && frozen && epoch == g.epoch;
+}
+
+void CsrSnapshot::hold(){
+    lock_guard<mutex> lk(m);
+    holds++;
+}
+
+void CsrSnapshot::release(){
+    {
+        lock_guard<mutex> lk(m);
+        holds--;
+    }
+    idle.notify_all();
+}
+
+/* --- Only the holder touches the cache while held (edits and get()
+   wait), so the copy itself runs unlocked --- */
+shared_ptr<const CsrGraph> CsrSnapshot::freeze(const Graph &g){
+    {
+        lock_guard<mutex> lk(m);
+        if(frozen && epoch == g.epoch) return frozen;
+    }
+    shared_ptr<const CsrGraph> c = make_shared<const CsrGraph>(buildCsr(g));
+    lock_guard<mutex> lk(m);
+    frozen = c;
+    epoch = g.epoch;
+    buildCount++;
+    return c;
+}
+
+/* --- Layout steps and undone moves reset without an edit (so without
+   beforeChange) while the worker may be freezing; only a renumbering
+   or replacement, which did wait, drops the copy --- */
+void CsrSnapshot::graphReset(const Graph &g){
+    lock_guard<mutex> lk(m);
+    if(g.epoch != epoch) frozen.reset();
+}
+
+void CsrSnapshot::beforeChange(const Graph &){
+    unique_lock<mutex> lk(m);
+    idle.wait(lk, [this]{ return holds == 0; });
+}
+
+/* --- Recorder output (trace.h) that ships full chunks to the UI and
+   reports cancellation at every step boundary --- */
+class AlgorithmWorker::ChunkSink {
+public:
+    ChunkSink(AlgorithmWorker &w, uint64_t job): w(w), job(job), stopped(false) {}
+
+    void clear(int) {}
+    void add(TraceKind k, int node, int parent, uint32_t step){
+        w.partial->events.push_back(TraceEvent::make(k, node, parent, step));
+    }
+    bool endStep(uint32_t done){
+        if(w.cancelled.load(memory_order_relaxed)) stopped = true;
+        else if(w.partial->events.size() >= CHUNK_EVENTS) ship(done, false);
+        return !stopped;
+    }
+    void finish(uint32_t done){ if(!stopped) ship(done, true); }
+
+private:
+    AlgorithmWorker &w;
+    uint64_t job;
+    bool stopped;
+
+    void ship(uint32_t done, bool last){
+        AlgoChunk *c = w.partial;
+        c->steps = done; c->last = last;
+        if(!w.deliver(c)){ stopped = true; return; }
+        w.partial = w.freshChunk(job);
+    }
+};
+
+AlgorithmWorker::AlgorithmWorker(const function<void()> &notify):
+    hasJob(false), running(false), stopping(false), cancelled(false), notify(notify),
+    results(256), spare(256), partial(0), lastId(0), current(0), currentDone(true)
+{
+    pending.snap = 0; pending.source = 0;
+    thread = std::thread(&AlgorithmWorker::run, this);
+}
+
+AlgorithmWorker::~AlgorithmWorker(){
+    {
+        lock_guard<mutex> lk(m);
+        stopping = true;
+        cancelled = true;
+        dropPending();
+    }
+    wake.notify_one();
+    thread.join();
+    AlgoChunk *c;
+    while(results.pop(c)) delete c;
+    while(spare.pop(c)) delete c;
+    delete partial;
+}
+
+uint64_t AlgorithmWorker::start(AlgoKind kind, int s, const shared_ptr<const CsrGraph> &g){
+    Job job = Job();
+    job.kind = kind; job.start = s; job.graph = g; job.snap = 0; job.source = 0;
+    return queue(job);
+}
+
+uint64_t AlgorithmWorker::start(AlgoKind kind, int s, CsrSnapshot &snap, const Graph &g){
+    Job job = Job();
+    job.kind = kind; job.start = s;
+    return queueOn(job, snap, g);
+}
+
+uint64_t AlgorithmWorker::startEccentricity(const vector<int32_t> &sources, CsrSnapshot &snap, const Graph &g){
+    Job job = Job();
+    job.kind = ALGO_ECCENTRICITY; job.start = -1; job.sources = sources;
+    return queueOn(job, snap, g);
+}
+
+/* --- The current snapshot, or the worker freezes one first --- */
+uint64_t AlgorithmWorker::queueOn(Job &job, CsrSnapshot &snap, const Graph &g){
+    if(snap.current(g)){
+        job.graph = snap.get(g);
+        return queue(job);
+    }
+    job.snap = &snap; job.source = &g;
+    snap.hold();                        // released by whoever runs or drops the job
+    return queue(job);
+}
+
+uint64_t AlgorithmWorker::queue(const Job &job){
+    {
+        lock_guard<mutex> lk(m);
+        cancelled = true;                   // the running job, if any, stops at its next check
+        dropPending();
+        pending = job;
+        pending.id = ++lastId;
+        hasJob = true;
+    }
+    wake.notify_one();
+    current = lastId;
+    currentDone = false;
+    return current;
+}
+
+/* --- Under m: forget a job the thread has not taken yet --- */
+void AlgorithmWorker::dropPending(){
+    if(hasJob && pending.source) pending.snap->release();
+    hasJob = false;
+    pending.graph.reset();
+    pending.snap = 0; pending.source = 0;
+    pending.sources.clear();
+}
+
+void AlgorithmWorker::cancel(){
+    lock_guard<mutex> lk(m);
+    cancelled = true;
+    dropPending();
+    current = 0;
+    currentDone = true;
+}
+
+bool AlgorithmWorker::busy(){
+    lock_guard<mutex> lk(m);
+    return hasJob || running;
+}
+
+shared_ptr<const AlgoResult> AlgorithmWorker::result(){
+    lock_guard<mutex> lk(m);
+    if(!currentDone || !kept || kept->job != current) return shared_ptr<const AlgoResult>();
+    return kept;
+}
+
+bool AlgorithmWorker::collect(Trace &tr){
+    bool added = false;
+    AlgoChunk *c;
+    while(results.pop(c)){
+        if(c->job == current && !currentDone){
+            tr.events.insert(tr.events.end(), c->events.begin(), c->events.end());
+            tr.steps = c->steps;
+            currentDone = c->last;
+            added = true;
+        }
+        c->events.clear();
+        if(!spare.push(c)) delete c;
+    }
+    return added;
+}
+
+/* --- Worker side --- */
+AlgoChunk *AlgorithmWorker::freshChunk(uint64_t job){
+    AlgoChunk *c;
+    if(!spare.pop(c)){
+        c = new AlgoChunk;
+        c->events.reserve(CHUNK_EVENTS * 2);
+    }
+    c->job = job; c->steps = 0; c->last = false;
+    return c;
+}
+
+/* --- Queue a chunk; while the UI lags behind and the ring is full, wait
+   (checking for cancellation).  False when the job was cancelled. --- */
+bool AlgorithmWorker::deliver(AlgoChunk *c){
+    while(!results.push(c)){
+        if(cancelled.load(memory_order_relaxed)) return false;
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    if(notify) notify();
+    return true;
+}
+
+void AlgorithmWorker::execute(Job &job){
+    if(job.source){
+        if(!cancelled.load(memory_order_relaxed)) job.graph = job.snap->freeze(*job.source);
+        job.snap->release();
+        if(!job.graph) return;
+    }
+    if(partial){ partial->events.clear(); partial->job = job.id; }
+    else partial = freshChunk(job.id);
+    CsrView g = job.graph->view();
+    ChunkSink sink(*this, job.id);
+    switch(job.kind){
+        case ALGO_BFS: recordBfsTrace(g, job.start, sink); break;
+        case ALGO_DFS: recordDfsTrace(g, job.start, sink); break;
+        case ALGO_SSSP: case ALGO_PATH: {
+            shared_ptr<AlgoResult> r = make_shared<AlgoResult>();
+            r->job = job.id; r->kind = job.kind; r->start = job.start; r->graph = job.graph;
+            dijkstra(g, job.start, r->sssp, &cancelled);
+            if(cancelled.load(memory_order_relaxed)) break;
+            keep(r);                                    // before the last chunk goes out
+            if(job.kind == ALGO_SSSP) recordSsspTrace(g, r->sssp, sink);
+            else sink.finish(0);
+            break;
+        }
+        case ALGO_ECCENTRICITY: {
+            shared_ptr<AlgoResult> r = make_shared<AlgoResult>();
+            r->job = job.id; r->kind = job.kind; r->start = job.start; r->graph = job.graph;
+            MultiBfsOptions opt;
+            opt.cancel = &cancelled;
+            if(!pool) pool.reset(new ThreadPool());
+            multiSourceBfs(g, job.sources, r->eccentricity, opt, *pool);
+            if(cancelled.load(memory_order_relaxed)) break;
+            keep(r);
+            sink.finish(0);
+            break;
+        }
+    }
+    partial->events.clear();
+}
+
+void AlgorithmWorker::keep(const shared_ptr<const AlgoResult> &r){
+    lock_guard<mutex> lk(m);
+    kept = r;
+}
+
+void AlgorithmWorker::run(){
+    for(;;){
+        Job job = Job();
+        {
+            unique_lock<mutex> lk(m);
+            running = false;
+            wake.wait(lk, [this]{ return stopping || hasJob; });
+            if(stopping) return;
+            job = pending;
+            pending.graph.reset();
+            pending.snap = 0; pending.source = 0;
+            pending.sources.clear();
+            hasJob = false;
+            running = true;
+            cancelled = false;
+        }
+        execute(job);
+    }
+}
@@ -0,0 +1,176 @@
+/* algo_worker.h - traversals off the UI thread.  The editor hands a
+   BFS / DFS / Dijkstra run to one background thread and keeps handling
+   input; the trace events come back in chunks through a lock-free
+   single-producer / single-consumer ring (parallel.h), and the player
+   replays them while the rest is still being recorded.
+
+   Runs read a CsrSnapshot: a frozen CSR shared by pointer.  An edit does
+   not touch a snapshot that is handed out; it drops the cached one, and
+   the next request freezes a fresh copy (copy-on-write at graph
+   granularity), so the user can keep editing while an old run finishes
+   against the graph it started on.  That freeze is O(V + E), so a run
+   started after an edit does it on the worker thread: the snapshot holds
+   the Graph until it is copied, and an edit made meanwhile waits (through
+   GraphObserver::beforeChange) rather than the click that started the run.
+
+   Starting a job abandons the one in progress, and cancel() stops it:
+   the recorders check the flag after every visited vertex and Dijkstra
+   every 256 settled ones, so a run stops within a millisecond or so even
+   on graphs with millions of edges.  Chunks carry the id of their job,
+   and collect() drops any that belong to an abandoned one.
+
+   Dijkstra's distances and tree are kept with the job that computed them
+   (result()), so the path to a target clicked after a Shortest-mode run
+   is read off without searching again; ALGO_PATH runs the search alone
+   for a target clicked after an edit.  ALGO_ECCENTRICITY runs the
+   bit-parallel multi-source BFS (multi_bfs.h) behind the diameter key,
+   cancellable like the rest, on a pool of the worker's own so a layout
+   step on the UI thread never queues behind it on defaultPool(). */
+#ifndef ALGO_WORKER_H
+#define ALGO_WORKER_H
+
+#include "graph_core.h"
+#include "multi_bfs.h"
+#include "parallel.h"
+#include "shortest_path.h"
+#include "trace.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* --- The graph as of the last request, frozen once and shared ---
+   Positions are not part of a CSR, so moves keep the snapshot, and so
+   does a reset that only swapped positions (the epoch is unchanged). */
+class CsrSnapshot : public GraphObserver {
+public:
+    /* UI thread: the snapshot, frozen here if an edit dropped it (after
+       waiting for a freeze the worker is doing); current: get() would
+       not have to freeze */
+    std::shared_ptr<const CsrGraph> get(const Graph &g);
+    bool current(const Graph &g);
+    int64_t builds() const { return buildCount; }
+
+    /* hold (UI thread) lets another thread read g until release(); edits
+       wait for that.  freeze is that thread's get(), while held. */
+    void hold();
+    void release();
+    std::shared_ptr<const CsrGraph> freeze(const Graph &g);
+
+    void nodeInserted(const Graph &,int){ frozen.reset(); }
+    void nodeRemoved(const Graph &,int){ frozen.reset(); }
+    void nodeMoved(const Graph &,int){}
+    void edgeAdded(const Graph &,int,int){ frozen.reset(); }
+    void edgeRemoved(const Graph &,int,int){ frozen.reset(); }
+    void edgeWeightChanged(const Graph &,int,int){ frozen.reset(); }
+    void graphReset(const Graph &g);
+    void beforeChange(const Graph &);
+
+    CsrSnapshot(): epoch(0), buildCount(0), holds(0) {}
+
+private:
+    std::shared_ptr<const CsrGraph> frozen;
+    unsigned epoch;
+    std::atomic<int64_t> buildCount;
+    std::mutex m;
+    std::condition_variable idle;
+    int holds;                          // jobs that may still read the Graph
+};
+
+/* ALGO_PATH: Dijkstra with no trace, for its result alone;
+   ALGO_ECCENTRICITY: multi-source BFS from startEccentricity's sources */
+enum AlgoKind { ALGO_BFS, ALGO_DFS, ALGO_SSSP, ALGO_PATH, ALGO_ECCENTRICITY };
+
+/* --- A run of trace events, passed worker -> UI and back for reuse --- */
+struct AlgoChunk {
+    uint64_t job;
+    std::vector<TraceEvent> events;
+    uint32_t steps;             // steps complete once these events are applied
+    bool last;                  // the traversal finished with this chunk
+};
+
+/* --- What a finished job computed besides its trace --- */
+struct AlgoResult {
+    uint64_t job;
+    AlgoKind kind;
+    int start;
+    std::shared_ptr<const CsrGraph> graph;      // the snapshot it ran on
+    SsspResult sssp;                            // ALGO_SSSP, ALGO_PATH
+    MultiBfsResult eccentricity;                // ALGO_ECCENTRICITY
+};
+
+class AlgorithmWorker {
+public:
+    /* notify runs on the worker thread after each chunk is queued (the
+       editor uses it to wake its main loop) */
+    explicit AlgorithmWorker(const std::function<void()> &notify = std::function<void()>());
+    ~AlgorithmWorker();
+
+    /* UI thread.  start: abandon any current job and run kind from
+       `start` on g; returns the job id.  cancel: abandon it without a
+       replacement. */
+    uint64_t start(AlgoKind kind, int start, const std::shared_ptr<const CsrGraph> &g);
+    void cancel();
+
+    /* start on g as it is now: through its current snapshot as above, or,
+       after an edit, with the worker freezing a new one (the call returns
+       at once; edits wait until the copy is made) */
+    uint64_t start(AlgoKind kind, int start, CsrSnapshot &snap, const Graph &g);
+    uint64_t startEccentricity(const std::vector<int32_t> &sources, CsrSnapshot &snap, const Graph &g);
+
+    /* UI thread: append the events of the current job that have arrived
+       to tr (cleared by the caller when the job started) and set
+       tr.steps; true if anything was added */
+    bool collect(Trace &tr);
+    bool finished() const { return currentDone; }       // the current job's last chunk arrived
+    std::shared_ptr<const AlgoResult> result();         // the current job's, once finished(); else null
+    bool busy();                                        // the thread is running or about to run a job
+    uint64_t currentJob() const { return current; }
+
+    static const size_t CHUNK_EVENTS = 4096;
+
+private:
+    struct Job {
+        AlgoKind kind;
+        int start;
+        uint64_t id;
+        std::shared_ptr<const CsrGraph> graph;
+        CsrSnapshot *snap;              // with source: freeze graph from it first
+        const Graph *source;
+        std::vector<int32_t> sources;   // ALGO_ECCENTRICITY
+    };
+    class ChunkSink;
+
+    std::thread thread;
+    std::mutex m;
+    std::condition_variable wake;
+    Job pending;
+    bool hasJob, running, stopping;
+    std::atomic<bool> cancelled;        // polled by the running job
+    std::function<void()> notify;
+
+    SpscQueue<AlgoChunk*> results;      // worker -> UI
+    SpscQueue<AlgoChunk*> spare;        // UI -> worker, emptied chunks for reuse
+    AlgoChunk *partial;                 // worker's chunk being filled
+    std::shared_ptr<const AlgoResult> kept;     // under m: the last job's result
+    std::unique_ptr<ThreadPool> pool;   // worker's, made by the first ALGO_ECCENTRICITY
+
+    uint64_t lastId, current;           // UI side
+    bool currentDone;
+
+    uint64_t queue(const Job &job);
+    uint64_t queueOn(Job &job, CsrSnapshot &snap, const Graph &g);
+    void dropPending();
+    void run();
+    void execute(Job &job);
+    void keep(const std::shared_ptr<const AlgoResult> &r);
+    AlgoChunk *freshChunk(uint64_t job);
+    bool deliver(AlgoChunk *c);
+};
+
+#endif
@@ -0,0 +1,94 @@
+/* bench_bfs.cpp - sequential queue BFS vs parallelBfs (top-down only and
+   direction-optimizing) on R-MAT graphs, across thread counts.
+   Every parallel run is checked to give the same depth array.
+   usage: bench_bfs [scale=18] [edgefactor=16] [roots=4] */
+#include "bfs_parallel.h"
+#include "generators.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* --- edges scanned by a BFS from a root: sum of degrees reached --- */
+static int64_t edgesReached(const CsrView &g, const BfsResult &r){
+    int64_t e = 0;
+    for(int v=0; v<g.n; v++) if(r.depth[v]>=0) e += g.degree(v);
+    return e;
+}
+
+static void runSuite(const char *name, const CsrView &g, const CsrView *incoming, int roots){
+    printf("\n%s: n=%d m=%lld\n", name, g.n, (long long)g.m);
+    printf("%-22s %8s %10s %10s %8s %s\n", "variant", "threads", "ms/root", "MTEPS", "speedup", "levels (td/bu)");
+
+    SplitMix64 rng(99);
+    vector<int> rootList;
+    while((int)rootList.size() < roots){
+        int r = (int)rng.below(g.n);
+        if(g.degree(r) > 0) rootList.push_back(r);
+    }
+
+    vector<BfsResult> ref(roots);
+    double seq = 0; int64_t edges = 0;
+    for(int i=0;i<roots;i++){
+        double t0 = nowSec();
+        sequentialBfs(g, rootList[i], ref[i]);
+        seq += nowSec() - t0;
+        edges += edgesReached(g, ref[i]);
+    }
+    printf("%-22s %8d %10.2f %10.1f %8.2f %d\n", "sequential queue", 1, seq*1e3/roots, edges/seq/1e6, 1.0, ref[0].levels);
+
+    int hw = (int)thread::hardware_concurrency();
+    if(hw < 1) hw = 1;
+    vector<int> counts;
+    for(int t=1; t<hw; t*=2) counts.push_back(t);
+    counts.push_back(hw);
+
+    for(int variant=0; variant<2; variant++){
+        BfsOptions opt;
+        opt.incoming = incoming;
+        opt.directionOptimizing = variant==1;
+        for(size_t c=0; c<counts.size(); c++){
+            ThreadPool pool(counts[c]);
+            double t = 0; bool ok = true; BfsResult r;
+            for(int i=0;i<roots;i++){
+                double t0 = nowSec();
+                parallelBfs(g, rootList[i], r, opt, pool);
+                t += nowSec() - t0;
+                if(r.depth != ref[i].depth) ok = false;
+            }
+            printf("%-22s %8d %10.2f %10.1f %8.2f %d (%d/%d)%s\n",
+                   variant ? "direction-optimizing" : "parallel top-down", counts[c],
+                   t*1e3/roots, edges/t/1e6, seq/t, r.levels, r.topDownLevels, r.bottomUpLevels,
+                   ok ? "" : "  DEPTH MISMATCH");
+        }
+    }
+}
+
+int main(int argc,char **argv){
+    int scale = argc>1 ? atoi(argv[1]) : 18;
+    int ef = argc>2 ? atoi(argv[2]) : 16;
+    int roots = argc>3 ? atoi(argv[3]) : 4;
+
+    EdgeList el;
+    double t0 = nowSec();
+    generateRmat(scale, ef, 1, el);
+    printf("generated R-MAT scale %d, %lld edges in %.2fs\n", scale, (long long)el.size(), nowSec()-t0);
+
+    CsrGraph und = edgeListToCsr(el, false, false);
+    runSuite("undirected R-MAT", und.view(), 0, roots);
+    und = CsrGraph();
+
+    CsrGraph dir = edgeListToCsr(el, true, false);
+    CsrGraph rev = transposeCsr(dir.view());
+    CsrView rv = rev.view();
+    runSuite("directed R-MAT", dir.view(), &rv, roots);
+    return 0;
+}
@@ -0,0 +1,137 @@
+/* bench_components.cpp - the connectivity engine on R-MAT graphs:
+     undirected  edges inserted one by one into a Graph with Connectivity
+                 attached (one union each) against the bare Graph, then
+                 connected(u,v) queries against answering each one with a
+                 BFS, and the full recompute a deletion triggers
+     directed    iterative Tarjan over the CSR and over the Graph's rows,
+                 with the SCC count and the largest SCC
+     chain       one directed cycle through every vertex: the DFS is as
+                 deep as the graph, which recursion could not survive
+   usage: bench_components [scale=20] [edgefactor=8] [chain=10000000] */
+#include "components.h"
+#include "generators.h"
+#include "traversal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void buildGraph(const EdgeList &el, bool directed, Graph &g, Connectivity *c, double *secs, int64_t *added){
+    g.directed = directed;
+    for(int i=0;i<el.n;i++) g.addNode(0,0);
+    if(c){ c->rebuild(g); g.addObserver(c); }
+    double t0 = nowSec();
+    int64_t m = 0;
+    for(int64_t i=0;i<el.size();i++){
+        if(g.hasEdge(el.src[i], el.dst[i])) continue;       // the editor rejects parallel edges
+        g.addEdge(el.src[i], el.dst[i], 1);
+        m++;
+    }
+    *secs = nowSec() - t0;
+    *added = m;
+}
+
+static void runUndirected(const EdgeList &el){
+    printf("\nundirected, n=%d\n", el.n);
+    Graph bare, g;
+    Connectivity c;
+    double tBare, tConn;
+    int64_t m;
+    buildGraph(el, false, bare, 0, &tBare, &m);
+    buildGraph(el, false, g, &c, &tConn, &m);
+    printf("  %-34s %10.1f ns/edge  (bare Graph %.1f, union-find +%.1f)\n", "insert edges with Connectivity",
+           tConn/m*1e9, tBare/m*1e9, (tConn - tBare)/m*1e9);
+    printf("  %-34s %10d  (m=%lld)\n", "components", c.componentCount(), (long long)m);
+
+    SplitMix64 rng(7);
+    int queries = 1000000, yes = 0;
+    vector<int> qs(2*queries);
+    for(int i=0;i<2*queries;i++) qs[i] = (int)(rng.next() % el.n);
+    double t0 = nowSec();
+    for(int i=0;i<queries;i++) yes += c.connected(qs[2*i], qs[2*i+1]);
+    double tq = nowSec() - t0;
+    printf("  %-34s %10.1f ns/query  (%d of %d connected)\n", "connected(u,v), union-find", tq/queries*1e9, yes, queries);
+
+    /* what the editor offered before: a BFS from one endpoint per question */
+    int bfsQueries = 20, bfsYes = 0;
+    vector<int> order;
+    t0 = nowSec();
+    for(int i=0;i<bfsQueries;i++){
+        bfsOrder(g, qs[2*i], order);
+        bfsYes += find(order.begin(), order.end(), qs[2*i+1]) != order.end();
+    }
+    double tb = (nowSec() - t0) / bfsQueries;
+    printf("  %-34s %10.1f us/query  (%.0fx slower)\n", "connected(u,v), BFS", tb*1e6, tb/(tq/queries));
+
+    /* a deletion marks it stale; the next query pays one linear pass */
+    int u = 0;
+    while(g.degree(u) == 0) u++;
+    t0 = nowSec();
+    g.deleteEdge(u, 0);
+    c.componentCount();
+    printf("  %-34s %10.1f ms\n", "delete edge + recompute", (nowSec() - t0)*1e3);
+}
+
+static void sccReport(const char *name, int n, double secs, const vector<int> &comp, int count){
+    vector<int> size(count, 0);
+    for(int v=0;v<n;v++) size[comp[v]]++;
+    int largest = count ? *max_element(size.begin(), size.end()) : 0;
+    printf("  %-34s %10.1f ms  (%.1f M vertices/s, %d SCCs, largest %d)\n", name, secs*1e3, n/secs/1e6, count, largest);
+}
+
+static void runDirected(const EdgeList &el){
+    printf("\ndirected, n=%d m=%lld\n", el.n, (long long)el.size());
+    CsrGraph csr = buildCsrFromEdges(el.n, el.src, el.dst, el.w, false, true);
+    vector<int> comp;
+    double t0 = nowSec();
+    int count = stronglyConnectedComponents(csr.view(), comp);
+    sccReport("Tarjan on CSR", el.n, nowSec() - t0, comp, count);
+
+    Graph g;
+    double tb; int64_t m;
+    buildGraph(el, true, g, 0, &tb, &m);
+    t0 = nowSec();
+    count = stronglyConnectedComponents(g, comp);
+    sccReport("Tarjan on Graph rows", el.n, nowSec() - t0, comp, count);
+
+    Connectivity c;
+    c.rebuild(g);
+    g.addObserver(&c);
+    t0 = nowSec();
+    g.addEdge(0, el.n - 1, 1);
+    c.componentCount();
+    printf("  %-34s %10.1f ms\n", "add edge + recompute", (nowSec() - t0)*1e3);
+}
+
+static void runChain(int n){
+    vector<int32_t> src(n), dst(n), w;
+    for(int i=0;i<n;i++){ src[i] = i; dst[i] = (i + 1) % n; }
+    CsrGraph csr = buildCsrFromEdges(n, src, dst, w, false, true);
+    vector<int> comp;
+    double t0 = nowSec();
+    int count = stronglyConnectedComponents(csr.view(), comp);
+    printf("\nchain of %d vertices (DFS depth %d)\n", n, n);
+    sccReport("Tarjan on CSR", n, nowSec() - t0, comp, count);
+}
+
+int main(int argc,char **argv){
+    int scale = argc > 1 ? atoi(argv[1]) : 20;
+    int ef = argc > 2 ? atoi(argv[2]) : 8;
+    int chain = argc > 3 ? atoi(argv[3]) : 10000000;
+
+    EdgeList el;
+    generateRmat(scale, ef, 1, el);
+    printf("R-MAT scale %d, edge factor %d", scale, ef);
+    runUndirected(el);
+    runDirected(el);
+    runChain(chain);
+    return 0;
+}
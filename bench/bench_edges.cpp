@@ -0,0 +1,121 @@
+/* bench_edges.cpp - the hashed (u,v) edge index on million-edge graphs:
+   memory next to the adjacency rows it indexes, has-edge / weight lookups
+   against a scan of adj[u] (what the editor used to do), weight updates
+   and symmetric deletes.  The editor rejects parallel edges, so R-MAT's
+   duplicates (and, undirected, reversed duplicates) are dropped first.
+   usage: bench_edges [scale=18] [edgefactor=16] [queries=1000000] */
+#include "generators.h"
+#include "graph_core.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static int scanFind(const Graph &g,int u,int v){
+    const AdjRow &row = g.adj[u];
+    for(int k=0;k<(int)row.size();k++) if(row[k].first==v) return k;
+    return -1;
+}
+
+/* --- keep the first copy of every (u,v) ({u,v} when undirected) --- */
+static EdgeList simpleGraph(const EdgeList &el, bool directed){
+    vector< pair<uint64_t,int64_t> > keys(el.size());
+    for(int64_t i=0;i<el.size();i++){
+        uint32_t a = el.src[i], b = el.dst[i];
+        if(!directed && a > b) swap(a,b);
+        keys[i] = make_pair(((uint64_t)a << 32) | b, i);
+    }
+    sort(keys.begin(), keys.end());
+    EdgeList out;
+    out.n = el.n;
+    for(size_t i=0;i<keys.size();i++){
+        if(i && keys[i].first==keys[i-1].first) continue;
+        int64_t e = keys[i].second;
+        out.src.push_back(el.src[e]); out.dst.push_back(el.dst[e]); out.w.push_back(el.w[e]);
+    }
+    return out;
+}
+
+static void runSuite(const EdgeList &raw, bool directed, int queries){
+    EdgeList el = simpleGraph(raw, directed);
+    Graph g;
+    g.directed = directed; g.weighted = true;
+    double t0 = nowSec();
+    for(int i=0;i<el.n;i++) g.addNode(0,0);
+    for(int64_t i=0;i<el.size();i++) g.addEdge(el.src[i], el.dst[i], el.w[i]);
+    double build = nowSec() - t0;
+
+    size_t entries = 0, adjBytes = g.adj.capacity()*sizeof(AdjRow), radjBytes = (g.radj.capacity() + g.inPos.capacity())*sizeof(g.radj[0]);
+    for(int u=0;u<g.slotCount();u++){
+        entries += g.adj[u].size();
+        adjBytes += g.adj[u].capacity()*sizeof(g.adj[u][0]);
+        radjBytes += (g.radj[u].capacity() + g.inPos[u].capacity())*sizeof(int);
+    }
+    printf("\n%s: n=%d entries=%zu (built in %.2f s)\n", directed ? "directed" : "undirected", g.slotCount(), entries, build);
+    printf("  memory   adjacency %7.1f MB  reverse rows %7.1f MB  index %7.1f MB (%.1f B/entry, load %.2f)\n",
+           adjBytes/1048576.0, radjBytes/1048576.0, g.indexBytes()/1048576.0,
+           (double)g.indexBytes()/entries, (double)g.index.size()/g.index.capacity());
+
+    /* half the queries hit existing edges, half random pairs (mostly misses) */
+    SplitMix64 rng(5);
+    vector<int> qu(queries), qv(queries);
+    for(int i=0;i<queries;i++){
+        if(i&1){ qu[i] = (int)rng.below(el.n); qv[i] = (int)rng.below(el.n); }
+        else { int64_t e = rng.below((uint32_t)el.size()); qu[i] = el.src[e]; qv[i] = el.dst[e]; }
+        if(!directed && (i & 2)) swap(qu[i], qv[i]);
+    }
+    long long hits = 0, hits2 = 0;
+    t0 = nowSec();
+    for(int i=0;i<queries;i++) hits += g.hasEdge(qu[i],qv[i]);
+    double tIdx = nowSec() - t0;
+    int scanQ = queries/10 > 0 ? queries/10 : 1;
+    t0 = nowSec();
+    for(int i=0;i<scanQ;i++) hits2 += scanFind(g,qu[i],qv[i]) >= 0;
+    double tScan = (nowSec() - t0) * queries / scanQ;
+    long long agree = 0;
+    for(int i=0;i<scanQ;i++) agree += (scanFind(g,qu[i],qv[i]) >= 0) == g.hasEdge(qu[i],qv[i]);
+    long long wsum = 0;
+    t0 = nowSec();
+    for(int i=0;i<queries;i++) wsum += g.edgeWeight(qu[i],qv[i],0);
+    double tW = nowSec() - t0;
+    t0 = nowSec();
+    for(int i=0;i<queries;i+=2) g.setEdgeWeight(qu[i],qv[i],(int)(i & 1023) + 1);
+    double tSet = nowSec() - t0;
+    printf("  has-edge index %7.1f ns   scan of adj[u] %9.1f ns   (%lld hits, scan %lld of %d; agree on %lld)\n",
+           tIdx*1e9/queries, tScan*1e9/queries, hits, hits2, scanQ, agree);
+    printf("  weight   index %7.1f ns   set weight %7.1f ns   (checksum %lld)\n", tW*1e9/queries, tSet*1e9/(queries/2), wsum);
+
+    /* symmetric delete of existing edges, one at a time */
+    int dels = queries/10, done = 0;
+    t0 = nowSec();
+    for(int i=0;i<queries && done<dels;i+=2){
+        int k = g.findEdge(qu[i],qv[i]);
+        if(k<0) continue;
+        g.deleteEdge(qu[i],k);
+        done++;
+    }
+    double tDel = nowSec() - t0;
+    printf("  delete   %d edges%s %7.1f ns each\n", done, directed ? "" : " (both copies)", tDel*1e9/(done ? done : 1));
+}
+
+int main(int argc, char **argv){
+    int scale = argc>1 ? atoi(argv[1]) : 18;
+    int ef = argc>2 ? atoi(argv[2]) : 16;
+    int queries = argc>3 ? atoi(argv[3]) : 1000000;
+
+    EdgeList el;
+    generateRmat(scale, ef, 11, el);
+    assignWeights(el, 100, 12);
+    printf("R-MAT scale %d, edge factor %d: %lld edges\n", scale, ef, (long long)el.size());
+    runSuite(el, true, queries);
+    runSuite(el, false, queries);
+    return 0;
+}
@@ -0,0 +1,159 @@
+/* bench_io.cpp - load/save throughput: edge-list and DIMACS text through
+   the streaming importer (and a naive iostream reader for reference)
+   versus saving and memory-mapping the binary .gvg format.
+   Every reload is checked against the generated graph, and a few small
+   hand-written files check what the importer must accept or refuse.
+   usage: bench_io [scale=18] [edgefactor=16] [dir=.] */
+#include "generators.h"
+#include "graph_io.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* --- same edges per row, order ignored --- */
+static bool sameGraph(const CsrView &a, const CsrView &b){
+    if(a.n != b.n || a.m != b.m) return false;
+    vector< pair<int,int> > ra, rb;
+    for(int u=0; u<a.n; u++){
+        if(a.degree(u) != b.degree(u)) return false;
+        ra.clear(); rb.clear();
+        for(int i=0;i<a.degree(u);i++) ra.push_back(make_pair(a.target(u,i), a.weight(u,i)));
+        for(int i=0;i<b.degree(u);i++) rb.push_back(make_pair(b.target(u,i), b.weight(u,i)));
+        sort(ra.begin(), ra.end()); sort(rb.begin(), rb.end());
+        if(ra != rb) return false;
+    }
+    return true;
+}
+
+/* --- reference: what a straightforward reader does (ifstream >> per token) --- */
+static double naiveEdgeList(const char *path, int64_t &edges){
+    double t0 = nowSec();
+    ifstream in(path);
+    string line;
+    edges = 0;
+    vector<int32_t> src, dst, w;
+    while(getline(in, line)){
+        if(line.empty() || line[0]=='#') continue;
+        int u, v, x = 1;
+        sscanf(line.c_str(), "%d %d %d", &u, &v, &x);
+        src.push_back(u); dst.push_back(v); w.push_back(x);
+        edges++;
+    }
+    return nowSec() - t0;
+}
+
+/* --- Small text files with a known outcome: the vertex count they load
+   with, or -1 for a file that must be refused --- */
+struct TextCase { const char *name, *text; bool directed, weighted; int n; };
+
+static const TextCase TEXT_CASES[] = {
+    { "directed target-only ids", "0 5\n1 2\n", true, false, 6 },
+    { "declared trailing vertices", "# n=9\n0 1\n", false, false, 9 },
+    { "id overflowing 64 bits", "0 99999999999999999999\n", true, false, -1 },
+    { "id past the vertex cap", "0 100000000\n", true, false, -1 },
+    { "negative weight", "0 1 -4\n", true, true, -1 },
+    { "weight past the range", "0 1 5000000000\n", true, true, -1 },
+    { "zero weight", "0 1 0\n", false, true, -1 },
+};
+
+static bool textCases(const string &dir){
+    bool ok = true;
+    string path = dir + "/bench_io_case.txt";
+    printf("\n%-30s %8s %8s\n", "text input", "want n", "got n");
+    for(size_t i=0; i<sizeof(TEXT_CASES)/sizeof(TEXT_CASES[0]); i++){
+        const TextCase &tc = TEXT_CASES[i];
+        FILE *f = fopen(path.c_str(), "wb");
+        if(!f) return false;
+        fputs(tc.text, f);
+        fclose(f);
+        vector<Node> nodes; AdjList adj;
+        bool directed = tc.directed, weighted = tc.weighted;
+        string err;
+        int got = loadGraph(path.c_str(), nodes, adj, directed, weighted, 0, &err) ? (int)nodes.size() : -1;
+        bool good = got == tc.n;
+        for(size_t u=0; good && u<adj.size(); u++)
+            for(size_t k=0; k<adj[u].size(); k++) good = good && adj[u][k].first < got;
+        printf("%-30s %8d %8d  %s%s%s\n", tc.name, tc.n, got, good ? "ok" : "MISMATCH",
+               err.empty() ? "" : "  ", err.c_str());
+        ok = ok && good;
+    }
+    remove(path.c_str());
+    return ok;
+}
+
+static void row(const char *what, const IoStats &st, bool ok){
+    printf("%-26s %10.1f %12.2f %10.1f  %s\n", what, st.seconds*1e3, st.edgesPerSecond()/1e6,
+           st.seconds > 0 ? st.bytes/st.seconds/1e6 : 0.0, ok ? "ok" : "MISMATCH");
+}
+
+int main(int argc, char **argv){
+    int scale = argc>1 ? atoi(argv[1]) : 18;
+    int ef = argc>2 ? atoi(argv[2]) : 16;
+    string dir = argc>3 ? argv[3] : ".";
+    string pEdges = dir + "/bench_io.txt", pDimacs = dir + "/bench_io.gr", pBin = dir + "/bench_io.gvg";
+
+    EdgeList el;
+    generateRmat(scale, ef, 7, el);
+    assignWeights(el, 1000, 8);
+    bool ok = true;
+
+    for(int directed=1; directed>=0; directed--){
+        CsrGraph ref = edgeListToCsr(el, directed!=0, true);
+        CsrView g = ref.view();
+        printf("\nR-MAT scale %d, %s: n=%d m=%lld\n", scale, directed ? "directed" : "undirected", g.n, (long long)g.m);
+        printf("%-26s %10s %12s %10s\n", "operation", "ms", "Medges/s", "MB/s");
+
+        IoStats st; string err;
+        CsrGraph back;
+        bool good;
+
+        good = exportText(pEdges.c_str(), FORMAT_EDGE_LIST, g, &st, &err);
+        row("export edge list", st, good);
+        good = good && importText(pEdges.c_str(), FORMAT_EDGE_LIST, directed!=0, true, back, &st, &err)
+                    && sameGraph(g, back.view());
+        row("import edge list", st, good);
+        ok = ok && good;
+
+        if(directed){
+            int64_t lines = 0;
+            double t = naiveEdgeList(pEdges.c_str(), lines);
+            IoStats ns; ns.edges = lines; ns.seconds = t; ns.bytes = st.bytes;
+            row("  naive getline+sscanf", ns, lines == g.m);
+        }
+
+        good = exportText(pDimacs.c_str(), FORMAT_DIMACS, g, &st, &err);
+        row("export DIMACS", st, good);
+        good = good && importText(pDimacs.c_str(), FORMAT_DIMACS, directed!=0, true, back, &st, &err)
+                    && sameGraph(g, back.view());
+        row("import DIMACS", st, good);
+        ok = ok && good;
+
+        good = saveBinary(pBin.c_str(), g, 0, &st, &err);
+        row("save .gvg", st, good);
+        {
+            MappedGraph mg;
+            good = good && mg.open(pBin.c_str(), &st, &err);
+            row("mmap .gvg", st, good);
+            double t0 = nowSec();
+            good = good && sameGraph(g, mg.view());     // first touch pages the file in
+            IoStats touch; touch.edges = g.m; touch.bytes = st.bytes; touch.seconds = nowSec() - t0;
+            row("  first full scan", touch, good);
+        }
+        ok = ok && good;
+        if(!err.empty()) printf("error: %s\n", err.c_str());
+    }
+    remove(pEdges.c_str()); remove(pDimacs.c_str()); remove(pBin.c_str());
+    ok = textCases(dir) && ok;
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,116 @@
+/* bench_layout.cpp - Barnes-Hut force-directed layout: time per iteration
+   against exact all-pairs repulsion (theta = 0) and across thread counts,
+   then a full run to convergence from random positions.  Quality is the
+   spread of edge lengths (coefficient of variation; a clean grid drawing
+   is near 0) and, for grids, how far apart the layout puts lattice
+   neighbours versus the rest.
+   usage: bench_layout [maxN=100000] */
+#include "force_layout.h"
+#include "generators.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void randomPositions(int n, double k, vector<double> &x, vector<double> &y){
+    SplitMix64 rng(3);
+    double side = k * sqrt((double)n);
+    x.resize(n); y.resize(n);
+    for(int v=0; v<n; v++){ x[v] = rng.uniform() * side; y[v] = rng.uniform() * side; }
+}
+
+/* --- coefficient of variation of edge lengths --- */
+template<class XY>
+static double edgeSpread(const CsrView &g, XY pos){
+    double s = 0, s2 = 0; int64_t c = 0;
+    for(int u=0; u<g.n; u++)
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v = g.targets[i];
+            if(v == u) continue;
+            double ux, uy, vx, vy;
+            pos(u, ux, uy); pos(v, vx, vy);
+            double d = hypot(ux - vx, uy - vy);
+            s += d; s2 += d*d; c++;
+        }
+    if(!c) return 0;
+    double mean = s / c;
+    return sqrt(max(0.0, s2 / c - mean*mean)) / mean;
+}
+
+static double perIteration(const CsrView &g, const vector<double> &x, const vector<double> &y,
+                           double theta, ThreadPool &pool, int iters){
+    LayoutOptions opt;
+    opt.theta = theta;
+    opt.multilevel = false;                 // time full-size iterations only
+    ForceLayout L(opt);
+    L.start(g, x, y);
+    L.step(1, pool);                        // warm-up
+    double t0 = nowSec();
+    L.step(iters, pool);
+    return (nowSec() - t0) / iters;
+}
+
+static void runGraph(const char *name, const CsrView &g, int maxExact){
+    vector<double> x, y;
+    LayoutOptions opt;
+    randomPositions(g.n, opt.k, x, y);
+    printf("\n%s: n=%d m=%lld\n", name, g.n, (long long)g.m);
+
+    if(g.n <= maxExact){
+        ThreadPool one(1);
+        double exact = perIteration(g, x, y, 0.0, one, 3);
+        double bh = perIteration(g, x, y, opt.theta, one, 3);
+        printf("  exact all-pairs %10.2f ms/iter   Barnes-Hut %8.2f ms/iter   (%.1fx)\n", exact*1e3, bh*1e3, exact/bh);
+    }
+
+    int hw = (int)thread::hardware_concurrency();
+    if(hw < 1) hw = 1;
+    double base = 0;
+    for(int t=1; ; t = min(t*2, hw)){
+        ThreadPool pool(t);
+        double it = perIteration(g, x, y, opt.theta, pool, g.n > 50000 ? 3 : 10);
+        if(t == 1) base = it;
+        printf("  Barnes-Hut %3d threads %8.2f ms/iter  speedup %.2f\n", t, it*1e3, base/it);
+        if(t == hw) break;
+    }
+
+    double spread0 = edgeSpread(g, [&](int v, double &px, double &py){ px = x[v]; py = y[v]; });
+    ForceLayout L(opt);
+    L.start(g, x, y);
+    double t0 = nowSec();
+    while(L.step(10)) {}
+    double total = nowSec() - t0;
+    printf("  multilevel (%d levels): converged in %d iterations, %.2f s; edge length CV %.2f -> %.2f\n",
+           L.levelCount(), L.iterations(), total, spread0,
+           edgeSpread(g, [&](int v, double &px, double &py){ px = L.x(v); py = L.y(v); }));
+}
+
+int main(int argc,char **argv){
+    int maxN = argc>1 ? atoi(argv[1]) : 100000;
+    for(int n=1000; n<=maxN; n*=10){
+        int side = (int)(sqrt((double)n) + 0.5);
+        EdgeList el;
+        generateGrid(side, side, el);
+        CsrGraph grid = edgeListToCsr(el, false, false);
+        char name[64];
+        snprintf(name, sizeof name, "grid %dx%d", side, side);
+        runGraph(name, grid.view(), 5000);
+
+        int scale = 1;
+        while((1 << scale) < n) scale++;
+        generateRmat(scale, 4, 5, el);
+        CsrGraph rmat = edgeListToCsr(el, false, false);
+        snprintf(name, sizeof name, "R-MAT scale %d", scale);
+        runGraph(name, rmat.view(), 5000);
+    }
+    return 0;
+}
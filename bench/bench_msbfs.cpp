@@ -0,0 +1,118 @@
+/* bench_msbfs.cpp - eccentricities from many roots: one sequential queue
+   BFS per root against multiSourceBfs at 64..512 sources per traversal,
+   across thread counts, on an undirected R-MAT graph and a grid.  Every
+   run is checked against the per-root BFS (eccentricity and whether the
+   root reaches everything); the distance-matrix run is checked against
+   the depth arrays too.  Finally every vertex of the grid is a source,
+   which gives its exact diameter and radius.
+   usage: bench_msbfs [scale=16] [edgefactor=16] [sources=1024] [side=256] */
+#include "bfs_parallel.h"
+#include "generators.h"
+#include "multi_bfs.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void runSuite(const char *name, const CsrView &g, int count){
+    printf("\n%s: n=%d m=%lld, %d sources\n", name, g.n, (long long)g.m, count);
+    printf("%-26s %8s %10s %10s %8s %s\n", "variant", "threads", "ms", "us/source", "speedup", "diameter");
+
+    SplitMix64 rng(11);
+    vector<int32_t> sources(count);
+    for(int k=0;k<count;k++) sources[k] = (int32_t)rng.below(g.n);
+
+    /* reference: one BFS per source */
+    vector<int32_t> ecc(count);
+    vector<uint8_t> all(count);
+    vector<BfsResult> depths(min(count, 64));
+    BfsResult r;
+    double t0 = nowSec();
+    for(int k=0;k<count;k++){
+        BfsResult &out = k < (int)depths.size() ? depths[k] : r;
+        sequentialBfs(g, sources[k], out);
+        ecc[k] = out.levels - 1;
+        all[k] = out.reached == g.n;
+    }
+    double base = nowSec() - t0;
+    int diameter = 0;
+    for(int k=0;k<count;k++) diameter = max(diameter, ecc[k]);
+    printf("%-26s %8d %10.1f %10.1f %8.2f %d\n", "sequential BFS per source", 1, base*1e3, base/count*1e6, 1.0, diameter);
+
+    int hw = (int)thread::hardware_concurrency();
+    if(hw < 1) hw = 1;
+    vector<int> counts;
+    for(int t=1; t<hw; t*=2) counts.push_back(t);
+    counts.push_back(hw);
+
+    int widths[] = { 64, 128, 256, 512 };
+    for(int wi=0; wi<4; wi++)
+        for(size_t c=0; c<counts.size(); c++){
+            ThreadPool pool(counts[c]);
+            MultiBfsOptions opt;
+            opt.width = widths[wi];
+            MultiBfsResult m;
+            t0 = nowSec();
+            multiSourceBfs(g, sources, m, opt, pool);
+            double t = nowSec() - t0;
+            bool ok = m.eccentricity == ecc && m.reachesAll == all;
+            char label[64];
+            snprintf(label, sizeof label, "multi-source, %d wide", widths[wi]);
+            printf("%-26s %8d %10.1f %10.1f %8.2f %d%s\n", label, counts[c], t*1e3, t/count*1e6, base/t, m.diameter,
+                   ok ? "" : "  MISMATCH");
+        }
+
+    /* the compact distance matrix costs a store per reached (source, vertex) */
+    MultiBfsOptions opt;
+    opt.distances = true;
+    MultiBfsResult m;
+    t0 = nowSec();
+    multiSourceBfs(g, sources, m, opt);
+    double t = nowSec() - t0;
+    bool ok = m.eccentricity == ecc;
+    for(size_t k=0; k<depths.size(); k++)
+        for(int v=0; v<g.n; v++){
+            int d = m.dist[k*g.n + v];
+            if(d != (depths[k].depth[v] < 0 ? MULTI_BFS_UNREACHED : depths[k].depth[v])) ok = false;
+        }
+    printf("%-26s %8d %10.1f %10.1f %8.2f %d  (%.1f MB matrix)%s\n", "multi-source + distances", defaultPool().size(),
+           t*1e3, t/count*1e6, base/t, m.diameter, m.dist.size()*2/1048576.0, ok ? "" : "  MISMATCH");
+}
+
+int main(int argc,char **argv){
+    int scale = argc>1 ? atoi(argv[1]) : 16;
+    int ef = argc>2 ? atoi(argv[2]) : 16;
+    int count = argc>3 ? atoi(argv[3]) : 1024;
+    int side = argc>4 ? atoi(argv[4]) : 256;
+
+    EdgeList el;
+    generateRmat(scale, ef, 1, el);
+    CsrGraph rmat = edgeListToCsr(el, false, false);
+    char name[64];
+    snprintf(name, sizeof name, "R-MAT scale %d (undirected)", scale);
+    runSuite(name, rmat.view(), count);
+
+    generateGrid(side, side, el);
+    CsrGraph grid = edgeListToCsr(el, false, false);
+    snprintf(name, sizeof name, "grid %dx%d", side, side);
+    runSuite(name, grid.view(), count);
+
+    /* every vertex a source: exact eccentricities, diameter and radius */
+    int small = min(side, 64);
+    generateGrid(small, small, el);
+    CsrGraph sg = edgeListToCsr(el, false, false);
+    MultiBfsResult m;
+    double t0 = nowSec();
+    multiSourceBfs(sg.view(), vector<int32_t>(), m);
+    printf("\nall %d sources of the %dx%d grid: diameter %d (expect %d), radius %d, connected %s, %.1f ms\n",
+           sg.view().n, small, small, m.diameter, 2*(small-1), m.radius, m.connected ? "yes" : "no", (nowSec()-t0)*1e3);
+    return 0;
+}
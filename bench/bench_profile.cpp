@@ -0,0 +1,113 @@
+/* bench_profile.cpp - cost of the instrumentation itself: nanoseconds per
+   PROFILE_SCOPE and PROFILE_COUNT with the profiler off, on, and tracing,
+   over an empty loop, and the whole scene drawn into a null Canvas with the
+   profiler off and on (the counters in drawEdge / drawNode).
+   usage: bench_profile [iterations=20000000] */
+#include "generators.h"
+#include "profile.h"
+#include "scene.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static volatile int64_t sink;
+
+/* a store the compiler cannot drop, standing in for the timed work */
+static inline void work(int64_t i){ sink = i; }
+
+static double timeEmpty(int64_t n){
+    double t0 = nowSec();
+    for(int64_t i=0;i<n;i++) work(i);
+    return (nowSec() - t0) / n * 1e9;
+}
+
+static double timeScopes(int64_t n){
+    double t0 = nowSec();
+    for(int64_t i=0;i<n;i++){
+        PROFILE_SCOPE("bench.scope");
+        work(i);
+    }
+    return (nowSec() - t0) / n * 1e9;
+}
+
+static double timeCounts(int64_t n){
+    double t0 = nowSec();
+    for(int64_t i=0;i<n;i++){
+        PROFILE_COUNT("bench.count", 1);
+        work(i);
+    }
+    return (nowSec() - t0) / n * 1e9;
+}
+
+/* --- Records nothing: what is left is the scene code and its counters --- */
+class NullCanvas : public Canvas {
+public:
+    void setColor(int) {}
+    void setFillColor(int) {}
+    void setTextBackground(int) {}
+    void setLineWidth(int) {}
+    void line(int,int,int,int) {}
+    void bar(int,int,int,int) {}
+    void rect(int,int,int,int) {}
+    void fillEllipse(int,int,int,int) {}
+    void circle(int,int,int) {}
+    void ellipse(int,int,int,int) {}
+    void text(int,int,const char *) {}
+    int textWidth(const char *s) { return 8*(int)strlen(s); }
+    int textHeight(const char *) { return 8; }
+};
+
+static double timeScene(const Graph &g, int frames){
+    NullCanvas c;
+    double t0 = nowSec();
+    for(int f=0;f<frames;f++){ drawScene(c, g); profiler().nextFrame(); }
+    return (nowSec() - t0) / frames * 1e3;
+}
+
+int main(int argc,char **argv){
+    int64_t n = argc > 1 ? atoll(argv[1]) : 20000000;
+    Profiler &p = profiler();
+#if !GV_PROFILE
+    printf("built with GV_PROFILE=0: the macros compile to nothing\n");
+#endif
+
+    printf("%-10s %10s %10s %10s\n", "profiler", "loop ns", "scope ns", "count ns");
+    double base = timeEmpty(n);
+    p.enabled = false;
+    printf("%-10s %10.2f %10.2f %10.2f\n", "off", base, timeScopes(n) - base, timeCounts(n) - base);
+    p.enabled = true;
+    printf("%-10s %10.2f %10.2f %10.2f\n", "on", base, timeScopes(n) - base, timeCounts(n) - base);
+    p.startTrace(1 << 22);
+    double traced = timeScopes(1 << 22) - base;     // stays within the log
+    printf("%-10s %10.2f %10.2f %10s   (%lu events)\n", "tracing", base, traced, "-", (unsigned long)p.traceEvents());
+    p.stopTrace("/dev/null");
+    p.enabled = false;
+
+    /* the scene counters on a 100k-node weighted, directed grid */
+    EdgeList el;
+    generateGrid(316, 316, el);
+    assignWeights(el, 99, 5);
+    Graph g;
+    edgeListToGraph(el, true, true, g, 316);
+    /* alternate off / on and keep the best of each, timings are noisy */
+    double off = 1e30, on = 1e30;
+    for(int round=0; round<5; round++){
+        p.enabled = false;
+        off = min(off, timeScene(g, 10));
+        p.enabled = true;
+        on = min(on, timeScene(g, 10));
+    }
+    p.enabled = false;
+    printf("\nscene (n=%d) into a null canvas: %.2f ms off, %.2f ms on (%+.1f%%)\n",
+           g.nodeCount, off, on, (on - off) / off * 100.0);
+    return 0;
+}
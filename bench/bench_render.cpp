@@ -0,0 +1,165 @@
+/* bench_render.cpp - frames per second of the headless rasterizer on large
+   graphs.  A frame is a white clear plus drawScene (edges with weight
+   labels and arrow heads, nodes, self-loops) recorded into the display
+   list, then flush(); recording and rasterization are timed separately,
+   across thread counts and tile sizes (one thread draws untiled).  Each
+   graph is shown two ways:
+     window   the editor's 60-pixel lattice seen through the frame, so most
+              of the graph is culled while binning
+     fit      the whole graph scaled into the frame (heavy overdraw)
+   Every image is checked against the one-thread render.  Each view also
+   records frames with and without a SceneText (interned labels and
+   weights) and counts heap allocations per frame once warm, which must
+   be zero.
+   usage: bench_render [maxN=100000] [width=1920] [height=1080] [--png=frame.png] */
+#include "generators.h"
+#include "profile.h"
+#include "raster.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static uint64_t imageHash(const SoftCanvas &c){
+    uint64_t h = 1469598103934665603ULL;
+    const uint32_t *p = c.pixels();
+    for(size_t i=0; i<(size_t)c.width()*c.height(); i++) h = (h ^ p[i]) * 1099511628211ULL;
+    return h;
+}
+
+/* --- Scale the lattice into a width x height frame --- */
+static void fitToFrame(Graph &g, int width, int height){
+    int x0 = INT32_MAX, y0 = INT32_MAX, x1 = INT32_MIN, y1 = INT32_MIN;
+    for(int i=0;i<g.slotCount();i++){
+        if(!g.nodes[i].alive) continue;
+        x0 = min(x0, g.nodes[i].x); x1 = max(x1, g.nodes[i].x);
+        y0 = min(y0, g.nodes[i].y); y1 = max(y1, g.nodes[i].y);
+    }
+    int m = 3*NODE_RADIUS;
+    double s = min((double)(width - 2*m) / max(1, x1 - x0), (double)(height - 2*m) / max(1, y1 - y0));
+    for(int i=0;i<g.slotCount();i++){
+        g.nodes[i].x = m + (int)((g.nodes[i].x - x0) * s);
+        g.nodes[i].y = m + (int)((g.nodes[i].y - y0) * s);
+    }
+}
+
+/* --- Average over enough frames to fill ~0.3 s (at least 2) --- */
+struct FrameTime { double record, raster; };
+
+static FrameTime timeFrames(SoftCanvas &c, const Graph &g, ThreadPool &pool, SceneText *text = 0){
+    FrameTime t = { 0, 0 };
+    int frames = 0;
+    double start = nowSec();
+    while(frames < 2 || nowSec() - start < 0.3){
+        double t0 = nowSec();
+        c.clear(PAL_WHITE);
+        drawScene(c, g, text);
+        double t1 = nowSec();
+        c.flush(pool);
+        t.record += t1 - t0;
+        t.raster += nowSec() - t1;
+        frames++;
+    }
+    t.record /= frames; t.raster /= frames;
+    return t;
+}
+
+static void runView(const char *name, const Graph &g, int width, int height, const char *png){
+    /* at least 4 threads, so the tiled path runs even on small machines
+       (where those rows show its overhead rather than a speedup) */
+    int maxThreads = max(4, (int)thread::hardware_concurrency());
+
+    SoftCanvas ref(width, height);
+    ThreadPool one(1);
+    FrameTime base = timeFrames(ref, g, one);
+    uint64_t want = imageHash(ref);
+    printf("\n%s: %dx%d frame\n", name, width, height);
+    printf("  %-8s %7s %12s %10s %10s %8s %8s\n", "tile", "threads", "cmd x tile", "record ms", "raster ms", "fps", "speedup");
+    printf("  %-8s %7d %12lld %10.2f %10.2f %8.1f %8.2f\n", "none", 1, (long long)ref.lastBinned(),
+           base.record*1e3, base.raster*1e3, 1.0/(base.record + base.raster), 1.0);
+
+    /* warm frames: every buffer at its size, every string interned */
+    SceneText text;
+    FrameTime cached = timeFrames(ref, g, one, &text);
+    int64_t a0 = heapAllocations();
+    for(int f=0; f<4; f++){ ref.clear(PAL_WHITE); drawScene(ref, g, &text); ref.flush(one); }
+    double perFrame = (double)(heapAllocations() - a0) / 4;
+    char allocs[48];
+    if(a0 < 0) snprintf(allocs, sizeof allocs, "allocations not counted");
+    else snprintf(allocs, sizeof allocs, "%.1f allocations/frame%s", perFrame, perFrame == 0 ? "" : "  NOT ZERO");
+    printf("  %-8s %7d %12s %10.2f %10s  (%lld strings, %lu arena bytes; %s)\n", "text", 1, "interned",
+           cached.record*1e3, "", (long long)text.misses(), (unsigned long)text.arenaBytes(), allocs);
+    if(png){
+        string err;
+        if(!ref.savePNG(png, &err)) printf("  %s\n", err.c_str());
+    }
+
+    int tiles[] = { 64, 128, 256 };
+    for(int k=0; k<3; k++)
+        for(int t=2; t<=maxThreads; t*=2){
+            ThreadPool pool(t);
+            SoftCanvas c(width, height, tiles[k]);
+            FrameTime ft = timeFrames(c, g, pool);
+            printf("  %-8d %7d %12lld %10.2f %10.2f %8.1f %8.2f%s\n", tiles[k], t, (long long)c.lastBinned(),
+                   ft.record*1e3, ft.raster*1e3, 1.0/(ft.record + ft.raster), base.raster/ft.raster,
+                   imageHash(c) == want ? "" : "  IMAGE MISMATCH");
+        }
+}
+
+static void runGraph(const char *name, const EdgeList &el, int cols, int width, int height, const char **png){
+    Graph g;
+    edgeListToGraph(el, true, true, g, cols);
+    int64_t m = 0;
+    for(int u=0;u<g.slotCount();u++) m += g.degree(u);
+    printf("\n== %s: n=%d m=%lld (directed, weighted)\n", name, g.nodeCount, (long long)m);
+
+    char label[96];
+    snprintf(label, sizeof label, "%s window", name);
+    runView(label, g, width, height, 0);
+    fitToFrame(g, width, height);
+    snprintf(label, sizeof label, "%s fit", name);
+    runView(label, g, width, height, *png);
+    *png = 0;                   // only the first graph's image is written
+}
+
+int main(int argc,char **argv){
+    int maxN = 100000, width = 1920, height = 1080;
+    const char *png = 0;
+    int pos = 0;
+    for(int i=1;i<argc;i++){
+        if(!strncmp(argv[i], "--png=", 6)){ png = argv[i] + 6; continue; }
+        int v = atoi(argv[i]);
+        if(pos == 0) maxN = v; else if(pos == 1) width = v; else if(pos == 2) height = v;
+        pos++;
+    }
+
+    for(int n=1000; n<=maxN; n*=10){
+        EdgeList el;
+        int side = (int)(sqrt((double)n) + 0.5);
+        generateGrid(side, side, el);
+        assignWeights(el, 99, 5);
+        char name[64];
+        snprintf(name, sizeof name, "grid %dx%d", side, side);
+        runGraph(name, el, side, width, height, &png);
+
+        int scale = 1;
+        while((1 << scale) < n) scale++;
+        generateRmat(scale, 4, 5, el);
+        assignWeights(el, 99, 6);
+        snprintf(name, sizeof name, "R-MAT scale %d", scale);
+        runGraph(name, el, 0, width, height, &png);
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+/* bench_reorder.cpp - traversal time before and after renumbering the
+   vertices (reorder.h).  Each graph is run as given, then in RCM, degree
+   and BFS order, with the same roots: queue BFS, DFS and radix-heap
+   Dijkstra times, plus the cache misses of the BFS's memory accesses
+   (offsets, targets and the depth array) in a simulated 8-way, 64-byte-
+   line cache of 32 KB (L1-sized) and 1 MB (L2-sized), since hardware
+   counters are not portable.  Every reordered run is checked to give the
+   same distances as the original, mapped through the permutation.
+     R-MAT   ids scrambled by the generator (hubs anywhere)
+     grid    a lattice with its ids shuffled, as if clicked in at random
+   usage: bench_reorder [scale=18] [edgefactor=8] [side=512] [roots=4] */
+#include "bfs_parallel.h"
+#include "generators.h"
+#include "reorder.h"
+#include "shortest_path.h"
+#include "traversal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* --- Set-associative LRU cache over byte addresses --- */
+class CacheSim {
+public:
+    CacheSim(size_t bytes, int ways): sets((int)(bytes / 64 / ways)), ways(ways), tags((size_t)sets*ways, ~(uint64_t)0),
+                                      age((size_t)sets*ways, 0), clock(0), misses(0) {}
+    void touch(uint64_t addr){
+        uint64_t line = addr >> 6;
+        size_t base = (size_t)(line % sets) * ways;
+        clock++;
+        int victim = 0;
+        for(int w=0;w<ways;w++){
+            if(tags[base+w] == line){ age[base+w] = clock; return; }
+            if(age[base+w] < age[base+victim]) victim = w;
+        }
+        tags[base+victim] = line; age[base+victim] = clock;
+        misses++;
+    }
+    int64_t missCount() const { return misses; }
+
+private:
+    int sets, ways;
+    vector<uint64_t> tags, age;
+    uint64_t clock;
+    int64_t misses;
+};
+
+/* --- The accesses sequentialBfs makes, replayed into two caches --- */
+static void simulateBfs(const CsrView &g, int source, CacheSim &l1, CacheSim &l2){
+    const uint64_t OFFSETS = 0, TARGETS = (uint64_t)1 << 40, DEPTH = (uint64_t)2 << 40, QUEUE = (uint64_t)3 << 40;
+    vector<int32_t> depth(g.n, -1), q;
+    q.reserve(g.n);
+    q.push_back(source); depth[source] = 0;
+    for(size_t head=0; head<q.size(); head++){
+        int u = q[head];
+        uint64_t a[2] = { QUEUE + 4*head, OFFSETS + 8*(uint64_t)u };
+        for(int k=0;k<2;k++){ l1.touch(a[k]); l2.touch(a[k]); }
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v = g.targets[i];
+            uint64_t t = TARGETS + 4*(uint64_t)i, d = DEPTH + 4*(uint64_t)v;
+            l1.touch(t); l2.touch(t); l1.touch(d); l2.touch(d);
+            if(depth[v] < 0){ depth[v] = depth[u] + 1; q.push_back(v); }
+        }
+    }
+}
+
+struct Timing { double order, bfs, dfs, sssp; int64_t l1, l2; bool ok; };
+
+static Timing measure(const CsrView &g, const vector<int> &roots, const vector< vector<int32_t> > &wantDepth,
+                      const vector< vector<int64_t> > &wantDist, const vector<int> *perm){
+    Timing t = { 0, 0, 0, 0, 0, 0, true };
+    BfsResult b; SsspResult s; vector<int> order;
+    for(size_t k=0;k<roots.size();k++){
+        int r = perm ? (*perm)[roots[k]] : roots[k];
+        double t0 = nowSec();
+        sequentialBfs(g, r, b);
+        double t1 = nowSec();
+        dfsOrder(g, r, order);
+        double t2 = nowSec();
+        dijkstra(g, r, s);
+        double t3 = nowSec();
+        t.bfs += t1 - t0; t.dfs += t2 - t1; t.sssp += t3 - t2;
+        for(int v=0; v<g.n && !wantDepth.empty(); v++){
+            int nv = perm ? (*perm)[v] : v;
+            if(b.depth[nv] != wantDepth[k][v] || s.dist[nv] != wantDist[k][v]){ t.ok = false; break; }
+        }
+        CacheSim l1(32 << 10, 8), l2(1 << 20, 8);
+        simulateBfs(g, r, l1, l2);
+        t.l1 += l1.missCount(); t.l2 += l2.missCount();
+    }
+    double k = (double)roots.size();
+    t.bfs /= k; t.dfs /= k; t.sssp /= k; t.l1 = (int64_t)(t.l1 / k); t.l2 = (int64_t)(t.l2 / k);
+    return t;
+}
+
+static void report(const char *name, const CsrView &g, const Timing &t, const Timing &base){
+    OrderProfile p = orderProfile(g);
+    printf("  %-10s %9.1f %11lld %10.0f %8.2f %8.2f %8.2f %10lld %10lld  x%.2f%s\n", name, t.order*1e3,
+           (long long)p.bandwidth, p.meanGap, t.bfs*1e3, t.dfs*1e3, t.sssp*1e3, (long long)t.l1, (long long)t.l2,
+           (base.bfs + base.dfs + base.sssp) / (t.bfs + t.dfs + t.sssp), t.ok ? "" : "  MISMATCH");
+}
+
+static void runGraph(const char *name, const CsrView &g, int rootCount){
+    printf("\n%s: n=%d m=%lld\n", name, g.n, (long long)g.m);
+    printf("  %-10s %9s %11s %10s %8s %8s %8s %10s %10s  %s\n", "order", "order ms", "bandwidth", "mean gap",
+           "BFS ms", "DFS ms", "SSSP ms", "L1 miss", "L2 miss", "speedup");
+
+    SplitMix64 rng(3);
+    vector<int> roots;
+    while((int)roots.size() < rootCount){
+        int r = (int)rng.below(g.n);
+        if(g.degree(r) > 0) roots.push_back(r);
+    }
+    vector< vector<int32_t> > depth(rootCount);
+    vector< vector<int64_t> > dist(rootCount);
+    for(int k=0;k<rootCount;k++){
+        BfsResult b; SsspResult s;
+        sequentialBfs(g, roots[k], b); depth[k] = b.depth;
+        dijkstra(g, roots[k], s); dist[k] = s.dist;
+    }
+
+    Timing base = measure(g, roots, vector< vector<int32_t> >(), vector< vector<int64_t> >(), 0);
+    report("as given", g, base, base);
+
+    VertexOrder kinds[] = { ORDER_RCM, ORDER_DEGREE, ORDER_BFS };
+    for(int i=0;i<3;i++){
+        vector<int> perm;
+        double t0 = nowSec();
+        computeVertexOrder(g, kinds[i], perm);
+        CsrGraph p = permuteCsr(g, perm);
+        double tOrder = nowSec() - t0;
+        Timing t = measure(p.view(), roots, depth, dist, &perm);
+        t.order = tOrder;
+        report(vertexOrderName(kinds[i]), p.view(), t, base);
+    }
+}
+
+int main(int argc,char **argv){
+    int scale = argc>1 ? atoi(argv[1]) : 18;
+    int ef = argc>2 ? atoi(argv[2]) : 8;
+    int side = argc>3 ? atoi(argv[3]) : 512;
+    int roots = argc>4 ? atoi(argv[4]) : 4;
+
+    EdgeList el;
+    generateRmat(scale, ef, 1, el);
+    assignWeights(el, 255, 2);
+    CsrGraph rmat = edgeListToCsr(el, false, true);
+    char name[64];
+    snprintf(name, sizeof name, "R-MAT scale %d", scale);
+    runGraph(name, rmat.view(), roots);
+
+    /* the lattice in random click order */
+    generateGrid(side, side, el);
+    assignWeights(el, 255, 3);
+    CsrGraph grid = edgeListToCsr(el, false, true);
+    vector<int> shuffle(grid.vertexCount());
+    for(int v=0;v<(int)shuffle.size();v++) shuffle[v] = v;
+    SplitMix64 rng(5);
+    for(int v=(int)shuffle.size()-1; v>0; v--) swap(shuffle[v], shuffle[(int)rng.below(v + 1)]);
+    CsrGraph shuffled = permuteCsr(grid.view(), shuffle);
+    snprintf(name, sizeof name, "grid %dx%d, shuffled ids", side, side);
+    runGraph(name, shuffled.view(), roots);
+    return 0;
+}
@@ -0,0 +1,84 @@
+/* bench_spatial.cpp - hit-test cost against graph size: the old linear
+   scans (findNodeAt / findEdgeNear) versus SpatialIndex queries.
+   Node density is held constant (world grows with N), like zooming out
+   over an ever larger drawing. */
+#include "graph_core.h"
+#include "spatial_index.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+static const int R = 22;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* --- reference: the original scans from main.cpp --- */
+static int scanNodeAt(const Graph &g,int mx,int my){
+    for(int i=0;i<g.nodeCount;i++){
+        long long dx=mx-g.nodes[i].x, dy=my-g.nodes[i].y;
+        if(dx*dx+dy*dy<=R*R) return i;
+    }
+    return -1;
+}
+
+static bool scanEdgeNear(const Graph &g,int mx,int my){
+    for(int u=0;u<g.nodeCount;u++)
+        for(int k=0;k<(int)g.adj[u].size();k++){
+            int v=g.adj[u][k].first;
+            if(u==v || (!g.directed && v<u)) continue;
+            if(distPointToSegment(mx,my,g.nodes[u].x,g.nodes[u].y,g.nodes[v].x,g.nodes[v].y)<=8.0) return true;
+        }
+    return false;
+}
+
+int main(int argc,char **argv){
+    int maxN = argc>1 ? atoi(argv[1]) : 1000000;
+    const int Q = 200000;
+    printf("%10s %12s %14s %14s %14s %14s\n","nodes","edges","scan node ns","grid node ns","scan edge ns","grid edge ns");
+    for(int n=1000;n<=maxN;n*=10){
+        srand(12345);
+        int side = (int)(sqrt((double)n)*60.0);
+        Graph g;
+        for(int i=0;i<n;i++) g.addNode(rand()%side, rand()%side);
+        /* short edges: connect each node to a nearby id in a spatially sorted order */
+        int cols = side/60+1;
+        vector< vector<int> > bucket(cols*cols);
+        for(int i=0;i<n;i++) bucket[(g.nodes[i].y/60)*cols + g.nodes[i].x/60].push_back(i);
+        int prev=-1;
+        for(size_t b=0;b<bucket.size();b++)
+            for(size_t j=0;j<bucket[b].size();j++){
+                if(prev>=0) g.addEdge(prev,bucket[b][j],1);
+                prev=bucket[b][j];
+            }
+
+        double t0=nowSec();
+        SpatialIndex idx(R);
+        idx.rebuild(g);
+        double build=nowSec()-t0;
+
+        vector<int> qx(Q), qy(Q);
+        for(int i=0;i<Q;i++){ qx[i]=rand()%side; qy[i]=rand()%side; }
+
+        int scanQ = (int)min((long long)Q, 50000000LL/n + 1);
+        long long chk=0;
+        t0=nowSec(); for(int i=0;i<scanQ;i++) chk+=scanNodeAt(g,qx[i],qy[i]); double sn=(nowSec()-t0)/scanQ;
+        long long chk2=0;
+        for(int i=0;i<scanQ;i++) chk2+=idx.nodeAt(qx[i],qy[i]);
+        if(chk!=chk2) printf("  node hit mismatch!\n");
+        t0=nowSec(); for(int i=0;i<Q;i++) chk+=idx.nodeAt(qx[i],qy[i]); double gn=(nowSec()-t0)/Q;
+        int scanE = max(1, scanQ/4);
+        t0=nowSec(); for(int i=0;i<scanE;i++) chk+=scanEdgeNear(g,qx[i],qy[i]); double se=(nowSec()-t0)/scanE;
+        t0=nowSec(); for(int i=0;i<Q;i++) chk+=idx.edgeNear(qx[i],qy[i],8.0).first; double ge=(nowSec()-t0)/Q;
+
+        printf("%10d %12lld %14.1f %14.1f %14.1f %14.1f   (build %.3fs, %zu cells, chk %lld)\n",
+               n,(long long)(n-1),sn*1e9,gn*1e9,se*1e9,ge*1e9,build,idx.cellCount(),chk&1);
+    }
+    return 0;
+}
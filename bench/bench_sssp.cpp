@@ -0,0 +1,117 @@
+/* bench_sssp.cpp - std::priority_queue Dijkstra vs radix-heap Dijkstra vs
+   delta-stepping on weighted R-MAT graphs, across thread counts and bucket
+   widths.  Every run is checked to give the same distance array.
+   usage: bench_sssp [scale=18] [edgefactor=16] [maxweight=255] [roots=4] */
+#include "shortest_path.h"
+#include "generators.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* --- every reached vertex must hang off a tight edge from its parent --- */
+static bool parentsTight(const CsrView &g, const SsspResult &r){
+    for(int v=0; v<g.n; v++){
+        int p = r.parent[v];
+        if(r.dist[v] == SSSP_INF){ if(p != -1) return false; continue; }
+        if(p == v) continue;
+        if(p < 0) return false;
+        bool ok = false;
+        for(int64_t i=g.offsets[p]; i<g.offsets[p+1] && !ok; i++)
+            if(g.targets[i] == v && r.dist[p] + g.weights[i] == r.dist[v]) ok = true;
+        if(!ok) return false;
+    }
+    return true;
+}
+
+static void runSuite(const char *name, const CsrView &g, int roots){
+    printf("\n%s: n=%d m=%lld\n", name, g.n, (long long)g.m);
+    printf("%-26s %8s %10s %10s %8s %s\n", "variant", "threads", "ms/root", "MTEPS", "speedup", "buckets/phases");
+
+    SplitMix64 rng(7);
+    vector<int> rootList;
+    while((int)rootList.size() < roots){
+        int r = (int)rng.below(g.n);
+        if(g.degree(r) > 0) rootList.push_back(r);
+    }
+
+    vector<SsspResult> ref(roots);
+    double base = 0; int64_t edges = 0;
+    for(int i=0;i<roots;i++){
+        double t0 = nowSec();
+        dijkstraBinaryHeap(g, rootList[i], ref[i]);
+        base += nowSec() - t0;
+        for(int v=0; v<g.n; v++) if(ref[i].dist[v] != SSSP_INF) edges += g.degree(v);
+    }
+    printf("%-26s %8d %10.2f %10.1f %8.2f\n", "priority_queue dijkstra", 1, base*1e3/roots, edges/base/1e6, 1.0);
+
+    {
+        double t = 0; bool ok = true; SsspResult r;
+        for(int i=0;i<roots;i++){
+            double t0 = nowSec();
+            dijkstra(g, rootList[i], r);
+            t += nowSec() - t0;
+            if(r.dist != ref[i].dist || !parentsTight(g, r)) ok = false;
+        }
+        printf("%-26s %8d %10.2f %10.1f %8.2f%s\n", "radix-heap dijkstra", 1, t*1e3/roots, edges/t/1e6, base/t,
+               ok ? "" : "  DIST MISMATCH");
+    }
+
+    int hw = (int)thread::hardware_concurrency();
+    if(hw < 1) hw = 1;
+    vector<int> counts;
+    for(int t=1; t<hw; t*=2) counts.push_back(t);
+    counts.push_back(hw);
+
+    /* 0 = automatic width, then a narrow and a wide fixed width */
+    int64_t deltas[] = { 0, 4, 64 };
+    for(int d=0; d<3; d++){
+        DeltaOptions opt;
+        opt.delta = deltas[d];
+        char label[64];
+        if(deltas[d]) snprintf(label, sizeof label, "delta-stepping d=%lld", (long long)deltas[d]);
+        else snprintf(label, sizeof label, "delta-stepping d=auto");
+        for(size_t c=0; c<counts.size(); c++){
+            ThreadPool pool(counts[c]);
+            double t = 0; bool ok = true; SsspResult r;
+            for(int i=0;i<roots;i++){
+                double t0 = nowSec();
+                deltaStepping(g, rootList[i], r, opt, pool);
+                t += nowSec() - t0;
+                if(r.dist != ref[i].dist || !parentsTight(g, r)) ok = false;
+            }
+            printf("%-26s %8d %10.2f %10.1f %8.2f %d/%d%s\n", label, counts[c],
+                   t*1e3/roots, edges/t/1e6, base/t, r.buckets, r.phases,
+                   ok ? "" : "  DIST MISMATCH");
+        }
+    }
+}
+
+int main(int argc,char **argv){
+    int scale = argc>1 ? atoi(argv[1]) : 18;
+    int ef = argc>2 ? atoi(argv[2]) : 16;
+    int maxW = argc>3 ? atoi(argv[3]) : 255;
+    int roots = argc>4 ? atoi(argv[4]) : 4;
+
+    EdgeList el;
+    double t0 = nowSec();
+    generateRmat(scale, ef, 1, el);
+    assignWeights(el, maxW, 2);
+    printf("generated R-MAT scale %d, %lld edges, weights 1..%d in %.2fs\n", scale, (long long)el.size(), maxW, nowSec()-t0);
+
+    CsrGraph und = edgeListToCsr(el, false, true);
+    runSuite("undirected R-MAT", und.view(), roots);
+    und = CsrGraph();
+
+    CsrGraph dir = edgeListToCsr(el, true, true);
+    runSuite("directed R-MAT", dir.view(), roots);
+    return 0;
+}
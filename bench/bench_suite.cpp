@@ -0,0 +1,270 @@
+/* bench_suite.cpp - times the editor's hot paths on reproducible graphs and
+   writes the results as JSON, one record per (graph, operation), so runs
+   from different releases can be diffed.
+
+   Graphs: Erdos-Renyi (m = 4n), R-MAT (edge factor 4), square 2D grid and
+   star, each directed/undirected and weighted/unweighted, laid out on the
+   editor's 60-pixel lattice.  Operations, as the editor performs them:
+     bfs_trace, dfs_trace      record the traversal and replay it to the end
+     history_add_edge          History::addEdge of a new edge (spatial index attached)
+     history_undo/_redo        undo / redo of those edits
+     delete_node               History::deleteNode + compactIfFragmented
+     undo_delete_node          undo of those deletions
+     find_node_at              SpatialIndex::nodeAt at random points
+     find_edge_near            SpatialIndex::edgeNear at random points
+     draw_all                  full redraw through a stub backend (no pixels)
+
+   usage: bench_suite [--sizes=1000,10000,100000] [--families=er,rmat,grid,star]
+                      [--out=results.json]
+   JSON goes to --out (default stdout); progress goes to stderr. */
+#include "generators.h"
+#include "history.h"
+#include "scene.h"
+#include "spatial_index.h"
+#include "trace.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* --- Stub drawing backend: counts primitives and folds their coordinates
+   into a checksum, so the work of drawAll (geometry, weight strings,
+   arrow heads) is done through the editor's scene code but nothing is
+   rasterized --- */
+class StubCanvas : public Canvas {
+public:
+    long prims;
+    uint64_t sum;
+
+    StubCanvas(): prims(0), sum(0) {}
+    void setColor(int){}
+    void setFillColor(int){}
+    void setTextBackground(int){}
+    void setLineWidth(int){}
+    void line(int x1,int y1,int x2,int y2){ prim(x1,y1,x2,y2); }
+    void bar(int x1,int y1,int x2,int y2){ prim(x1,y1,x2,y2); }
+    void rect(int x1,int y1,int x2,int y2){ prim(x1,y1,x2,y2); }
+    void fillEllipse(int x,int y,int rx,int ry){ prim(x,y,rx,ry); }
+    void circle(int x,int y,int r){ prim(x,y,r,r); }
+    void ellipse(int x,int y,int rx,int ry){ prim(x,y,rx,ry); }
+    void text(int x,int y,const char *s){ prim(x,y,(int)strlen(s),s[0]); }
+    int textWidth(const char *s){ return 8*(int)strlen(s); }     // WinBGIm default font
+    int textHeight(const char *){ return 8; }
+
+private:
+    void prim(int a,int b,int c,int d){ prims++; sum = sum*31 + (uint64_t)(a ^ (b<<8) ^ (c<<16) ^ ((uint64_t)d<<24)); }
+};
+
+/* --- Full redraw as the editor's rebuildLayer + drawOverlay do it --- */
+static void drawAllStub(StubCanvas &c,const Graph &g){
+    c.bar(0,70,1000,650);
+    drawScene(c, g);
+}
+
+/* --- JSON records --- */
+struct Record {
+    string family, op;
+    int n; int64_t m;
+    bool directed, weighted;
+    int64_t iterations;
+    double seconds;
+};
+
+static vector<Record> records;
+static Record current;
+
+static void report(const char *op, int64_t iterations, double seconds){
+    Record r = current;
+    r.op = op; r.iterations = iterations; r.seconds = seconds;
+    records.push_back(r);
+    fprintf(stderr, "  %-18s %10lld x %12.1f ns\n", op, (long long)iterations,
+            iterations ? seconds*1e9/iterations : 0.0);
+}
+
+static void writeJson(FILE *f){
+    fprintf(f, "{\n  \"suite\": \"graph-visualizer\",\n  \"schema\": 1,\n");
+    fprintf(f, "  \"unix_time\": %lld,\n  \"threads\": %u,\n", (long long)time(0), thread::hardware_concurrency());
+    fprintf(f, "  \"results\": [\n");
+    for(size_t i=0;i<records.size();i++){
+        const Record &r = records[i];
+        fprintf(f, "    {\"family\": \"%s\", \"n\": %d, \"m\": %lld, \"directed\": %s, \"weighted\": %s, "
+                   "\"op\": \"%s\", \"iterations\": %lld, \"total_ms\": %.3f, \"ns_per_op\": %.1f}%s\n",
+                r.family.c_str(), r.n, (long long)r.m, r.directed ? "true" : "false", r.weighted ? "true" : "false",
+                r.op.c_str(), (long long)r.iterations, r.seconds*1e3,
+                r.iterations ? r.seconds*1e9/r.iterations : 0.0, i+1<records.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+}
+
+/* --- Graph families --- */
+static bool makeEdges(const string &family, int n, EdgeList &el, int &cols){
+    cols = 0;
+    if(family == "er") generateErdosRenyi(n, (int64_t)4*n, 11, el);
+    else if(family == "rmat"){
+        int scale = 1;
+        while((1 << scale) < n) scale++;
+        generateRmat(scale, 4, 12, el);
+    }
+    else if(family == "grid"){
+        int side = (int)(sqrt((double)n) + 0.5);
+        generateGrid(side, side, el);
+        cols = side;
+    }
+    else if(family == "star") generateStar(n, el);
+    else return false;
+    return true;
+}
+
+/* --- repeats fn until `minSec` has passed (at least once, at most maxIter) --- */
+template<class F>
+static void timed(const char *op, double minSec, int64_t maxIter, F fn){
+    int64_t it = 0;
+    double t0 = nowSec(), t = 0;
+    do { fn(it); it++; t = nowSec() - t0; } while(t < minSec && it < maxIter);
+    report(op, it, t);
+}
+
+static int randomLive(const Graph &g, SplitMix64 &rng){
+    if(g.nodeCount == 0) return -1;
+    while(true){
+        int v = (int)rng.below(g.slotCount());
+        if(g.nodes[v].alive) return v;
+    }
+}
+
+static void runGraph(const string &family, int n, bool directed, bool weighted){
+    EdgeList el;
+    int cols;
+    if(!makeEdges(family, n, el, cols)) return;
+    if(weighted) assignWeights(el, 999, 13);
+
+    Graph g;
+    edgeListToGraph(el, directed, weighted, g, cols);
+    int64_t m = 0;      // edges as drawn: undirected ones once
+    for(int u=0;u<g.slotCount();u++)
+        for(int k=0;k<g.degree(u);k++) if(directed || g.target(u,k) >= u) m++;
+
+    current.family = family; current.n = g.nodeCount; current.m = m;
+    current.directed = directed; current.weighted = weighted;
+    fprintf(stderr, "%s n=%d m=%lld %s %s\n", family.c_str(), g.nodeCount, (long long)m,
+            directed ? "directed" : "undirected", weighted ? "weighted" : "unweighted");
+
+    int side = 0;
+    for(int i=0;i<g.slotCount();i++) side = max(side, max(g.nodes[i].x, g.nodes[i].y));
+    side += 60;
+
+    SpatialIndex spatial(NODE_RADIUS);
+    double t0 = nowSec();
+    spatial.rebuild(g);
+    report("spatial_rebuild", 1, nowSec() - t0);
+    g.addObserver(&spatial);
+
+    SplitMix64 rng(1234);
+    Trace tr;
+    TracePlayer player;
+    vector<int> changed;
+    timed("bfs_trace", 0.2, 50, [&](int64_t){
+        recordBfsTrace(g, randomLive(g, rng), tr);
+        player.load(tr); player.skipToEnd(changed); changed.clear();
+    });
+    timed("dfs_trace", 0.2, 50, [&](int64_t){
+        recordDfsTrace(g, randomLive(g, rng), tr);
+        player.load(tr); player.skipToEnd(changed); changed.clear();
+    });
+    player.unload();
+
+    const int Q = 100000;
+    vector<int> qx(Q), qy(Q);
+    for(int i=0;i<Q;i++){ qx[i] = (int)rng.below(side); qy[i] = (int)rng.below(side); }
+    long long hits = 0;
+    t0 = nowSec();
+    for(int i=0;i<Q;i++) hits += spatial.nodeAt(qx[i], qy[i]) >= 0;
+    report("find_node_at", Q, nowSec() - t0);
+    t0 = nowSec();
+    for(int i=0;i<Q;i++) hits += spatial.edgeNear(qx[i], qy[i], 8.0).first >= 0;
+    report("find_edge_near", Q, nowSec() - t0);
+
+    StubCanvas canvas;
+    timed("draw_all", 0.2, 50, [&](int64_t){ drawAllStub(canvas, g); });
+
+    /* edits go through History with the spatial index attached, as in the editor */
+    History history;
+    int edits = min(1000, g.nodeCount);
+    int made = 0;
+    t0 = nowSec();
+    for(int k=0;k<edits*4 && made<edits;k++){
+        int u = randomLive(g, rng), v = randomLive(g, rng);
+        if(g.hasEdge(u, v)) continue;
+        history.addEdge(g, u, v, 1 + (int)rng.below(999));
+        made++;
+    }
+    report("history_add_edge", made, nowSec() - t0);
+    t0 = nowSec();
+    for(int k=0;k<made;k++) history.undo(g);
+    report("history_undo", made, nowSec() - t0);
+    t0 = nowSec();
+    for(int k=0;k<made;k++) history.redo(g);
+    report("history_redo", made, nowSec() - t0);
+
+    history.reset();
+    int dels = min(1000, g.nodeCount / 10);
+    t0 = nowSec();
+    for(int k=0;k<dels;k++){
+        history.deleteNode(g, randomLive(g, rng));
+        history.compactIfFragmented(g);     // undone together with the delete
+    }
+    report("delete_node", dels, nowSec() - t0);
+    t0 = nowSec();
+    for(int k=0;k<dels;k++) history.undo(g);
+    report("undo_delete_node", dels, nowSec() - t0);
+
+    g.removeObserver(&spatial);
+    fprintf(stderr, "  (hits %lld, %ld prims, checksum %llx)\n", hits, canvas.prims, (unsigned long long)canvas.sum);
+}
+
+static void splitList(const char *s, vector<string> &out){
+    out.clear();
+    string cur;
+    for(; *s; s++){
+        if(*s == ','){ if(!cur.empty()) out.push_back(cur); cur.clear(); }
+        else cur += *s;
+    }
+    if(!cur.empty()) out.push_back(cur);
+}
+
+int main(int argc,char **argv){
+    vector<string> sizes, families;
+    splitList("1000,10000,100000", sizes);
+    splitList("er,rmat,grid,star", families);
+    const char *outPath = 0;
+    for(int i=1;i<argc;i++){
+        if(!strncmp(argv[i], "--sizes=", 8)) splitList(argv[i]+8, sizes);
+        else if(!strncmp(argv[i], "--families=", 11)) splitList(argv[i]+11, families);
+        else if(!strncmp(argv[i], "--out=", 6)) outPath = argv[i]+6;
+        else { fprintf(stderr, "usage: bench_suite [--sizes=a,b,..] [--families=er,rmat,grid,star] [--out=file]\n"); return 1; }
+    }
+
+    for(size_t s=0;s<sizes.size();s++)
+        for(size_t f=0;f<families.size();f++)
+            for(int d=0;d<2;d++)
+                for(int w=0;w<2;w++)
+                    runGraph(families[f], atoi(sizes[s].c_str()), d==1, w==1);
+
+    FILE *out = outPath ? fopen(outPath, "w") : stdout;
+    if(!out){ fprintf(stderr, "cannot write %s\n", outPath); return 1; }
+    writeJson(out);
+    if(outPath) fclose(out);
+    return 0;
+}
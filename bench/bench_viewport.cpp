@@ -0,0 +1,188 @@
+/* bench_viewport.cpp - a full frame of the editor's 1000x580 scene area at
+   zoom levels from 2x down to 1/200, centred on the graph:
+     all      drawScene through the Viewport: every node and edge is
+              transformed and issued, the canvas clips
+     culled   what the editor draws: the edges and nodes the spatial index
+              has in view with the zoom's level of detail, or the
+              GridBundles aggregate when zoomed out or too dense
+   Primitives go to a counting Canvas, so the times are the scene code
+   alone.  "builds" is how many aggregate levels the culled run built (each
+   O(nodes + edges); the previous row's edit invalidated them), "edit ms"
+   a culled frame right after a node moves, and "damage ms" the node
+   lookups of a partial repaint: 32 node-sized screen rectangles plus
+   their bounding box (what DamageList collapses to past 32).
+     grid    a lattice graph: short edges, like a drawn mesh
+     R-MAT   random hub-heavy edges across the whole layout
+   A third run zooms out to 1/256 over a small graph spread wide, where
+   a damage rectangle spans far more index cells than are occupied.
+   usage: bench_viewport [side=600] [scale=16] [edgefactor=8] */
+#include "generators.h"
+#include "scene.h"
+#include "spatial_index.h"
+#include "viewport.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* --- Counts what would be drawn --- */
+class CountingCanvas : public Canvas {
+public:
+    long prims;
+    CountingCanvas(): prims(0) {}
+    void setColor(int) {}
+    void setFillColor(int) {}
+    void setTextBackground(int) {}
+    void setLineWidth(int) {}
+    void line(int,int,int,int) { prims++; }
+    void bar(int,int,int,int) { prims++; }
+    void rect(int,int,int,int) { prims++; }
+    void fillEllipse(int,int,int,int) { prims++; }
+    void circle(int,int,int) { prims++; }
+    void ellipse(int,int,int,int) { prims++; }
+    void text(int,int,const char*) { prims++; }
+    int textWidth(const char *s) { return 8*(int)strlen(s); }
+    int textHeight(const char *) { return 8; }
+};
+
+static const Rect SCREEN = { 0, 70, 999, 649 };
+
+static void culledFrame(Canvas &c, const Graph &g, const SpatialIndex &index, GridBundles &bundles,
+                        const Viewport &view, SceneText &text){
+    static vector<int> ids;
+    Rect w = view.toWorld(SCREEN);
+    int pad = (int)ceil(view.toWorldLen(32));
+    Rect world = makeRect(w.x0-pad, w.y0-pad, w.x1+pad, w.y1+pad);
+    if(viewAggregated(index, view, world)){
+        drawBundles(c, bundles, g, view, world);
+        return;
+    }
+    drawEdgesInView(c, g, index, view, world, &text);
+    index.nodesInRect(w.x0, w.y0, w.x1, w.y1, ids);
+    sort(ids.begin(), ids.end());
+    for(size_t k=0;k<ids.size();k++) drawNode(c, g, ids[k], PAL_LIGHTCYAN, &text, &view);
+}
+
+/* --- Node lookups for 32 damaged nodes (their rectangles clipped to the
+   screen, as the editor clips damage), then their bounding box --- */
+static long damageQueries(const Graph &g, const SpatialIndex &index, const Viewport &view){
+    static vector<int> ids;
+    long found = 0;
+    Rect box = makeRect(0, 0, -1, -1);
+    int step = max(1, g.slotCount() / 32);
+    for(int k=0, v=0; k<32 && v<g.slotCount(); k++, v+=step){
+        int x = view.toScreenX(g.nodes[v].x), y = view.toScreenY(g.nodes[v].y);
+        Rect r;
+        if(!rectIntersect(makeRect(x-22, y-22, x+22, y+22), SCREEN, r)) continue;
+        box = box.x1 >= box.x0 ? makeRect(min(box.x0, r.x0), min(box.y0, r.y0), max(box.x1, r.x1), max(box.y1, r.y1)) : r;
+        Rect w = view.toWorld(r);
+        index.nodesInRect(w.x0, w.y0, w.x1, w.y1, ids);
+        found += (long)ids.size();
+    }
+    if(box.x1 < box.x0) return found;
+    Rect w = view.toWorld(box);
+    index.nodesInRect(w.x0, w.y0, w.x1, w.y1, ids);
+    return found + (long)ids.size();
+}
+
+/* --- Mean ms per frame over enough frames to fill ~0.2 s (at least 2) --- */
+template<class F>
+static double timeFrames(F frame, long *prims){
+    int frames = 0;
+    double t0 = nowSec(), t = 0;
+    do { *prims = frame(); frames++; t = nowSec() - t0; } while(frames < 2 || (t < 0.2 && frames < 50));
+    return t / frames * 1e3;
+}
+
+static void runGraph(const char *name, Graph &g, const double *zooms, size_t zoomCount){
+    SpatialIndex index(NODE_RADIUS);
+    index.rebuild(g);
+    g.addObserver(&index);
+    GridBundles bundles;
+    g.addObserver(&bundles);
+    SceneText text;
+    g.addObserver(&text);
+
+    int x0 = g.nodes[0].x, y0 = g.nodes[0].y, x1 = x0, y1 = y0;
+    for(int v=0;v<g.slotCount();v++){
+        x0 = min(x0, g.nodes[v].x); x1 = max(x1, g.nodes[v].x);
+        y0 = min(y0, g.nodes[v].y); y1 = max(y1, g.nodes[v].y);
+    }
+    printf("\n%s: %d nodes, %lld adjacency entries, world %dx%d\n", name, g.nodeCount,
+           (long long)g.index.size(), x1-x0, y1-y0);
+    printf("  %7s %10s %12s %10s %12s %9s %7s %8s %9s %10s\n", "zoom", "all ms", "all prims", "culled ms", "culled prims",
+           "speedup", "mode", "builds", "edit ms", "damage ms");
+
+    for(size_t z=0; z<zoomCount; z++){
+        Viewport view;
+        view.scale = zooms[z];
+        view.tx = (SCREEN.x0 + SCREEN.x1)/2 - view.scale*(x0 + x1)/2;
+        view.ty = (SCREEN.y0 + SCREEN.y1)/2 - view.scale*(y0 + y1)/2;
+        Rect w = view.toWorld(SCREEN);
+        int pad = (int)ceil(view.toWorldLen(32));
+        bool bundled = viewAggregated(index, view, makeRect(w.x0-pad, w.y0-pad, w.x1+pad, w.y1+pad));
+
+        CountingCanvas c;
+        long allPrims = 0, culledPrims = 0;
+        double tAll = timeFrames([&]{ c.prims = 0; drawScene(c, g, &text, &view); return c.prims; }, &allPrims);
+        int64_t before = bundles.builds();
+        double tCulled = timeFrames([&]{ c.prims = 0; culledFrame(c, g, index, bundles, view, text); return c.prims; }, &culledPrims);
+        int64_t built = bundles.builds() - before;
+
+        int v = g.slotCount() / 2;
+        g.moveNode(v, g.nodes[v].x + 1, g.nodes[v].y);
+        double t0 = nowSec();
+        culledFrame(c, g, index, bundles, view, text);
+        double tEdit = (nowSec() - t0) * 1e3;
+        g.moveNode(v, g.nodes[v].x - 1, g.nodes[v].y);
+        long hits = 0;
+        double tDamage = timeFrames([&]{ return damageQueries(g, index, view); }, &hits);
+        printf("  %6.1f%% %10.2f %12ld %10.3f %12ld %8.0fx %7s %8lld %9.2f %10.3f\n", zooms[z]*100, tAll, allPrims, tCulled, culledPrims,
+               tAll / tCulled, bundled ? "bundled" : "culled", (long long)built, tEdit, tDamage);
+    }
+    g.removeObserver(&bundles);
+    g.removeObserver(&text);
+    g.removeObserver(&index);
+}
+
+int main(int argc,char **argv){
+    int side = argc>1 ? atoi(argv[1]) : 600;
+    int scale = argc>2 ? atoi(argv[2]) : 16;
+    int ef = argc>3 ? atoi(argv[3]) : 8;
+
+    const double zooms[] = { 2.0, 1.0, 0.5, 0.25, 0.1, 0.02, 0.005 };
+    const size_t zoomCount = sizeof(zooms)/sizeof(zooms[0]);
+    EdgeList el;
+    Graph g;
+    char name[64];
+    generateGrid(side, side, el);
+    assignWeights(el, 99, 1);
+    edgeListToGraph(el, false, true, g);
+    snprintf(name, sizeof name, "grid %dx%d (weighted)", side, side);
+    runGraph(name, g, zooms, zoomCount);
+
+    generateRmat(scale, ef, 2, el);
+    edgeListToGraph(el, true, false, g);
+    snprintf(name, sizeof name, "R-MAT scale %d (directed)", scale);
+    runGraph(name, g, zooms, zoomCount);
+
+    /* 1000 nodes on a 40x25 lattice 4000 px apart */
+    g.clear();
+    g.directed = false; g.weighted = false;
+    for(int i=0;i<1000;i++) g.addNode((i % 40) * 4000, (i / 40) * 4000);
+    for(int i=0;i<1000;i++){
+        if(i % 40 != 39) g.addEdge(i, i+1, 1);
+        if(i + 40 < 1000) g.addEdge(i, i+40, 1);
+    }
+    const double far[] = { 1.0/16, 1.0/64, 1.0/256 };
+    runGraph("sparse lattice, 1000 nodes 4000 px apart", g, far, sizeof(far)/sizeof(far[0]));
+    return 0;
+}
@@ -0,0 +1,200 @@
+/* bench_worker.cpp - the background traversal worker (algo_worker.h) on
+   an R-MAT graph, from the UI thread's point of view:
+     snapshot   freezing the editor Graph into a shared CSR, and what a
+                cached request and a request after an edit cost, that a
+                weight change refreezes; then
+                what starting a run after an edit costs this thread (the
+                worker freezes), how long an edit right after waits, and
+                that a layout step meanwhile keeps the worker's copy
+     stream     BFS / DFS / Dijkstra recorded on the worker while this
+                thread polls collect() every millisecond, like the editor's
+                loop: time to the first chunk (when playback can begin),
+                total time against recording on this thread, and the time
+                this thread spent collecting;
+                then a path search, whose distances the worker keeps, and
+                the diameter key's multi-source BFS, finished and cancelled
+     cancel     a run cancelled after 1, 5 and 20 ms, repeated: how long
+                until the worker is idle again
+   usage: bench_worker [scale=19] [edgefactor=8] [repeats=10] */
+#include "algo_worker.h"
+#include "generators.h"
+#include "shortest_path.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static const char *KIND_NAMES[] = { "BFS", "DFS", "SSSP" };
+
+/* --- The same traversal recorded on this thread --- */
+static double recordHere(const CsrView &g, AlgoKind kind, int root, Trace &tr){
+    double t0 = nowSec();
+    if(kind == ALGO_BFS) recordBfsTrace(g, root, tr);
+    else if(kind == ALGO_DFS) recordDfsTrace(g, root, tr);
+    else { SsspResult r; dijkstra(g, root, r); recordSsspTrace(g, r, tr); }
+    return nowSec() - t0;
+}
+
+int main(int argc,char **argv){
+    int scale = argc>1 ? atoi(argv[1]) : 19;
+    int ef = argc>2 ? atoi(argv[2]) : 8;
+    int repeats = argc>3 ? atoi(argv[3]) : 10;
+
+    EdgeList el;
+    generateRmat(scale, ef, 1, el);
+    assignWeights(el, 255, 2);
+    Graph graph;
+    edgeListToGraph(el, false, true, graph);
+    CsrSnapshot snapshot;
+    graph.addObserver(&snapshot);
+
+    double t0 = nowSec();
+    shared_ptr<const CsrGraph> snap = snapshot.get(graph);
+    double tFreeze = nowSec() - t0;
+    t0 = nowSec();
+    for(int i=0;i<1000;i++) snapshot.get(graph);
+    double tCached = (nowSec() - t0) / 1000;
+    graph.addEdge(0, graph.slotCount()-1, 1);
+    t0 = nowSec();
+    shared_ptr<const CsrGraph> after = snapshot.get(graph);
+    double tRefreeze = nowSec() - t0;
+    printf("R-MAT scale %d: n=%d, %lld adjacency entries\n", scale, snap->vertexCount(), (long long)snap->edgeCount());
+    printf("snapshot: freeze %.1f ms, cached %.3f us, after an edit %.1f ms (old copy still held: %s)\n",
+           tFreeze*1e3, tCached*1e6, tRefreeze*1e3, snap.get() != after.get() ? "yes" : "no");
+
+    int wu = 0;
+    while(graph.adj[wu].empty()) wu++;
+    int wv = graph.adj[wu][0].first, was = graph.adj[wu][0].second;
+    graph.setEdgeWeight(wu, wv, was + 1);
+    shared_ptr<const CsrGraph> reweighed = snapshot.get(graph);
+    CsrView rv = reweighed->view();
+    bool seen = false;
+    for(int64_t e=rv.offsets[wu]; e<rv.offsets[wu+1]; e++)
+        if(rv.targets[e] == wv) seen = rv.weights && rv.weights[e] == was + 1;
+    graph.setEdgeWeight(wu, wv, was);
+    printf("a weight change reaches the next snapshot: %s\n", seen ? "yes" : "NO");
+
+    AlgorithmWorker worker;
+    graph.addEdge(1, graph.slotCount()-2, 1);
+    t0 = nowSec();
+    worker.start(ALGO_BFS, 0, snapshot, graph);
+    double tStart = nowSec() - t0;
+    t0 = nowSec();
+    graph.addEdge(2, graph.slotCount()-3, 1);           // waits until the worker has its copy
+    double tWait = nowSec() - t0;
+    worker.cancel();
+    while(worker.busy()) this_thread::yield();
+    printf("start after an edit: %.3f ms on this thread; an edit straight after waited %.1f ms\n",
+           tStart*1e3, tWait*1e3);
+
+    /* a layout step (positions only) while the worker freezes: the copy stays */
+    vector< pair<int,int> > pos(graph.slotCount());
+    for(int v=0;v<graph.slotCount();v++) pos[v] = make_pair(graph.nodes[v].x + 1, graph.nodes[v].y);
+    graph.addEdge(3, graph.slotCount()-4, 1);
+    worker.start(ALGO_BFS, 0, snapshot, graph);
+    graph.swapPositions(pos);
+    graph.swapPositions(pos);
+    while(worker.busy()) this_thread::yield();
+    int64_t built = snapshot.builds();
+    snapshot.get(graph);
+    printf("a layout step during that freeze kept the copy: %s\n", snapshot.builds() == built ? "yes" : "NO");
+    worker.cancel();
+
+    snap = snapshot.get(graph);
+    CsrView g = snap->view();
+
+    int root = 0;
+    for(int v=0;v<g.n;v++) if(g.degree(v) > g.degree(root)) root = v;
+
+    printf("\n%-5s %10s %11s %10s %12s %10s %9s\n", "algo", "here ms", "worker ms", "first ms", "collect ms", "events", "match");
+    for(int k=0;k<3;k++){
+        AlgoKind kind = (AlgoKind)k;
+        Trace want, got;
+        double tHere = recordHere(g, kind, root, want);
+
+        got.clear(g.n);
+        double start = nowSec(), first = 0, collecting = 0;
+        worker.start(kind, root, snap);
+        while(!worker.finished()){
+            double c0 = nowSec();
+            bool added = worker.collect(got);
+            collecting += nowSec() - c0;
+            if(added && !first) first = nowSec() - start;
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+        double total = nowSec() - start;
+        bool match = got.steps == want.steps && got.events.size() == want.events.size();
+        for(size_t i=0; match && i<got.events.size(); i++)
+            match = got.events[i].node == want.events[i].node && got.events[i].packed == want.events[i].packed;
+        printf("%-5s %10.1f %11.1f %10.2f %12.2f %10zu %9s\n", KIND_NAMES[k], tHere*1e3, total*1e3, first*1e3,
+               collecting*1e3, got.events.size(), match ? "yes" : "NO");
+    }
+
+    {
+        Trace none;
+        double start = nowSec();
+        worker.start(ALGO_PATH, root, snap);
+        while(!worker.finished()){ worker.collect(none); this_thread::sleep_for(chrono::milliseconds(1)); }
+        double total = nowSec() - start;
+        shared_ptr<const AlgoResult> r = worker.result();
+        SsspResult want;
+        dijkstra(g, root, want);
+        printf("path search (no trace): %.1f ms on the worker, distances kept and matching: %s\n",
+               total*1e3, r && r->sssp.dist == want.dist ? "yes" : "NO");
+    }
+
+    {
+        vector<int32_t> sources;
+        for(int v=0; v<g.n && v<4096; v++) sources.push_back(v);
+        Trace none;
+        double start = nowSec();
+        worker.startEccentricity(sources, snapshot, graph);
+        while(!worker.finished()){ worker.collect(none); this_thread::sleep_for(chrono::milliseconds(1)); }
+        double total = nowSec() - start;
+        shared_ptr<const AlgoResult> r = worker.result();
+        MultiBfsResult want;
+        multiSourceBfs(g, sources, want);
+        worker.startEccentricity(vector<int32_t>(), snapshot, graph);       // every vertex
+        this_thread::sleep_for(chrono::milliseconds(5));
+        double c0 = nowSec();
+        worker.cancel();
+        while(worker.busy()) this_thread::yield();
+        double lat = nowSec() - c0;
+        worker.collect(none);
+        printf("eccentricity of %zu sources: %.1f ms on the worker, matching: %s; "
+               "all sources cancelled after 5 ms: idle in %.3f ms\n", sources.size(), total*1e3,
+               r && r->eccentricity.eccentricity == want.eccentricity ? "yes" : "NO", lat*1e3);
+    }
+
+    printf("\ncancellation: time from cancel() until the worker is idle\n");
+    printf("%-5s %8s %10s %10s\n", "algo", "after", "mean ms", "max ms");
+    const int delays[] = { 1, 5, 20 };
+    for(int k=0;k<3;k++){
+        for(int d=0;d<3;d++){
+            double sum = 0, worst = 0;
+            for(int r=0;r<repeats;r++){
+                Trace sink;
+                worker.start((AlgoKind)k, (root + r) % g.n, snap);
+                this_thread::sleep_for(chrono::milliseconds(delays[d]));
+                worker.collect(sink);
+                double c0 = nowSec();
+                worker.cancel();
+                while(worker.busy()) this_thread::yield();
+                double lat = nowSec() - c0;
+                worker.collect(sink);               // recycle what was queued
+                sum += lat; worst = max(worst, lat);
+            }
+            printf("%-5s %6d ms %10.3f %10.3f\n", KIND_NAMES[k], delays[d], sum/repeats*1e3, worst*1e3);
+        }
+    }
+    return 0;
+}
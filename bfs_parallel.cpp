@@ -0,0 +1,141 @@
+#include "bfs_parallel.h"
+
+#include <algorithm>
+
+using namespace std;
+
+static void initResult(BfsResult &out, int n){
+    out.parent.assign(n, -1);
+    out.depth.assign(n, -1);
+    out.reached = 0; out.levels = 0;
+    out.topDownLevels = 0; out.bottomUpLevels = 0;
+}
+
+void sequentialBfs(const CsrView &g, int source, BfsResult &out){
+    initResult(out, g.n);
+    if(source<0 || source>=g.n) return;
+    vector<int32_t> q; q.reserve(g.n);
+    size_t head = 0;
+    q.push_back(source); out.parent[source]=source; out.depth[source]=0;
+    while(head<q.size()){
+        int u=q[head++];
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v=g.targets[i];
+            if(out.depth[v]<0){ out.depth[v]=out.depth[u]+1; out.parent[v]=u; q.push_back(v); }
+        }
+    }
+    out.reached = (int64_t)q.size();
+    out.levels = q.empty() ? 0 : out.depth[q.back()] + 1;
+    out.topDownLevels = out.levels;
+}
+
+/* --- Concatenate per-worker buffers into `dst` --- */
+static void gather(vector< vector<int32_t> > &local, vector<int32_t> &dst){
+    size_t total = 0;
+    for(size_t w=0;w<local.size();w++) total += local[w].size();
+    dst.resize(total);
+    size_t at = 0;
+    for(size_t w=0;w<local.size();w++){
+        copy(local[w].begin(), local[w].end(), dst.begin()+at);
+        at += local[w].size();
+        local[w].clear();
+    }
+}
+
+void parallelBfs(const CsrView &g, int source, BfsResult &out, const BfsOptions &opt, ThreadPool &pool){
+    int n = g.n;
+    initResult(out, n);
+    if(source<0 || source>=n) return;
+
+    const CsrView *in = g.directed ? opt.incoming : &g;
+    bool canBottomUp = opt.directionOptimizing && in != 0;
+
+    int workers = pool.size();
+    AtomicBitmap visited(n), frontierBits;
+    if(canBottomUp) frontierBits.resize(n);
+    vector< vector<int32_t> > local(workers);
+    vector<int64_t> localEdges(workers);
+
+    vector<int32_t> frontier, next;
+    frontier.push_back(source);
+    visited.set(source);
+    out.parent[source] = source; out.depth[source] = 0;
+    out.reached = 1;
+
+    int64_t unexploredEdges = g.m - g.degree(source);
+    int64_t frontierEdges = g.degree(source);
+    bool bottomUp = false;
+    int32_t level = 0;
+
+    int32_t *parent = &out.parent[0];
+    int32_t *depth = &out.depth[0];
+
+    while(!frontier.empty()){
+        if(canBottomUp){
+            if(!bottomUp && frontierEdges > unexploredEdges / opt.alpha) bottomUp = true;
+            else if(bottomUp && (int64_t)frontier.size() < n / opt.beta) bottomUp = false;
+        }
+        fill(localEdges.begin(), localEdges.end(), 0);
+        int32_t nextDepth = level + 1;
+
+        if(!bottomUp){
+            out.topDownLevels++;
+            pool.parallelFor(0, (int64_t)frontier.size(), 256, [&](int64_t lo, int64_t hi, int w){
+                vector<int32_t> &mine = local[w];
+                int64_t edges = 0;
+                for(int64_t f=lo; f<hi; f++){
+                    int u = frontier[f];
+                    for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+                        int v = g.targets[i];
+                        if(visited.test(v) || !visited.set(v)) continue;
+                        parent[v] = u; depth[v] = nextDepth;
+                        mine.push_back(v);
+                        edges += g.offsets[v+1] - g.offsets[v];
+                    }
+                }
+                localEdges[w] += edges;
+            });
+        } else {
+            out.bottomUpLevels++;
+            frontierBits.clear();
+            pool.parallelFor(0, (int64_t)frontier.size(), 4096, [&](int64_t lo, int64_t hi, int){
+                for(int64_t f=lo; f<hi; f++) frontierBits.set(frontier[f]);
+            });
+            /* chunks are whole bitmap words so each word of `visited` that a
+               chunk writes is only ever read-modify-written by that chunk */
+            pool.parallelFor(0, visited.wordCount(), 64, [&](int64_t lo, int64_t hi, int w){
+                vector<int32_t> &mine = local[w];
+                int64_t edges = 0;
+                for(int64_t wd=lo; wd<hi; wd++){
+                    uint64_t seen = visited.word(wd);
+                    if(seen == ~(uint64_t)0) continue;
+                    int64_t base = wd << 6;
+                    int64_t lim = min<int64_t>(64, n - base);
+                    for(int64_t b=0; b<lim; b++){
+                        if((seen >> b) & 1) continue;
+                        int v = (int)(base + b);
+                        for(int64_t i=in->offsets[v]; i<in->offsets[v+1]; i++){
+                            int u = in->targets[i];
+                            if(!frontierBits.test(u)) continue;
+                            visited.set(v);
+                            parent[v] = u; depth[v] = nextDepth;
+                            mine.push_back(v);
+                            edges += g.offsets[v+1] - g.offsets[v];
+                            break;
+                        }
+                    }
+                }
+                localEdges[w] += edges;
+            });
+        }
+
+        gather(local, next);
+        frontier.swap(next);
+        frontierEdges = 0;
+        for(int w=0; w<workers; w++) frontierEdges += localEdges[w];
+        unexploredEdges -= frontierEdges;
+        out.reached += (int64_t)frontier.size();
+        level++;
+    }
+    out.levels = level;
+}
@@ -0,0 +1,38 @@
+/* bfs_parallel.h - multi-threaded direction-optimizing BFS over a CSR.
+   Levels are expanded top-down (frontier pushes to neighbours) while the
+   frontier is small and bottom-up (unvisited vertices look for a parent
+   in the frontier) once it covers a large share of the remaining edges
+   (Beamer et al.).  Visited state lives in an atomic bitmap, separate
+   from the graph; the result is a parent and a depth per vertex. */
+#ifndef BFS_PARALLEL_H
+#define BFS_PARALLEL_H
+
+#include "graph_core.h"
+#include "parallel.h"
+
+#include <stdint.h>
+#include <vector>
+
+struct BfsOptions {
+    const CsrView *incoming;    // reverse edges for bottom-up on directed graphs (0 = top-down only)
+    bool directionOptimizing;
+    double alpha, beta;         // switch down when frontier edges > unexplored/alpha, back when |F| < n/beta
+
+    BfsOptions(): incoming(0), directionOptimizing(true), alpha(15.0), beta(18.0) {}
+};
+
+struct BfsResult {
+    std::vector<int32_t> parent;    // parent[source] = source, -1 when unreached
+    std::vector<int32_t> depth;     // hop count, -1 when unreached
+    int64_t reached;
+    int levels;
+    int topDownLevels, bottomUpLevels;
+};
+
+void parallelBfs(const CsrView &g, int source, BfsResult &out,
+                 const BfsOptions &opt = BfsOptions(), ThreadPool &pool = defaultPool());
+
+/* Plain single-threaded queue BFS (the editor's traversal) for reference. */
+void sequentialBfs(const CsrView &g, int source, BfsResult &out);
+
+#endif
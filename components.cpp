@@ -0,0 +1,110 @@
+/* components.cpp - union-find and the incremental connectivity observer */
+#include "components.h"
+
+using namespace std;
+
+/* --- Union-find --- */
+void DisjointSets::reset(int n){
+    parent.resize(n); count.assign(n, 1); minId.resize(n);
+    for(int i=0;i<n;i++) parent[i] = minId[i] = i;
+    sets = n;
+}
+
+int DisjointSets::add(){
+    int id = (int)parent.size();
+    parent.push_back(id); count.push_back(1); minId.push_back(id);
+    sets++;
+    return id;
+}
+
+int DisjointSets::find(int v){
+    while(parent[v] != v){
+        parent[v] = parent[parent[v]];          // path halving
+        v = parent[v];
+    }
+    return v;
+}
+
+bool DisjointSets::unite(int a,int b){
+    a = find(a); b = find(b);
+    if(a == b) return false;
+    if(count[a] < count[b]) swap(a, b);
+    parent[b] = a;
+    count[a] += count[b];
+    if(minId[b] < minId[a]) minId[a] = minId[b];
+    sets--;
+    return true;
+}
+
+/* --- Connectivity --- */
+Connectivity::Connectivity(): graph(0), directed(false), stale(true), sccCount(0), ver(0) {}
+
+void Connectivity::rebuild(const Graph &g){
+    graph = &g;
+    invalidate();
+    refresh();
+}
+
+/* --- One linear pass over the whole graph: union every adjacency entry,
+   or run Tarjan and name each SCC after its smallest member --- */
+void Connectivity::refresh(){
+    if(!stale || !graph) return;
+    const Graph &g = *graph;
+    int n = g.slotCount();
+    directed = g.directed;
+    if(!directed){
+        sets.reset(n);
+        for(int u=0;u<n;u++)
+            for(int i=0;i<g.degree(u);i++) sets.unite(u, g.target(u,i));
+        scc.clear();
+    } else {
+        vector<int> comp;
+        int c = stronglyConnectedComponents(g, comp);
+        vector<int> smallest(c, n);
+        for(int v=0;v<n;v++) if(v < smallest[comp[v]]) smallest[comp[v]] = v;
+        scc.resize(n);
+        for(int v=0;v<n;v++) scc[v] = smallest[comp[v]];
+        sccCount = c;
+    }
+    stale = false;
+}
+
+int Connectivity::component(int v){
+    refresh();
+    return directed ? scc[v] : sets.smallest(v);
+}
+
+/* tombstones have no edges, so each is a singleton of its own */
+int Connectivity::componentCount(){
+    refresh();
+    if(!graph) return 0;
+    int dead = graph->slotCount() - graph->nodeCount;
+    return (directed ? sccCount : sets.setCount()) - dead;
+}
+
+/* --- Observer: new nodes, and new edges of an undirected graph, are
+   applied in place; everything else waits for the next query --- */
+void Connectivity::nodeInserted(const Graph &g,int id){
+    if(stale) return;
+    if(directed != g.directed){ invalidate(); return; }
+    int known = directed ? (int)scc.size() : sets.size();
+    if(id == known){
+        if(directed){ scc.push_back(id); sccCount++; } else sets.add();
+    }
+    /* a reused slot was a tombstone, already a singleton of its own */
+    ver++;
+}
+
+void Connectivity::nodeRemoved(const Graph &,int){ invalidate(); }
+
+void Connectivity::nodeMoved(const Graph &,int){}
+
+void Connectivity::edgeAdded(const Graph &g,int u,int v){
+    if(stale) return;
+    if(directed || g.directed){ invalidate(); return; }     // may merge SCCs: recompute
+    if(sets.unite(u, v)) ver++;
+}
+
+void Connectivity::edgeRemoved(const Graph &,int,int){ invalidate(); }
+
+void Connectivity::graphReset(const Graph &){ invalidate(); }
@@ -0,0 +1,108 @@
+/* components.h - connected components (undirected) and strongly connected
+   components (directed).
+
+   DisjointSets is a union-find with union by size and path halving; each
+   set also remembers its smallest member, which serves as a stable
+   component id.  stronglyConnectedComponents() is Tarjan's algorithm with
+   an explicit call stack instead of recursion, so a path of millions of
+   vertices cannot overflow the machine stack; like traversal.h it runs on
+   anything with vertexCount(), degree(u) and target(u,i).
+
+   Connectivity follows a Graph as an observer.  In an undirected graph an
+   added edge is one union (near-constant time); deletions, and any edit of
+   a directed graph, only mark it stale, and the next query recomputes
+   everything in one linear pass, so a burst of edits costs one pass. */
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include "graph_core.h"
+
+#include <vector>
+
+class DisjointSets {
+public:
+    DisjointSets(): sets(0) {}
+    void reset(int n);                          // n singletons
+    int  add();                                 // one more singleton, returns its id
+    int  find(int v);                           // root of v's set
+    bool unite(int a,int b);                    // false if already together
+    int  smallest(int v) { return minId[find(v)]; }     // smallest member of v's set
+    int  size() const { return (int)parent.size(); }
+    int  setCount() const { return sets; }
+
+private:
+    std::vector<int> parent, count, minId;      // count, minId: valid at roots
+    int sets;
+};
+
+/* --- Tarjan SCC: comp[v] = index of v's component, numbered in reverse
+   topological order of the condensation; returns the component count --- */
+template<class G>
+int stronglyConnectedComponents(const G &g, std::vector<int> &comp){
+    int n = g.vertexCount();
+    comp.assign(n, -1);
+    std::vector<int> index(n, -1), low(n), stack, callV, callI;
+    int next = 0, count = 0;
+    for(int s=0;s<n;s++){
+        if(index[s] >= 0) continue;
+        index[s] = low[s] = next++;
+        stack.push_back(s);
+        callV.push_back(s); callI.push_back(0);
+        while(!callV.empty()){
+            int u = callV.back(), i = callI.back();
+            if(i < g.degree(u)){
+                callI.back() = i + 1;
+                int v = g.target(u,i);
+                if(index[v] < 0){
+                    index[v] = low[v] = next++;
+                    stack.push_back(v);
+                    callV.push_back(v); callI.push_back(0);
+                } else if(comp[v] < 0 && index[v] < low[u]) low[u] = index[v];    // v still on the stack
+                continue;
+            }
+            if(low[u] == index[u]){
+                int w;
+                do { w = stack.back(); stack.pop_back(); comp[w] = count; } while(w != u);
+                count++;
+            }
+            callV.pop_back(); callI.pop_back();
+            if(!callV.empty() && low[u] < low[callV.back()]) low[callV.back()] = low[u];
+        }
+    }
+    return count;
+}
+
+class Connectivity : public GraphObserver {
+public:
+    Connectivity();
+
+    void rebuild(const Graph &g);               // then g.addObserver(&c)
+
+    /* smallest node id in v's component (strong component when directed) */
+    int  component(int v);
+    bool connected(int u,int v) { return component(u) == component(v); }
+    int  componentCount();                      // over live nodes
+    /* bumped whenever the partition may have changed (for repainting) */
+    unsigned version() const { return ver; }
+
+    /* GraphObserver */
+    void nodeInserted(const Graph &g,int id);
+    void nodeRemoved(const Graph &g,int id);
+    void nodeMoved(const Graph &g,int id);
+    void edgeAdded(const Graph &g,int u,int v);
+    void edgeRemoved(const Graph &g,int u,int v);
+    void graphReset(const Graph &g);
+
+private:
+    const Graph *graph;
+    bool directed, stale;
+    DisjointSets sets;                          // undirected
+    std::vector<int> scc;                       // directed: smallest id of v's SCC
+    int sccCount;
+    unsigned ver;
+
+    void refresh();
+    void invalidate() { stale = true; ver++; }
+};
+
+#endif
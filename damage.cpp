@@ -0,0 +1,85 @@
+#include "damage.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/* weight labels are at most 6 digits of the 8x8 default font plus a
+   4px box margin; arrow heads reach 12px back from the tip */
+static const int LABEL_HALF_W = 6*8/2 + 4;
+static const int LABEL_HALF_H = 8/2 + 2;
+static const int LINE_PAD = 2;
+
+Rect makeRect(int x0,int y0,int x1,int y1){
+    Rect r; r.x0=x0; r.y0=y0; r.x1=x1; r.y1=y1;
+    return r;
+}
+
+bool rectsOverlap(const Rect &a, const Rect &b){
+    return a.x0<=b.x1 && b.x0<=a.x1 && a.y0<=b.y1 && b.y0<=a.y1;
+}
+
+Rect rectUnion(const Rect &a, const Rect &b){
+    return makeRect(min(a.x0,b.x0), min(a.y0,b.y0), max(a.x1,b.x1), max(a.y1,b.y1));
+}
+
+bool rectIntersect(const Rect &a, const Rect &b, Rect &out){
+    out = makeRect(max(a.x0,b.x0), max(a.y0,b.y0), min(a.x1,b.x1), min(a.y1,b.y1));
+    return out.x0<=out.x1 && out.y0<=out.y1;
+}
+
+/* --- Overlapping rectangles are merged so no pixel is painted twice --- */
+void DamageList::add(const Rect &r){
+    if(full) return;
+    Rect cur = r;
+    bool merged = true;
+    while(merged){
+        merged = false;
+        for(size_t i=0;i<list.size();i++){
+            if(rectsOverlap(list[i], cur)){
+                cur = rectUnion(list[i], cur);
+                list[i] = list.back(); list.pop_back();
+                merged = true;
+                break;
+            }
+        }
+    }
+    list.push_back(cur);
+    if((int)list.size() > MAX_RECTS){
+        Rect all = list[0];
+        for(size_t i=1;i<list.size();i++) all = rectUnion(all, list[i]);
+        list.clear(); list.push_back(all);
+    }
+}
+
+void DamageList::merge(const DamageList &o){
+    if(o.full){ addAll(); return; }
+    for(size_t i=0;i<o.list.size();i++) add(o.list[i]);
+}
+
+long DamageList::area() const {
+    long a = 0;
+    for(size_t i=0;i<list.size();i++) a += (long)(list[i].x1-list[i].x0+1) * (list[i].y1-list[i].y0+1);
+    return a;
+}
+
+/* --- Scene bounds --- */
+Rect nodeBounds(const Node &n, int r){
+    return makeRect(n.x-r-LINE_PAD, n.y-r-LINE_PAD, n.x+r+LINE_PAD, n.y+r+LINE_PAD);
+}
+
+Rect edgeBounds(const Node &a, const Node &b, int r, bool weighted, bool directed){
+    int px = LINE_PAD, py = LINE_PAD;
+    if(directed){ px = max(px, 12); py = max(py, 12); }
+    if(weighted){ px = max(px, LABEL_HALF_W); py = max(py, LABEL_HALF_H); }
+    (void)r;    // segment is shortened by r at both ends, so the centres bound it
+    return makeRect(min(a.x,b.x)-px, min(a.y,b.y)-py, max(a.x,b.x)+px, max(a.y,b.y)+py);
+}
+
+Rect selfLoopBounds(const Node &n, int r, bool weighted){
+    int ovalW = r + 10, ovalH = r/2 + 6;
+    int cx = n.x + r + 8, cy = n.y - r - 8;
+    int top = cy - ovalH - LINE_PAD;
+    if(weighted) top = cy - ovalH - 4 - 2*LABEL_HALF_H - 2;
+    return makeRect(cx-ovalW-LINE_PAD, top, cx+ovalW+LINE_PAD, cy+ovalH+LINE_PAD);
+}
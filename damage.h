@@ -0,0 +1,57 @@
+/* damage.h - damage tracking for incremental redraws.
+   The editor marks what changed (a hovered node, a visited node, a new
+   edge, a toolbar button) as screen rectangles; only those rectangles are
+   repainted over the cached background.  The *Bounds helpers give the
+   screen area each scene element covers, matching the editor's drawing. */
+#ifndef DAMAGE_H
+#define DAMAGE_H
+
+#include "graph_core.h"
+
+#include <vector>
+
+/* --- Inclusive pixel rectangle --- */
+struct Rect {
+    int x0, y0, x1, y1;
+};
+
+Rect makeRect(int x0,int y0,int x1,int y1);
+bool rectsOverlap(const Rect &a, const Rect &b);
+Rect rectUnion(const Rect &a, const Rect &b);
+bool rectIntersect(const Rect &a, const Rect &b, Rect &out);    // false if disjoint
+
+/* --- Set of damaged rectangles for one frame --- */
+class DamageList {
+public:
+    static const int MAX_RECTS = 32;    // beyond this, collapse to one bounding box
+
+    DamageList(): full(false) {}
+
+    void add(const Rect &r);            // merges with any overlapping rectangle
+    void addAll() { full = true; list.clear(); }
+    void merge(const DamageList &o);
+    void clear() { full = false; list.clear(); }
+
+    bool empty() const { return !full && list.empty(); }
+    bool isFull() const { return full; }
+    const std::vector<Rect> &rects() const { return list; }
+    long area() const;
+
+private:
+    std::vector<Rect> list;
+    bool full;
+};
+
+/* --- Per-frame redraw report --- */
+struct FrameStats {
+    long prims;     // primitives issued (lines, fills, outlines, text)
+    int  rects;     // damaged rectangles repainted (0 for a full frame)
+    bool full;
+};
+
+/* --- Screen bounds of scene elements (node radius r) --- */
+Rect nodeBounds(const Node &n, int r);
+Rect edgeBounds(const Node &a, const Node &b, int r, bool weighted, bool directed);
+Rect selfLoopBounds(const Node &n, int r, bool weighted);
+
+#endif
@@ -0,0 +1,104 @@
+#include "edge_index.h"
+
+#include <algorithm>
+
+using namespace std;
+
+const uint64_t EdgeIndex::EMPTY;
+
+EdgeIndex::EdgeIndex(): count(0), mask(0) {}
+
+/* --- splitmix64 finaliser: (u,v) keys are highly regular --- */
+size_t EdgeIndex::home(uint64_t k) const {
+    k ^= k >> 30; k *= 0xBF58476D1CE4E5B9ULL;
+    k ^= k >> 27; k *= 0x94D049BB133111EBULL;
+    k ^= k >> 31;
+    return (size_t)k & mask;
+}
+
+void EdgeIndex::clear(){
+    if(count){ fill(keys.begin(), keys.end(), EMPTY); count = 0; }
+}
+
+void EdgeIndex::reserve(size_t entries){
+    size_t cap = 16;
+    while(cap*3/4 < entries) cap <<= 1;
+    if(cap > keys.size()) rehash(cap);
+}
+
+void EdgeIndex::rehash(size_t cap){
+    vector<uint64_t> oldKeys(cap, EMPTY);
+    vector<int32_t> oldVals(cap);
+    oldKeys.swap(keys); oldVals.swap(vals);
+    mask = cap - 1;
+    for(size_t i=0;i<oldKeys.size();i++){
+        if(oldKeys[i]==EMPTY) continue;
+        size_t s = home(oldKeys[i]);
+        while(keys[s]!=EMPTY) s = (s+1) & mask;
+        keys[s] = oldKeys[i]; vals[s] = oldVals[i];
+    }
+}
+
+void EdgeIndex::insert(int u,int v,int pos){
+    if((count+1) > keys.size()*3/4) rehash(keys.empty() ? 16 : keys.size()*2);
+    uint64_t k = key(u,v);
+    size_t s = home(k);
+    while(keys[s]!=EMPTY) s = (s+1) & mask;
+    keys[s] = k; vals[s] = pos;
+    count++;
+}
+
+size_t EdgeIndex::slotOf(uint64_t k,int pos) const {
+    if(keys.empty()) return 0;
+    for(size_t s = home(k); keys[s]!=EMPTY; s = (s+1) & mask)
+        if(keys[s]==k && vals[s]==pos) return s;
+    return keys.size();
+}
+
+/* --- Backward shift: pull later members of the cluster into the hole
+   whenever the hole lies on their probe path --- */
+void EdgeIndex::eraseSlot(size_t s){
+    size_t hole = s;
+    for(size_t j = (s+1) & mask; keys[j]!=EMPTY; j = (j+1) & mask){
+        size_t h = home(keys[j]);
+        if(((j - h) & mask) >= ((j - hole) & mask)){
+            keys[hole] = keys[j]; vals[hole] = vals[j];
+            hole = j;
+        }
+    }
+    keys[hole] = EMPTY;
+    count--;
+}
+
+bool EdgeIndex::erase(int u,int v,int pos){
+    size_t s = slotOf(key(u,v), pos);
+    if(s >= keys.size()) return false;
+    eraseSlot(s);
+    return true;
+}
+
+bool EdgeIndex::move(int u,int v,int from,int to){
+    size_t s = slotOf(key(u,v), from);
+    if(s >= keys.size()) return false;
+    vals[s] = to;
+    return true;
+}
+
+int EdgeIndex::find(int u,int v) const {
+    size_t it;
+    return first(u,v,it);
+}
+
+int EdgeIndex::first(int u,int v,size_t &it) const {
+    if(keys.empty()) return -1;
+    it = home(key(u,v));
+    uint64_t k = key(u,v);
+    for(; keys[it]!=EMPTY; it = (it+1) & mask) if(keys[it]==k) return vals[it];
+    return -1;
+}
+
+int EdgeIndex::next(int u,int v,size_t &it) const {
+    uint64_t k = key(u,v);
+    for(it = (it+1) & mask; keys[it]!=EMPTY; it = (it+1) & mask) if(keys[it]==k) return vals[it];
+    return -1;
+}
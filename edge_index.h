@@ -0,0 +1,48 @@
+/* edge_index.h - open-addressing hash index over adjacency entries.
+   Every entry u -> v sitting at adj[u][pos] owns one slot keyed on (u,v)
+   holding pos, so has-edge and "where is it" are O(1) expected instead of
+   a scan of adj[u].  Parallel edges simply occupy several slots with the
+   same key.  Linear probing, no tombstones (backward-shift deletion),
+   load factor kept at or below 3/4. */
+#ifndef EDGE_INDEX_H
+#define EDGE_INDEX_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+class EdgeIndex {
+public:
+    EdgeIndex();
+
+    void clear();                       // keeps the table allocation
+    void reserve(size_t entries);
+
+    void insert(int u,int v,int pos);
+    bool erase(int u,int v,int pos);
+    bool move(int u,int v,int from,int to);     // entry changed position
+    int  find(int u,int v) const;               // position of some entry u -> v, or -1
+
+    /* all entries u -> v: for(int p = first(u,v,it); p >= 0; p = next(u,v,it)) */
+    int  first(int u,int v,size_t &it) const;
+    int  next(int u,int v,size_t &it) const;
+
+    size_t size() const { return count; }
+    size_t capacity() const { return keys.size(); }
+    size_t memoryBytes() const { return keys.capacity()*sizeof(uint64_t) + vals.capacity()*sizeof(int32_t); }
+
+private:
+    static const uint64_t EMPTY = ~(uint64_t)0;
+
+    std::vector<uint64_t> keys;
+    std::vector<int32_t> vals;
+    size_t count, mask;
+
+    static uint64_t key(int u,int v) { return ((uint64_t)(uint32_t)u << 32) | (uint32_t)v; }
+    size_t home(uint64_t k) const;
+    size_t slotOf(uint64_t k,int pos) const;    // slot holding (k,pos) or capacity()
+    void   eraseSlot(size_t s);
+    void   rehash(size_t cap);
+};
+
+#endif
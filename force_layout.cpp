@@ -0,0 +1,389 @@
+#include "force_layout.h"
+
+#include <math.h>
+#include <algorithm>
+
+using namespace std;
+
+static const int MAX_DEPTH = 48;    // deeper than this, coincident points share a leaf
+
+ForceLayout::ForceLayout(const LayoutOptions &o)
+    : opt(o), cur(0), n(0), stepLen(0), maxStep(0), lastEnergy(0), lastMove(0),
+      progress(0), iter(0), levelIter(0), converged(false) {}
+
+/* --- Small deterministic value in [-0.5, 0.5) per integer --- */
+static double jitter(uint32_t v){
+    uint32_t h = v * 0x9E3779B1u;
+    h ^= h >> 15; h *= 0x85EBCA77u; h ^= h >> 13;
+    return (h & 0xffff) / 65536.0 - 0.5;
+}
+
+void ForceLayout::start(const Graph &g){
+    int slots = g.slotCount();
+    alive.assign(slots, 0);
+    px.assign(slots, 0); py.assign(slots, 0);
+    vector<int32_t> src, dst;
+    for(int u=0; u<slots; u++){
+        if(!g.nodes[u].alive) continue;
+        alive[u] = 1;
+        px[u] = g.nodes[u].x; py[u] = g.nodes[u].y;
+        for(int k=0; k<g.degree(u); k++){
+            int v = g.target(u,k);
+            if(v == u) continue;
+            src.push_back(u); dst.push_back(v);
+            if(g.directed){ src.push_back(v); dst.push_back(u); }
+        }
+    }
+    init(src, dst);
+}
+
+void ForceLayout::start(const CsrView &g, const vector<double> &x, const vector<double> &y){
+    alive.assign(g.n, 1);
+    px = x; py = y;
+    px.resize(g.n, 0); py.resize(g.n, 0);
+    vector<int32_t> src, dst;
+    src.reserve(g.directed ? 2*g.m : g.m); dst.reserve(src.capacity());
+    for(int u=0; u<g.n; u++)
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v = g.targets[i];
+            if(v == u) continue;
+            src.push_back(u); dst.push_back(v);
+            if(g.directed){ src.push_back(v); dst.push_back(u); }
+        }
+    init(src, dst);
+}
+
+/* --- CSR with each row sorted and duplicates dropped --- */
+static CsrGraph simpleCsr(int n, const vector<int32_t> &src, const vector<int32_t> &dst){
+    CsrGraph c = buildCsrFromEdges(n, src, dst, vector<int32_t>(), false, false);
+    int64_t out = 0;
+    for(int u=0; u<n; u++){
+        int64_t lo = c.offsets[u], hi = c.offsets[u+1];
+        sort(c.targets.begin()+lo, c.targets.begin()+hi);
+        c.offsets[u] = out;
+        for(int64_t i=lo; i<hi; i++)
+            if(i == lo || c.targets[i] != c.targets[i-1]) c.targets[out++] = c.targets[i];
+    }
+    c.offsets[n] = out;
+    c.targets.resize(out);
+    c.weights.clear();
+    return c;
+}
+
+/* --- input positions are in px/py, alive is set --- */
+void ForceLayout::init(const vector<int32_t> &src, const vector<int32_t> &dst){
+    int n0 = (int)alive.size();
+    for(int v=0; v<n0; v++){ px[v] += jitter(2*v) * 1e-3 * opt.k; py[v] += jitter(2*v+1) * 1e-3 * opt.k; }
+    levels.assign(1, Level());
+    levels[0].adj = simpleCsr(n0, src, dst);
+    levels[0].n = n0;
+    if(opt.multilevel) while(levels.back().n > opt.coarsest && coarsen()) {}
+
+    /* the coarsest level starts at the centroids of what it merged */
+    int top = (int)levels.size() - 1;
+    rep.assign(n0, -1);
+    for(int v=0; v<n0; v++) if(alive[v]) rep[v] = v;
+    for(int l=0; l<top; l++)
+        for(int v=0; v<n0; v++) if(rep[v] >= 0) rep[v] = levels[l].up[rep[v]];
+    int nt = levels[top].n;
+    vector<double> cx(nt, 0), cy(nt, 0), cnt(nt, 0);
+    for(int v=0; v<n0; v++){
+        if(rep[v] < 0) continue;
+        cx[rep[v]] += px[v]; cy[rep[v]] += py[v]; cnt[rep[v]] += 1;
+    }
+    for(int c=0; c<nt; c++) if(cnt[c] > 0){ cx[c] /= cnt[c]; cy[c] /= cnt[c]; }
+    px.swap(cx); py.swap(cy);
+    cur = top; n = nt;
+    iter = 0;
+    enterLevel(top, opt.k);
+}
+
+/* --- One coarsening pass: match every vertex with an unmatched neighbour
+   of smallest degree (visited in a scrambled order) and merge each pair.
+   A vertex left without a partner joins a neighbour's pair (leaves of a
+   hub collapse into it); isolated vertices are merged two by two.  Gives
+   up when the graph barely shrinks. --- */
+bool ForceLayout::coarsen(){
+    Level &fine = levels.back();
+    int fn = fine.n;
+    bool base = levels.size() == 1;
+    vector<int> visit;
+    visit.reserve(fn);
+    for(int v=0; v<fn; v++) if(!base || alive[v]) visit.push_back(v);
+    int liveCount = (int)visit.size();
+    sort(visit.begin(), visit.end(), [](int a, int b){
+        double ja = jitter(a ^ 0x5bd1e995), jb = jitter(b ^ 0x5bd1e995);
+        return ja < jb || (ja == jb && a < b);
+    });
+
+    const CsrGraph &a = fine.adj;
+    vector<int> mate(fn, -1), up(fn, -1);
+    for(size_t k=0; k<visit.size(); k++){
+        int v = visit[k];
+        if(mate[v] >= 0) continue;
+        int best = -1;
+        int64_t bestDeg = 0;
+        for(int64_t i=a.offsets[v]; i<a.offsets[v+1]; i++){
+            int u = a.targets[i];
+            if(mate[u] >= 0 || (base && !alive[u])) continue;
+            int64_t d = a.offsets[u+1] - a.offsets[u];
+            if(best < 0 || d < bestDeg){ best = u; bestDeg = d; }
+        }
+        if(best >= 0){ mate[v] = best; mate[best] = v; }
+    }
+    int cn = 0;
+    for(size_t k=0; k<visit.size(); k++){
+        int v = visit[k];
+        if(mate[v] >= 0 && up[v] < 0) up[v] = up[mate[v]] = cn++;
+    }
+    int pendingIsolated = -1;
+    for(size_t k=0; k<visit.size(); k++){
+        int v = visit[k];
+        if(up[v] >= 0) continue;
+        for(int64_t i=a.offsets[v]; i<a.offsets[v+1] && up[v] < 0; i++)
+            if(up[a.targets[i]] >= 0) up[v] = up[a.targets[i]];   // every live neighbour is matched
+        if(up[v] >= 0) continue;
+        if(pendingIsolated < 0){ pendingIsolated = cn; up[v] = cn++; }
+        else { up[v] = pendingIsolated; pendingIsolated = -1; }
+    }
+    if(cn > liveCount * 0.9) return false;
+
+    vector<int32_t> src, dst;
+    src.reserve(a.targets.size()); dst.reserve(a.targets.size());
+    for(int u=0; u<fn; u++){
+        if(up[u] < 0) continue;
+        for(int64_t i=a.offsets[u]; i<a.offsets[u+1]; i++){
+            int cu = up[u], cw = up[a.targets[i]];
+            if(cw < 0 || cu == cw) continue;
+            src.push_back(cu); dst.push_back(cw);
+        }
+    }
+    fine.up.swap(up);
+    Level coarse;
+    coarse.adj = simpleCsr(cn, src, dst);
+    coarse.n = cn;
+    levels.push_back(coarse);
+    return true;
+}
+
+/* --- Make level l current.  Coming from l+1, each vertex starts at its
+   coarse parent's position, spread out by sqrt(n_l / n_l+1) so the finer
+   graph keeps the same spacing, plus a little jitter to split the pairs. --- */
+void ForceLayout::enterLevel(int l, double step){
+    if(l < cur){
+        const Level &fine = levels[l];
+        double scale = sqrt((double)fine.n / n);
+        vector<double> fx(fine.n, 0), fy(fine.n, 0);
+        for(int v=0; v<fine.n; v++){
+            int c = fine.up[v];
+            if(c < 0) continue;
+            fx[v] = px[c] * scale + jitter(2*v) * 0.1 * opt.k;
+            fy[v] = py[c] * scale + jitter(2*v+1) * 0.1 * opt.k;
+        }
+        px.swap(fx); py.swap(fy);
+        int n0 = (int)alive.size();
+        for(int v=0; v<n0; v++){
+            if(!alive[v]) continue;
+            int r = v;
+            for(int m=0; m<l; m++) r = levels[m].up[r];
+            rep[v] = r;
+        }
+        cur = l; n = fine.n;
+    }
+    nx.assign(n, 0); ny.assign(n, 0);
+    stepLen = maxStep = step;
+    lastEnergy = HUGE_VAL; lastMove = HUGE_VAL;
+    progress = 0; levelIter = 0; converged = false;
+}
+
+int ForceLayout::newCell(double x0, double y0, double size){
+    Cell c;
+    c.sx = c.sy = c.mass = 0;
+    c.x0 = x0; c.y0 = y0; c.size = size;
+    c.child[0] = c.child[1] = c.child[2] = c.child[3] = -1;
+    c.body = -1;
+    c.internal = false;
+    cells.push_back(c);
+    return (int)cells.size() - 1;
+}
+
+/* --- Walk down from the root adding b to every cell on its path; a leaf
+   that already holds a body splits and pushes that body one level down --- */
+void ForceLayout::insert(int b){
+    double x = px[b], y = py[b];
+    int c = 0, depth = 0;
+    while(true){
+        cells[c].mass += 1; cells[c].sx += x; cells[c].sy += y;
+        if(!cells[c].internal){
+            if(cells[c].mass == 1){ cells[c].body = b; return; }
+            if(depth >= MAX_DEPTH) return;
+            int old = cells[c].body;
+            cells[c].internal = true; cells[c].body = -1;
+            double half = cells[c].size / 2;
+            int q = (px[old] >= cells[c].x0 + half) | ((py[old] >= cells[c].y0 + half) << 1);
+            int ch = newCell(cells[c].x0 + (q & 1) * half, cells[c].y0 + (q >> 1) * half, half);
+            cells[c].child[q] = ch;
+            cells[ch].mass = 1; cells[ch].sx = px[old]; cells[ch].sy = py[old]; cells[ch].body = old;
+        }
+        double half = cells[c].size / 2;
+        int q = (x >= cells[c].x0 + half) | ((y >= cells[c].y0 + half) << 1);
+        int ch = cells[c].child[q];
+        if(ch < 0){
+            ch = newCell(cells[c].x0 + (q & 1) * half, cells[c].y0 + (q >> 1) * half, half);
+            cells[c].child[q] = ch;
+        }
+        c = ch; depth++;
+    }
+}
+
+void ForceLayout::buildTree(){
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    for(int v=0; v<n; v++){
+        if(!live(v)) continue;
+        minX = min(minX, px[v]); maxX = max(maxX, px[v]);
+        minY = min(minY, py[v]); maxY = max(maxY, py[v]);
+    }
+    cells.clear();
+    order.clear();
+    if(minX > maxX) return;
+    double size = max(maxX - minX, maxY - minY);
+    size = size * 1.0001 + 1e-6;
+    newCell(minX, minY, size);
+
+    /* insert in Morton (Z) order: cells end up stored near their
+       neighbours, and walking vertices in this order keeps consecutive
+       tree traversals on the same paths */
+    vector<uint64_t> keys;
+    keys.reserve(n);
+    double q = 65535.0 / size;
+    for(int v=0; v<n; v++){
+        if(!live(v)) continue;
+        uint32_t ix = (uint32_t)((px[v] - minX) * q), iy = (uint32_t)((py[v] - minY) * q);
+        uint64_t code = 0;
+        for(int b=0; b<16; b++) code |= (uint64_t)(((ix >> b) & 1) | (((iy >> b) & 1) << 1)) << (2*b);
+        keys.push_back(code << 32 | (uint32_t)v);
+    }
+    sort(keys.begin(), keys.end());
+    order.resize(keys.size());
+    for(size_t i=0; i<keys.size(); i++) order[i] = (int)(keys[i] & 0xffffffffu);
+    for(size_t i=0; i<order.size(); i++) insert(order[i]);
+}
+
+/* --- Barnes-Hut sum of k^2/d pushes on v; a cell is opened when it is too
+   close for its size or contains v itself --- */
+void ForceLayout::repulsion(int v, double &fx, double &fy, vector<int> &stack) const {
+    const double k2 = opt.k * opt.k, theta2 = opt.theta * opt.theta;
+    double x = px[v], y = py[v];
+    fx = fy = 0;
+    stack.clear();
+    if(!cells.empty()) stack.push_back(0);
+    while(!stack.empty()){
+        const Cell &c = cells[stack.back()];
+        stack.pop_back();
+        double m = c.mass, sx = c.sx, sy = c.sy;
+        if(!c.internal){
+            if(c.body == v){            // a merged leaf: leave v itself out
+                if(m <= 1) continue;
+                m -= 1; sx -= x; sy -= y;
+            }
+        } else {
+            double cx = sx / m, cy = sy / m;
+            double d2 = (x-cx)*(x-cx) + (y-cy)*(y-cy);
+            bool inside = x >= c.x0 && x < c.x0 + c.size && y >= c.y0 && y < c.y0 + c.size;
+            if(inside || c.size * c.size >= theta2 * d2){
+                for(int q=0; q<4; q++) if(c.child[q] >= 0) stack.push_back(c.child[q]);
+                continue;
+            }
+        }
+        double dx = x - sx / m, dy = y - sy / m;
+        double d2 = dx*dx + dy*dy;
+        if(d2 < 1e-12) continue;
+        double f = k2 * m / d2;
+        fx += dx * f; fy += dy * f;
+    }
+}
+
+bool ForceLayout::step(int iterations, ThreadPool &pool){
+    int workers = pool.size();
+    vector< vector<int> > stacks(workers);
+    vector<double> energy(workers), moved(workers);
+
+    for(int it=0; it<iterations; it++){
+        if(levelDone()){
+            if(cur == 0) break;
+            enterLevel(cur - 1, opt.k * 0.3);
+        }
+        int liveCount = 0;
+        for(int v=0; v<n; v++) liveCount += live(v);
+        buildTree();
+        if(cells.empty()){ converged = true; break; }
+        const CsrGraph &adj = levels[cur].adj;
+        const double cx = cells[0].sx / cells[0].mass, cy = cells[0].sy / cells[0].mass;
+        const double k = opt.k, grav = opt.gravity, len = stepLen;
+        fill(energy.begin(), energy.end(), 0.0);
+        fill(moved.begin(), moved.end(), 0.0);
+
+        for(int v=0; v<n; v++) if(!live(v)){ nx[v] = px[v]; ny[v] = py[v]; }
+        pool.parallelFor(0, (int64_t)order.size(), 256, [&](int64_t lo, int64_t hi, int w){
+            double e = 0, mv = 0;
+            for(int64_t o=lo; o<hi; o++){
+                int v = order[o];
+                double fx, fy;
+                repulsion(v, fx, fy, stacks[w]);
+                for(int64_t i=adj.offsets[v]; i<adj.offsets[v+1]; i++){
+                    int u = adj.targets[i];
+                    double dx = px[u] - px[v], dy = py[u] - py[v];
+                    double d = sqrt(dx*dx + dy*dy);
+                    fx += dx * d / k; fy += dy * d / k;
+                }
+                fx -= grav * (px[v] - cx); fy -= grav * (py[v] - cy);
+                double norm = sqrt(fx*fx + fy*fy);
+                if(norm > 0){
+                    nx[v] = px[v] + len * fx / norm;
+                    ny[v] = py[v] + len * fy / norm;
+                    mv += len;
+                } else { nx[v] = px[v]; ny[v] = py[v]; }
+                e += norm * norm;
+            }
+            energy[w] += e; moved[w] += mv;
+        });
+
+        px.swap(nx); py.swap(ny);
+        double e = 0, mv = 0;
+        for(int w=0; w<workers; w++){ e += energy[w]; mv += moved[w]; }
+        if(cur == 0 && levels.size() > 1){
+            stepLen *= sqrt(opt.cooling);   // the finest level starts well placed: cool steadily
+        } else if(e < lastEnergy){
+            if(++progress >= 5){ progress = 0; stepLen = min(stepLen / opt.cooling, maxStep); }
+        } else {
+            progress = 0; stepLen *= opt.cooling;
+        }
+        lastEnergy = e;
+        lastMove = liveCount ? mv / liveCount : 0;
+        iter++; levelIter++;
+        /* coarse levels only seed the next one, so they stop earlier */
+        double tol = cur > 0 ? opt.tolerance * 5 : opt.tolerance;
+        if(lastMove < tol * opt.k) converged = true;
+    }
+    return !done();
+}
+
+void ForceLayout::fit(int x0, int y0, int x1, int y1, vector< pair<int,int> > &pos) const {
+    int n0 = vertexCount();
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    for(int v=0; v<n0; v++){
+        if(!alive[v]) continue;
+        minX = min(minX, x(v)); maxX = max(maxX, x(v));
+        minY = min(minY, y(v)); maxY = max(maxY, y(v));
+    }
+    if(minX > maxX) return;
+    double w = maxX - minX, h = maxY - minY;
+    double s = min(w > 0 ? (x1 - x0) / w : HUGE_VAL, h > 0 ? (y1 - y0) / h : HUGE_VAL);
+    if(s == HUGE_VAL) s = 1;
+    double ox = x0 + ((x1 - x0) - w * s) / 2, oy = y0 + ((y1 - y0) - h * s) / 2;
+    for(int v=0; v<n0 && v<(int)pos.size(); v++){
+        if(!alive[v]) continue;
+        pos[v].first = (int)lround(ox + (x(v) - minX) * s);
+        pos[v].second = (int)lround(oy + (y(v) - minY) * s);
+    }
+}
@@ -0,0 +1,106 @@
+/* force_layout.h - force-directed auto-layout.
+   Fruchterman-Reingold forces (edges pull with d^2/k, every pair pushes
+   with k^2/d) with Hu's adaptive step length.  All-pairs repulsion is
+   approximated with a Barnes-Hut quadtree rebuilt every iteration, so an
+   iteration is O(n log n); the per-vertex force sums run in parallel on
+   the thread pool.
+
+   The layout is multilevel (Walshaw, Hu): the graph is coarsened by
+   repeatedly merging matched neighbours, the coarsest graph is laid out
+   first and each finer level starts from its coarser parent's position,
+   so large graphs untangle in a few hundred cheap iterations instead of
+   thousands of full-size ones.  step() runs a bounded number of
+   iterations and returns, so the editor can animate the layout a few
+   iterations per frame. */
+#ifndef FORCE_LAYOUT_H
+#define FORCE_LAYOUT_H
+
+#include "graph_core.h"
+#include "parallel.h"
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+struct LayoutOptions {
+    double k;               // natural edge length
+    double theta;           // a cell of side s at distance d acts as one body when s < theta*d (0 = exact)
+    double gravity;         // pull toward the centroid; keeps components from drifting apart
+    double cooling;         // Hu's step factor t: shrink by t on a setback, grow by 1/t after 5 gains
+    double tolerance;       // converged once the mean move falls below tolerance*k
+    int maxIterations;      // per level
+    bool multilevel;
+    int coarsest;           // stop coarsening at this many vertices
+
+    LayoutOptions(): k(80.0), theta(0.9), gravity(0.1), cooling(0.9), tolerance(0.01),
+                     maxIterations(500), multilevel(true), coarsest(64) {}
+};
+
+class ForceLayout {
+public:
+    explicit ForceLayout(const LayoutOptions &opt = LayoutOptions());
+
+    /* start from the current positions of the live nodes; edge direction
+       is ignored and self-loops add no force */
+    void start(const Graph &g);
+    /* start from explicit positions (one per vertex of g) */
+    void start(const CsrView &g, const std::vector<double> &x, const std::vector<double> &y);
+
+    bool step(int iterations, ThreadPool &pool = defaultPool());   // false once the finest level is done
+    bool done() const { return cur == 0 && levelDone(); }
+
+    int    iterations() const { return iter; }          // over all levels
+    int    levelCount() const { return (int)levels.size(); }
+    int    level() const { return cur; }                // 0 = the input graph
+    double meanMove() const { return lastMove; }        // of the last iteration
+    double energy() const { return lastEnergy; }        // sum of squared force magnitudes
+    int    vertexCount() const { return levels.empty() ? 0 : levels[0].n; }
+    /* position of an input vertex: its own once level 0 is reached, before
+       that the position of the coarse vertex it was merged into */
+    double x(int v) const { return rep[v] >= 0 ? px[rep[v]] : 0; }
+    double y(int v) const { return rep[v] >= 0 ? py[rep[v]] : 0; }
+
+    /* live vertices' positions scaled uniformly and centred into the box
+       [x0,x1] x [y0,y1]; entries of dead slots are left alone.
+       pos.size() must be vertexCount(). */
+    void fit(int x0, int y0, int x1, int y1, std::vector< std::pair<int,int> > &pos) const;
+
+private:
+    struct Cell {
+        double sx, sy, mass;        // sums of member positions, member count
+        double x0, y0, size;        // square this cell covers
+        int child[4];               // -1 = none
+        int body;                   // leaf: its (first) vertex; -1 = internal or empty
+        bool internal;
+    };
+
+    struct Level {
+        CsrGraph adj;               // symmetric, loop-free
+        std::vector<int> up;        // vertex -> vertex of the next coarser level
+        int n;
+    };
+
+    LayoutOptions opt;
+    std::vector<Level> levels;      // [0] = the input graph
+    std::vector<char> alive;        // input vertices (dead slots are skipped)
+    std::vector<int> rep;           // input vertex -> vertex of the current level
+    int cur, n;                     // level being refined and its vertex count
+    std::vector<double> px, py, nx, ny;
+    std::vector<Cell> cells;
+    std::vector<int> order;         // live vertices of the current level in Morton order
+    double stepLen, maxStep, lastEnergy, lastMove;
+    int progress, iter, levelIter;
+    bool converged;
+
+    bool levelDone() const { return converged || levelIter >= opt.maxIterations; }
+    bool live(int v) const { return cur > 0 || alive[v]; }
+    void init(const std::vector<int32_t> &src, const std::vector<int32_t> &dst);
+    bool coarsen();
+    void enterLevel(int l, double step);
+    void buildTree();
+    void insert(int b);
+    int  newCell(double x0, double y0, double size);
+    void repulsion(int v, double &fx, double &fy, std::vector<int> &stack) const;
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "generators.h"
+
+using namespace std;
+
+/* --- Bijective id scramble so R-MAT hubs land anywhere --- */
+static uint32_t scramble(uint32_t v, int scale, uint64_t seed){
+    uint64_t mask = (scale >= 32) ? 0xffffffffULL : ((1ULL << scale) - 1);
+    uint64_t x = v;
+    for(int r=0;r<3;r++){
+        x = (x * 0x9E3779B1ULL + (seed >> (r*8))) & mask;   // odd multiplier: bijective mod 2^scale
+        x ^= (x >> (scale/2 + 1));
+    }
+    return (uint32_t)(x & mask);
+}
+
+void generateRmat(int scale, int edgeFactor, uint64_t seed, EdgeList &out){
+    const double a = 0.57, b = 0.19, c = 0.19;
+    int n = 1 << scale;
+    int64_t m = (int64_t)n * edgeFactor;
+    out.n = n;
+    out.src.resize(m); out.dst.resize(m); out.w.clear();
+    SplitMix64 rng(seed);
+    for(int64_t e=0;e<m;e++){
+        uint32_t u = 0, v = 0;
+        for(int bit=0;bit<scale;bit++){
+            double r = rng.uniform();
+            if(r < a) {}
+            else if(r < a+b) v |= 1u << bit;
+            else if(r < a+b+c) u |= 1u << bit;
+            else { u |= 1u << bit; v |= 1u << bit; }
+        }
+        out.src[e] = (int32_t)scramble(u, scale, seed);
+        out.dst[e] = (int32_t)scramble(v, scale, seed);
+    }
+}
+
+void generateErdosRenyi(int n, int64_t m, uint64_t seed, EdgeList &out){
+    out.n = n;
+    out.src.resize(m); out.dst.resize(m); out.w.clear();
+    SplitMix64 rng(seed);
+    for(int64_t e=0;e<m;e++){
+        out.src[e] = (int32_t)rng.below(n);
+        out.dst[e] = (int32_t)rng.below(n);
+    }
+}
+
+void generateGrid(int rows, int cols, EdgeList &out){
+    out.n = rows * cols;
+    out.src.clear(); out.dst.clear(); out.w.clear();
+    out.src.reserve((size_t)2 * out.n); out.dst.reserve((size_t)2 * out.n);
+    for(int r=0;r<rows;r++)
+        for(int c=0;c<cols;c++){
+            int v = r*cols + c;
+            if(c+1 < cols){ out.src.push_back(v); out.dst.push_back(v+1); }
+            if(r+1 < rows){ out.src.push_back(v); out.dst.push_back(v+cols); }
+        }
+}
+
+void generateStar(int n, EdgeList &out){
+    out.n = n;
+    out.src.assign(n > 0 ? n-1 : 0, 0);
+    out.dst.resize(out.src.size());
+    out.w.clear();
+    for(int i=1;i<n;i++) out.dst[i-1] = i;
+}
+
+void assignWeights(EdgeList &el, int maxWeight, uint64_t seed){
+    SplitMix64 rng(seed ^ 0x5EEDULL);
+    el.w.resize(el.src.size());
+    for(size_t i=0;i<el.w.size();i++) el.w[i] = 1 + (int32_t)rng.below(maxWeight);
+}
+
+CsrGraph edgeListToCsr(const EdgeList &el, bool directed, bool weighted){
+    if(directed) return buildCsrFromEdges(el.n, el.src, el.dst, el.w, weighted, true);
+    vector<int32_t> s, d, w;
+    size_t m = el.src.size();
+    s.reserve(2*m); d.reserve(2*m);
+    if(!el.w.empty()) w.reserve(2*m);
+    for(size_t i=0;i<m;i++){
+        s.push_back(el.src[i]); d.push_back(el.dst[i]);
+        if(!el.w.empty()) w.push_back(el.w[i]);
+        if(el.src[i] != el.dst[i]){
+            s.push_back(el.dst[i]); d.push_back(el.src[i]);
+            if(!el.w.empty()) w.push_back(el.w[i]);
+        }
+    }
+    return buildCsrFromEdges(el.n, s, d, w, weighted, false);
+}
+
+void edgeListToGraph(const EdgeList &el, bool directed, bool weighted, Graph &g, int cols){
+    g.clear();
+    g.directed = directed;
+    g.weighted = weighted;
+    if(cols <= 0){ cols = 1; while((int64_t)cols*cols < el.n) cols++; }
+    const int spacing = 60, left = 40, top = 110;
+    for(int i=0;i<el.n;i++) g.addNode(left + spacing*(i % cols), top + spacing*(i / cols));
+    for(size_t i=0;i<el.src.size();i++){
+        int u = el.src[i], v = el.dst[i];
+        if(g.hasEdge(u,v)) continue;
+        g.addEdge(u, v, weighted && !el.w.empty() ? el.w[i] : 1);
+    }
+}
+
+CsrGraph transposeCsr(const CsrView &g){
+    CsrGraph t;
+    t.weighted = g.weighted; t.directed = g.directed;
+    t.offsets.assign(g.n + 1, 0);
+    for(int64_t i=0;i<g.m;i++) t.offsets[g.targets[i] + 1]++;
+    for(int u=0;u<g.n;u++) t.offsets[u+1] += t.offsets[u];
+    t.targets.resize(g.m); t.weights.resize(g.m);
+    vector<int64_t> pos(t.offsets.begin(), t.offsets.end() - 1);
+    for(int u=0;u<g.n;u++)
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int64_t p = pos[g.targets[i]]++;
+            t.targets[p] = u;
+            t.weights[p] = g.weights ? g.weights[i] : 1;
+        }
+    return t;
+}
@@ -0,0 +1,68 @@
+/* generators.h - reproducible synthetic graphs for benchmarks.
+   Every generator is driven by a seeded splitmix64 stream, so the same
+   parameters give the same graph on every platform. */
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include "graph_core.h"
+
+#include <stdint.h>
+#include <vector>
+
+/* --- Deterministic 64-bit RNG (splitmix64) --- */
+class SplitMix64 {
+public:
+    explicit SplitMix64(uint64_t seed): s(seed) {}
+    uint64_t next(){
+        uint64_t z = (s += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+    uint32_t below(uint32_t n){ return (uint32_t)(((next() >> 32) * (uint64_t)n) >> 32); }
+    double uniform(){ return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+private:
+    uint64_t s;
+};
+
+/* --- Edge list: one entry per generated edge (not yet mirrored) --- */
+struct EdgeList {
+    int n;
+    std::vector<int32_t> src, dst, w;
+
+    EdgeList(): n(0) {}
+    int64_t size() const { return (int64_t)src.size(); }
+};
+
+/* R-MAT / Graph500 recursive matrix (a,b,c) = (0.57,0.19,0.19): power-law
+   degrees.  Vertex ids are scrambled so hubs are not clustered at 0. */
+void generateRmat(int scale, int edgeFactor, uint64_t seed, EdgeList &out);
+
+/* G(n, m): m edges with uniformly random endpoints. */
+void generateErdosRenyi(int n, int64_t m, uint64_t seed, EdgeList &out);
+
+/* rows x cols lattice, 4-neighbour: each vertex links right and down.
+   Vertex ids are row-major. */
+void generateGrid(int rows, int cols, EdgeList &out);
+
+/* Star: vertex 0 links to every other vertex. */
+void generateStar(int n, EdgeList &out);
+
+/* Random integer weights in [1, maxWeight] for every edge. */
+void assignWeights(EdgeList &el, int maxWeight, uint64_t seed);
+
+/* CSR from an edge list; undirected graphs get both directions and
+   self-loops are kept once. */
+CsrGraph edgeListToCsr(const EdgeList &el, bool directed, bool weighted);
+
+/* Editable Graph from an edge list, the way the editor would hold it:
+   duplicate edges are dropped, unweighted graphs get weight 1, and node i
+   sits at cell (i % cols, i / cols) of a 60-pixel lattice below the
+   toolbar (cols = 0: square).  Existing contents of g are replaced. */
+void edgeListToGraph(const EdgeList &el, bool directed, bool weighted, Graph &g, int cols = 0);
+
+/* Reverse (incoming-edge) CSR of a directed graph. */
+CsrGraph transposeCsr(const CsrView &g);
+
+#endif
@@ -0,0 +1,403 @@
+#include "graph_core.h"
+
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+/* --- Undirected edges are observed through their lower-endpoint copy --- */
+#define NOTIFY_EDGE(fn,u,v) \
+    do { if(directed || (u)<=(v)) for(size_t i_=0;i_<observers.size();i_++) observers[i_]->fn(*this,u,v); } while(0)
+
+/* --- Utility: int -> string --- */
+static string intToStr(int v) { stringstream ss; ss << v; return ss.str(); }
+
+/* --- Add a node in the most recently freed slot, else a new one; it is
+   labelled with its id --- */
+int Graph::addNode(int x,int y){
+    aboutToChange();
+    int id;
+    if(!freeSlots.empty()){ id = freeSlots.back(); freeSlots.pop_back(); }
+    else { id = (int)nodes.size(); nodes.push_back(Node()); adj.push_back(AdjRow()); radj.push_back(vector<int>()); inPos.push_back(vector<int>()); }
+    Node &n = nodes[id];
+    n.x=x; n.y=y; n.label=intToStr(id); n.visited=false; n.alive=true;
+    nodeCount++;
+    for(size_t i=0;i<observers.size();i++) observers[i]->nodeInserted(*this,id);
+    return id;
+}
+
+void Graph::aboutToChange(){
+    for(size_t i=0;i<observers.size();i++) observers[i]->beforeChange(*this);
+}
+
+void Graph::setFlags(bool d,bool w){
+    aboutToChange();
+    directed = d; weighted = w;
+}
+
+/* --- Single adjacency entries: row, reverse row and index together --- */
+void Graph::linkIn(int u,int k){
+    vector<int> &in = radj[adj[u][k].first];
+    inPos[u][k] = (int)in.size();
+    in.push_back(u);
+}
+
+/* --- O(1): the last member of the reverse row fills the gap, and the entry
+   it stands for (found through the index) learns its new place --- */
+void Graph::unlinkIn(int u,int k){
+    int v = adj[u][k].first, r = inPos[u][k];
+    vector<int> &in = radj[v];
+    int last = (int)in.size()-1;
+    if(r!=last){
+        int u2 = in[last];
+        in[r] = u2;
+        size_t it;
+        for(int p = index.first(u2,v,it); p >= 0; p = index.next(u2,v,it))
+            if(inPos[u2][p]==last){ inPos[u2][p] = r; break; }
+    }
+    in.pop_back();
+}
+
+void Graph::pushEntry(int u,int to,int w){
+    int k = (int)adj[u].size();
+    index.insert(u, to, k);
+    adj[u].push_back(make_pair(to,w));
+    inPos[u].push_back(0);
+    linkIn(u,k);
+}
+
+void Graph::removeEntry(int u,int k){
+    AdjRow &row = adj[u];
+    int last = (int)row.size()-1;
+    unlinkIn(u,k);
+    index.erase(u, row[k].first, k);
+    if(k!=last){ index.move(u, row[last].first, last, k); row[k] = row[last]; inPos[u][k] = inPos[u][last]; }
+    row.pop_back(); inPos[u].pop_back();
+}
+
+void Graph::restoreEntry(int u,int k,int to,int w){
+    AdjRow &row = adj[u];
+    int end = (int)row.size();
+    if(k<end){
+        index.move(u, row[k].first, k, end);
+        row.push_back(row[k]); inPos[u].push_back(inPos[u][k]);
+        row[k] = make_pair(to,w);
+    } else { row.push_back(make_pair(to,w)); inPos[u].push_back(0); }
+    index.insert(u, to, k);
+    linkIn(u,k);
+}
+
+/* --- Position of the mirror of adj[u][k] in adj[v] (same weight preferred
+   among parallel edges), -1 for directed graphs and self-loops --- */
+int Graph::mirrorOf(int u,int k) const {
+    int v = adj[u][k].first, w = adj[u][k].second;
+    if(directed || v==u) return -1;
+    size_t it;
+    int any = -1;
+    for(int p = index.first(v,u,it); p >= 0; p = index.next(v,u,it)){
+        if(adj[v][p].second==w) return p;
+        any = p;
+    }
+    return any;
+}
+
+/* --- Insert an edge (and its mirror for undirected graphs) --- */
+void Graph::addEdge(int u,int v,int w){
+    aboutToChange();
+    pushEntry(u,v,w);
+    if(!directed && u!=v) pushEntry(v,u,w);
+    if(directed || u<=v) NOTIFY_EDGE(edgeAdded,u,v); else NOTIFY_EDGE(edgeAdded,v,u);
+}
+
+int Graph::edgeWeight(int u,int v,int missing) const {
+    int k = index.find(u,v);
+    return k>=0 ? adj[u][k].second : missing;
+}
+
+bool Graph::setEdgeWeight(int u,int v,int w){
+    aboutToChange();
+    int k = index.find(u,v);
+    if(k<0) return false;
+    int m = mirrorOf(u,k);
+    adj[u][k].second = w;
+    if(m>=0) adj[v][m].second = w;
+    if(directed || u<=v) NOTIFY_EDGE(edgeWeightChanged,u,v); else NOTIFY_EDGE(edgeWeightChanged,v,u);
+    return true;
+}
+
+/* --- Tombstone a node: only the rows that point at it (found through radj)
+   are filtered, nothing is renumbered.  Entries dropped from other rows are
+   appended to `removed` (if given) in ascending (row, position) order so
+   restoreNode can put them back. --- */
+void Graph::deleteNode(int id, vector<RemovedEdge> *removed){
+    aboutToChange();
+    vector<int> rows = radj[id];
+    sort(rows.begin(), rows.end());
+    rows.erase(unique(rows.begin(), rows.end()), rows.end());
+    for(int k=0;k<(int)rows.size();k++){
+        int i = rows[k];
+        if(i==id) continue;
+        AdjRow &row = adj[i];
+        vector<int> &ip = inPos[i];
+        int out=0;
+        for(int j=0;j<(int)row.size();j++){
+            if(row[j].first==id){
+                if(removed){
+                    RemovedEdge r; r.from=i; r.pos=j; r.to=id; r.weight=row[j].second;
+                    removed->push_back(r);
+                }
+                index.erase(i, id, j);
+                continue;
+            }
+            if(out!=j) index.move(i, row[j].first, j, out);
+            ip[out] = ip[j];
+            row[out++]=row[j];
+        }
+        row.resize(out); ip.resize(out);
+    }
+    /* own row: reverse links first (they look entries up in the index) */
+    for(int j=0;j<(int)adj[id].size();j++) if(adj[id][j].first!=id) unlinkIn(id,j);
+    for(int j=0;j<(int)adj[id].size();j++) index.erase(id, adj[id][j].first, j);
+    AdjRow().swap(adj[id]);
+    vector<int>().swap(inPos[id]);
+    vector<int>().swap(radj[id]);
+    nodes[id].alive=false; nodes[id].visited=false; nodes[id].gen++;
+    freeSlots.push_back(id);
+    nodeCount--;
+    for(size_t i=0;i<observers.size();i++) observers[i]->nodeRemoved(*this,id);
+}
+
+void Graph::deleteEdge(int u,int k, int *mirrorPos){
+    aboutToChange();
+    int v = adj[u][k].first;
+    int m = mirrorOf(u,k);
+    removeEntry(u,k);
+    if(m>=0) removeEntry(v,m);
+    if(mirrorPos) *mirrorPos = m;
+    if(directed || u<=v) NOTIFY_EDGE(edgeRemoved,u,v); else NOTIFY_EDGE(edgeRemoved,v,u);
+}
+
+void Graph::moveNode(int id,int x,int y){
+    nodes[id].x=x; nodes[id].y=y;
+    for(size_t i=0;i<observers.size();i++) observers[i]->nodeMoved(*this,id);
+}
+
+void Graph::swapPositions(vector< pair<int,int> > &pos){
+    for(size_t i=0;i<nodes.size() && i<pos.size();i++){
+        swap(nodes[i].x, pos[i].first);
+        swap(nodes[i].y, pos[i].second);
+    }
+    for(size_t i=0;i<observers.size();i++) observers[i]->graphReset(*this);
+}
+
+void Graph::clear(){
+    aboutToChange();
+    nodes.clear(); adj.clear(); radj.clear(); inPos.clear(); freeSlots.clear(); index.clear(); nodeCount=0; epoch++;
+    for(size_t i=0;i<observers.size();i++) observers[i]->graphReset(*this);
+}
+
+/* --- Reverse rows, index, free list and live count follow from nodes/adj;
+   the free list hands out the lowest tombstone first --- */
+void Graph::rebuildDerived(){
+    int n = (int)nodes.size();
+    adj.resize(n);
+    radj.assign(n, vector<int>());
+    inPos.resize(n);
+    freeSlots.clear();
+    nodeCount = 0;
+    size_t entries = 0;
+    for(int u=0;u<n;u++) entries += adj[u].size();
+    index.clear();
+    index.reserve(entries);
+    for(int u=n-1;u>=0;u--){
+        if(nodes[u].alive) nodeCount++; else freeSlots.push_back(u);
+        inPos[u].assign(adj[u].size(), 0);
+        for(int j=0;j<(int)adj[u].size();j++){ linkIn(u,j); index.insert(u, adj[u][j].first, j); }
+    }
+}
+
+/* --- Grow every per-node array and the edge index once, not per insert --- */
+void Graph::reserve(int moreNodes, int64_t moreEntries){
+    aboutToChange();
+    size_t n = nodes.size() + (moreNodes > 0 ? moreNodes : 0);
+    nodes.reserve(n); adj.reserve(n); radj.reserve(n); inPos.reserve(n);
+    if(moreEntries > 0) index.reserve(index.size() + (size_t)moreEntries);
+}
+
+void Graph::swapContents(vector<Node> &n, AdjList &a){
+    aboutToChange();
+    nodes.swap(n); adj.swap(a);
+    epoch++;
+    rebuildDerived();
+    for(size_t i=0;i<observers.size();i++) observers[i]->graphReset(*this);
+}
+
+void Graph::addObserver(GraphObserver *o){ observers.push_back(o); }
+
+void Graph::removeObserver(GraphObserver *o){
+    observers.erase(remove(observers.begin(), observers.end(), o), observers.end());
+}
+
+/* --- Compaction --- */
+bool Graph::wantsCompaction(int minDead, int percent) const {
+    int dead = (int)freeSlots.size();
+    return dead >= minDead && (int64_t)dead*100 >= (int64_t)nodes.size()*percent;
+}
+
+/* --- One sweep: slot i moves down to remap[i] <= i, so the arrays are
+   packed in place and every target rewritten through the map --- */
+void Graph::compact(vector<int> &remap, vector<Node> *dead){
+    aboutToChange();
+    int n = (int)nodes.size(), k = 0;
+    remap.assign(n, -1);
+    for(int i=0;i<n;i++) if(nodes[i].alive) remap[i] = k++;
+    for(int i=0;i<n;i++){
+        int to = remap[i];
+        if(to<0){ if(dead) dead->push_back(nodes[i]); continue; }
+        if(to!=i){ nodes[to] = nodes[i]; adj[to].swap(adj[i]); }
+        AdjRow &row = adj[to];
+        for(int j=0;j<(int)row.size();j++) row[j].first = remap[row[j].first];
+    }
+    nodes.resize(k); adj.resize(k);
+    epoch++;
+    rebuildDerived();
+    for(size_t i=0;i<observers.size();i++) observers[i]->graphReset(*this);
+}
+
+/* --- Inverse of compact(): walking down from the top, every live node moves
+   back up to its old slot and the tombstones refill the gaps --- */
+void Graph::uncompact(const vector<int> &remap, const vector<Node> &dead){
+    aboutToChange();
+    int n = (int)remap.size(), k = (int)nodes.size();
+    vector<int> inv(k);
+    for(int i=0;i<n;i++) if(remap[i]>=0) inv[remap[i]] = i;
+    nodes.resize(n); adj.resize(n);
+    int d = (int)dead.size();
+    for(int i=n-1;i>=0;i--){
+        int from = remap[i];
+        if(from<0){ nodes[i] = dead[--d]; AdjRow().swap(adj[i]); continue; }
+        if(from!=i){ nodes[i] = nodes[from]; adj[i].swap(adj[from]); }
+        AdjRow &row = adj[i];
+        for(int j=0;j<(int)row.size();j++) row[j].first = inv[row[j].first];
+    }
+    epoch++;
+    rebuildDerived();
+    for(size_t i=0;i<observers.size();i++) observers[i]->graphReset(*this);
+}
+
+/* --- Every slot to its new id; targets rewritten through the same map --- */
+void Graph::permute(const vector<int> &perm){
+    aboutToChange();
+    int n = (int)nodes.size();
+    vector<Node> nn(n);
+    AdjList na(n);
+    for(int i=0;i<n;i++){
+        int to = perm[i];
+        swap(nn[to], nodes[i]);
+        na[to].swap(adj[i]);
+        AdjRow &row = na[to];
+        for(int j=0;j<(int)row.size();j++) row[j].first = perm[row[j].first];
+    }
+    nodes.swap(nn); adj.swap(na);
+    epoch++;
+    rebuildDerived();
+    for(size_t i=0;i<observers.size();i++) observers[i]->graphReset(*this);
+}
+
+/* --- Inverse operations (undo/redo) --- */
+void Graph::unaddEdge(int u,int v){
+    aboutToChange();
+    if(!directed && u!=v) removeEntry(v, (int)adj[v].size()-1);
+    removeEntry(u, (int)adj[u].size()-1);
+    if(directed || u<=v) NOTIFY_EDGE(edgeRemoved,u,v); else NOTIFY_EDGE(edgeRemoved,v,u);
+}
+
+void Graph::reinsertEdge(int u,int k,int to,int w,int mirrorPos){
+    aboutToChange();
+    if(mirrorPos>=0) restoreEntry(to, mirrorPos, u, w);
+    restoreEntry(u, k, to, w);
+    if(directed || u<=to) NOTIFY_EDGE(edgeAdded,u,to); else NOTIFY_EDGE(edgeAdded,to,u);
+}
+
+/* --- Undo deleteNode (or redo addNode with an empty row): reoccupy slot
+   `id`, which must be a tombstone, and reinsert its edges --- */
+void Graph::restoreNode(int id, const Node &n, const AdjRow &row, const vector<RemovedEdge> &removed){
+    aboutToChange();
+    for(int i=(int)freeSlots.size()-1;i>=0;i--)
+        if(freeSlots[i]==id){ freeSlots.erase(freeSlots.begin()+i); break; }
+    nodes[id] = n;
+    nodes[id].alive = true;
+    nodeCount++;
+    adj[id] = row;
+    inPos[id].assign(row.size(), 0);
+    for(int j=0;j<(int)row.size();j++){ linkIn(id,j); index.insert(id,row[j].first,j); }
+    /* `removed` is grouped by row: unindex each row, reinsert, index it again */
+    for(int i=0;i<(int)removed.size();){
+        int from = removed[i].from, end = i;
+        while(end<(int)removed.size() && removed[end].from==from) end++;
+        AdjRow &r = adj[from];
+        for(int j=0;j<(int)r.size();j++) index.erase(from, r[j].first, j);
+        for(int q=i;q<end;q++){
+            r.insert(r.begin()+removed[q].pos, make_pair(removed[q].to,removed[q].weight));
+            inPos[from].insert(inPos[from].begin()+removed[q].pos, 0);
+        }
+        for(int j=0;j<(int)r.size();j++) index.insert(from, r[j].first, j);
+        for(;i<end;i++) linkIn(from, removed[i].pos);
+    }
+    for(size_t i=0;i<observers.size();i++) observers[i]->nodeInserted(*this,id);
+    for(int j=0;j<(int)row.size();j++) NOTIFY_EDGE(edgeAdded,id,row[j].first);
+    for(int i=0;i<(int)removed.size();i++) NOTIFY_EDGE(edgeAdded,removed[i].from,id);
+}
+
+/* --- CSR --- */
+CsrView CsrGraph::view() const {
+    CsrView v;
+    v.n = vertexCount();
+    v.m = edgeCount();
+    v.offsets = offsets.empty() ? 0 : &offsets[0];
+    v.targets = targets.empty() ? 0 : &targets[0];
+    v.weights = weights.empty() ? 0 : &weights[0];
+    v.weighted = weighted;
+    v.directed = directed;
+    return v;
+}
+
+/* --- Freeze the adjacency lists into contiguous arrays (order preserved) --- */
+CsrGraph buildCsr(const Graph &g){
+    CsrGraph c;
+    c.weighted = g.weighted;
+    c.directed = g.directed;
+    int n = g.vertexCount();
+    c.offsets.assign(n+1, 0);
+    for(int u=0;u<n;u++) c.offsets[u+1] = c.offsets[u] + g.degree(u);
+    c.targets.resize(c.offsets[n]);
+    c.weights.resize(c.offsets[n]);
+    for(int u=0;u<n;u++){
+        int64_t base = c.offsets[u];
+        for(int i=0;i<g.degree(u);i++){
+            c.targets[base+i] = g.target(u,i);
+            c.weights[base+i] = g.weight(u,i);
+        }
+    }
+    return c;
+}
+
+CsrGraph buildCsrFromEdges(int n, const vector<int32_t> &src, const vector<int32_t> &dst,
+                           const vector<int32_t> &w, bool weighted, bool directed){
+    CsrGraph c;
+    c.weighted = weighted;
+    c.directed = directed;
+    size_t m = src.size();
+    c.offsets.assign(n+1, 0);
+    for(size_t i=0;i<m;i++) c.offsets[src[i]+1]++;
+    for(int u=0;u<n;u++) c.offsets[u+1] += c.offsets[u];
+    c.targets.resize(m);
+    c.weights.resize(m);
+    vector<int64_t> pos(c.offsets.begin(), c.offsets.end()-1);
+    for(size_t i=0;i<m;i++){
+        int64_t p = pos[src[i]]++;
+        c.targets[p] = dst[i];
+        c.weights[p] = w.empty() ? 1 : w[i];
+    }
+    return c;
+}
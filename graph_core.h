@@ -0,0 +1,197 @@
+/* graph_core.h - headless graph model (no graphics dependency).
+   Holds the node/adjacency data the editor works on, the edit operations
+   it performs, and a frozen compressed-sparse-row (CSR) view for running
+   algorithms on large graphs.
+
+   Node ids are stable slots: deleting a node leaves a tombstone (alive ==
+   false, empty row) and puts the slot on a free list for the next addNode,
+   so no other id changes.  compact() renumbers the live nodes densely in
+   one sweep once tombstones pile up.
+
+   Every adjacency entry is also kept in a hashed (u,v) index, so edge
+   lookups never scan a row.  Removing one entry moves the row's last entry
+   into its place (O(1)); undo puts both back exactly. */
+#ifndef GRAPH_CORE_H
+#define GRAPH_CORE_H
+
+#include "edge_index.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+/* --- Basic node type --- */
+struct Node {
+    int x, y;
+    std::string label;
+    bool visited;
+    bool alive;             // false: tombstone of a deleted node
+    unsigned gen;           // bumped each time the slot is freed (see NodeRef)
+
+    Node(): x(0), y(0), visited(false), alive(true), gen(0) {}
+};
+
+/* --- A node id plus the generation it was taken at; resolves to -1 once
+   the node is deleted (even if its slot is reused) or the ids are renumbered --- */
+struct NodeRef {
+    int id;
+    unsigned gen, epoch;
+};
+
+typedef std::vector< std::pair<int,int> > AdjRow;   // (to, weight)
+typedef std::vector< AdjRow > AdjList;
+
+/* --- An adjacency entry removed by deleteNode, in original numbering --- */
+struct RemovedEdge {
+    int from, pos;      // row and position the entry occupied (before removal)
+    int to, weight;
+};
+
+class Graph;
+
+/* --- Change notifications for structures derived from a Graph ---
+   An undirected edge is reported once, as the copy kept in its lower
+   endpoint's row (u <= v) - the copy the editor draws.  Callbacks run
+   after the graph has been updated, except beforeChange: it runs first,
+   before anything a CSR is built from (slots, rows, flags; not positions)
+   changes, so an observer can hold an edit while another thread reads. */
+class GraphObserver {
+public:
+    virtual ~GraphObserver() {}
+    virtual void nodeInserted(const Graph &g,int id) = 0;      // slot id (re)occupied
+    virtual void nodeRemoved(const Graph &g,int id) = 0;       // slot id is now a tombstone
+    virtual void nodeMoved(const Graph &g,int id) = 0;
+    virtual void edgeAdded(const Graph &g,int u,int v) = 0;
+    virtual void edgeRemoved(const Graph &g,int u,int v) = 0;
+    virtual void graphReset(const Graph &g) = 0;               // contents replaced or renumbered
+    virtual void edgeWeightChanged(const Graph &,int,int) {}   // ids as edgeAdded gives them
+    virtual void beforeChange(const Graph &) {}
+};
+
+/* --- Editable graph: node slots + adjacency lists (+ reverse rows) --- */
+class Graph {
+public:
+    std::vector<Node> nodes;                    // one per slot, tombstones included
+    AdjList adj;                                // empty for tombstones
+    std::vector< std::vector<int> > radj;       // radj[v]: u for every entry u -> v in adj[u]
+    std::vector< std::vector<int> > inPos;      // inPos[u][k]: where u sits in radj[adj[u][k].first]
+    std::vector<int> freeSlots;                 // tombstones, reused last-in first-out
+    EdgeIndex index;                            // (u,v) -> position in adj[u], per entry
+    int nodeCount;                              // live nodes
+    unsigned epoch;                             // bumped whenever ids are renumbered/replaced
+    bool weighted, directed;
+    std::vector<GraphObserver*> observers;
+
+    static const int COMPACT_MIN_DEAD = 64;     // wantsCompaction() defaults
+    static const int COMPACT_PERCENT = 25;
+
+    Graph(): nodeCount(0), epoch(0), weighted(false), directed(false) {}
+
+    int  addNode(int x,int y);                 // returns the new node id (a free slot if any)
+    void addEdge(int u,int v,int w);           // mirrors (v,u) when undirected
+    bool hasSelfLoop(int u) const { return index.find(u,u) >= 0; }
+    void deleteNode(int id, std::vector<RemovedEdge> *removed = 0); // O(degree); other ids unchanged
+    /* removes adj[u][k] and, in undirected graphs, its mirror in adj[v]
+       (whose position is stored in *mirrorPos, -1 if none) */
+    void deleteEdge(int u,int k, int *mirrorPos = 0);
+    void moveNode(int id,int x,int y);
+    /* exchanges every slot's (x,y) with pos[slot] (pos.size() == slotCount());
+       observers see one graphReset instead of a move per node */
+    void swapPositions(std::vector< std::pair<int,int> > &pos);
+    void clear();
+    void reserve(int moreNodes, int64_t moreEntries);      // capacity ahead of a bulk build
+    void swapContents(std::vector<Node> &n, AdjList &a);   // O(1) exchange, used by clear/undo
+    void setFlags(bool directed, bool weighted);            // observers see the next graphReset
+
+    /* O(1) expected edge queries through the index */
+    int  findEdge(int u,int v) const { return index.find(u,v); }           // position in adj[u] or -1
+    bool hasEdge(int u,int v) const { return index.find(u,v) >= 0; }
+    int  edgeWeight(int u,int v,int missing = -1) const;
+    bool setEdgeWeight(int u,int v,int w);     // both directions when undirected; edgeWeightChanged
+    size_t indexBytes() const { return index.memoryBytes(); }
+
+    bool isAlive(int id) const { return id>=0 && id<(int)nodes.size() && nodes[id].alive; }
+    int  slotCount() const { return (int)nodes.size(); }
+    NodeRef ref(int id) const { NodeRef r; r.id = id; r.gen = nodes[id].gen; r.epoch = epoch; return r; }
+    int  resolve(const NodeRef &r) const { return r.epoch==epoch && isAlive(r.id) && nodes[r.id].gen==r.gen ? r.id : -1; }
+
+    /* compaction: renumber live nodes 0..nodeCount-1 in id order.  remap[old]
+       is the new id or -1; the tombstones are appended to `dead` (if given)
+       so uncompact() can put them back. */
+    bool wantsCompaction(int minDead = COMPACT_MIN_DEAD, int percent = COMPACT_PERCENT) const;
+    void compact(std::vector<int> &remap, std::vector<Node> *dead = 0);
+    void uncompact(const std::vector<int> &remap, const std::vector<Node> &dead);
+
+    /* renumbering by a vertex ordering (reorder.h): slot i, tombstones
+       included, moves to perm[i]; rows keep their order */
+    void permute(const std::vector<int> &perm);
+
+    /* inverse operations used by undo/redo */
+    void unaddEdge(int u,int v);               // pops the entries addEdge(u,v,..) appended
+    void reinsertEdge(int u,int k,int to,int w,int mirrorPos);   // undoes deleteEdge
+    void restoreNode(int id, const Node &n, const AdjRow &row, const std::vector<RemovedEdge> &removed);
+
+    void addObserver(GraphObserver *o);
+    void removeObserver(GraphObserver *o);
+
+    /* uniform accessors shared with CsrView (see traversal.h); tombstones
+       are isolated vertices */
+    int vertexCount() const { return (int)nodes.size(); }
+    int degree(int u) const { return (int)adj[u].size(); }
+    int target(int u,int i) const { return adj[u][i].first; }
+    int weight(int u,int i) const { return adj[u][i].second; }
+
+private:
+    void linkIn(int u,int k);                  // entry adj[u][k] -> its reverse row
+    void unlinkIn(int u,int k);
+    void pushEntry(int u,int to,int w);
+    void removeEntry(int u,int k);             // last entry moves to k
+    void restoreEntry(int u,int k,int to,int w);   // inverse of removeEntry
+    int  mirrorOf(int u,int k) const;
+    void rebuildDerived();                     // radj, inPos, index, freeSlots, nodeCount from nodes/adj
+    void aboutToChange();                      // observers' beforeChange
+};
+
+/* --- Read-only CSR view: contiguous offsets/targets/weights ---
+   Edges of u are targets[offsets[u] .. offsets[u+1]).  The view does not
+   own its arrays, so it is cheap to copy and pass to worker threads. */
+struct CsrView {
+    int n;
+    int64_t m;
+    const int64_t *offsets;   // n+1 entries
+    const int32_t *targets;   // m entries
+    const int32_t *weights;   // m entries, or 0 (every weight is 1)
+    bool weighted, directed;
+
+    CsrView(): n(0), m(0), offsets(0), targets(0), weights(0), weighted(false), directed(false) {}
+
+    int vertexCount() const { return n; }
+    int degree(int u) const { return (int)(offsets[u+1] - offsets[u]); }
+    int target(int u,int i) const { return targets[offsets[u] + i]; }
+    int weight(int u,int i) const { return weights ? weights[offsets[u] + i] : 1; }
+};
+
+/* --- Owning CSR storage, frozen from a Graph or built from an edge list --- */
+class CsrGraph {
+public:
+    std::vector<int64_t> offsets;
+    std::vector<int32_t> targets;
+    std::vector<int32_t> weights;
+    bool weighted, directed;
+
+    CsrGraph(): weighted(false), directed(false) { offsets.push_back(0); }
+
+    int vertexCount() const { return (int)offsets.size() - 1; }
+    int64_t edgeCount() const { return (int64_t)targets.size(); }
+    CsrView view() const;
+};
+
+CsrGraph buildCsr(const Graph &g);
+
+/* Builds a CSR from parallel (src, dst, weight) arrays with a counting
+   sort by source; each undirected edge must already be listed both ways. */
+CsrGraph buildCsrFromEdges(int n, const std::vector<int32_t> &src, const std::vector<int32_t> &dst,
+                           const std::vector<int32_t> &w, bool weighted, bool directed);
+
+#endif
@@ -0,0 +1,549 @@
+#include "graph_io.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+static const char GVG_MAGIC[8] = { 'G','V','G','R','A','P','H','\0' };
+static const uint32_t GVG_ENDIAN = 0x01020304u;
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static bool fail(string *err, const string &msg){
+    if(err) *err = msg;
+    return false;
+}
+
+static uint64_t align8(uint64_t v){ return (v + 7) & ~(uint64_t)7; }
+
+/* pos + bytes <= length, without overflowing on a corrupt header */
+static bool within(uint64_t pos, uint64_t bytes, uint64_t length){ return pos <= length && bytes <= length - pos; }
+
+/* --- Utility: int -> string (no stringstream) --- */
+static string intToStr(int64_t v){
+    char tmp[24]; int len = 0;
+    bool neg = v < 0;
+    uint64_t u = neg ? (uint64_t)(-(v+1)) + 1 : (uint64_t)v;
+    do { tmp[len++] = (char)('0' + u % 10); u /= 10; } while(u);
+    string s;
+    if(neg) s.push_back('-');
+    while(len) s.push_back(tmp[--len]);
+    return s;
+}
+
+/* ===================== binary ===================== */
+
+static bool writeAll(FILE *f, const void *p, size_t bytes){
+    return bytes == 0 || fwrite(p, 1, bytes, f) == bytes;
+}
+
+static bool padTo(FILE *f, uint64_t &at, uint64_t target){
+    static const char zeros[8] = {0,0,0,0,0,0,0,0};
+    while(at < target){
+        size_t k = (size_t)min<uint64_t>(8, target - at);
+        if(!writeAll(f, zeros, k)) return false;
+        at += k;
+    }
+    return true;
+}
+
+bool saveBinary(const char *path, const CsrView &g, const vector<Node> *nodes, IoStats *stats, string *err){
+    double t0 = nowSec();
+    bool withNodes = nodes && (int)nodes->size() == g.n;
+    bool weighted = g.weighted && g.weights;
+
+    GvgHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, GVG_MAGIC, 8);
+    h.version = GVG_VERSION;
+    h.endian = GVG_ENDIAN;
+    h.flags = (g.directed ? GVG_DIRECTED : 0) | (weighted ? GVG_WEIGHTED : 0) | (withNodes ? GVG_COORDS | GVG_LABELS : 0);
+    h.n = (uint64_t)g.n;
+    h.m = (uint64_t)g.m;
+
+    vector<uint32_t> labelIndex;
+    string labelChars;
+    if(withNodes){
+        labelIndex.reserve(g.n + 1);
+        for(int i=0;i<g.n;i++){ labelIndex.push_back((uint32_t)labelChars.size()); labelChars += (*nodes)[i].label; }
+        labelIndex.push_back((uint32_t)labelChars.size());
+    }
+
+    uint64_t at = align8(sizeof(GvgHeader));
+    h.offsetsPos = at;   at = align8(at + 8ull*(h.n + 1));
+    h.targetsPos = at;   at = align8(at + 4ull*h.m);
+    if(weighted){ h.weightsPos = at; at = align8(at + 4ull*h.m); }
+    if(withNodes){
+        h.coordsPos = at;     at = align8(at + 8ull*h.n);
+        h.labelIndexPos = at; at = align8(at + 4ull*(h.n + 1));
+        h.labelCharsPos = at; at = align8(at + labelChars.size());
+    }
+    h.fileSize = at;
+
+    FILE *f = fopen(path, "wb");
+    if(!f) return fail(err, string("cannot create ") + path);
+    uint64_t pos = 0;
+    bool ok = writeAll(f, &h, sizeof(h)); pos += sizeof(h);
+    ok = ok && padTo(f, pos, h.offsetsPos) && writeAll(f, g.offsets, 8ull*(h.n + 1)); pos += 8ull*(h.n + 1);
+    ok = ok && padTo(f, pos, h.targetsPos) && writeAll(f, g.targets, 4ull*h.m); pos += 4ull*h.m;
+    if(weighted){ ok = ok && padTo(f, pos, h.weightsPos) && writeAll(f, g.weights, 4ull*h.m); pos += 4ull*h.m; }
+    if(withNodes){
+        vector<int32_t> xy(2*(size_t)g.n);
+        for(int i=0;i<g.n;i++){ xy[2*i] = (*nodes)[i].x; xy[2*i+1] = (*nodes)[i].y; }
+        ok = ok && padTo(f, pos, h.coordsPos) && writeAll(f, xy.empty() ? 0 : &xy[0], 8ull*h.n); pos += 8ull*h.n;
+        ok = ok && padTo(f, pos, h.labelIndexPos) && writeAll(f, &labelIndex[0], 4ull*(h.n + 1)); pos += 4ull*(h.n + 1);
+        ok = ok && padTo(f, pos, h.labelCharsPos) && writeAll(f, labelChars.data(), labelChars.size()); pos += labelChars.size();
+    }
+    ok = ok && padTo(f, pos, h.fileSize);
+    ok = (fclose(f) == 0) && ok;
+    if(!ok) return fail(err, string("write failed: ") + path);
+
+    if(stats){ stats->edges = g.m; stats->bytes = (int64_t)h.fileSize; stats->seconds = nowSec() - t0; }
+    return true;
+}
+
+MappedGraph::MappedGraph(): base(0), length(0), coords(0), labelIndex(0), labelChars(0)
+#ifdef _WIN32
+    , fileHandle(0), mapHandle(0)
+#else
+    , fd(-1)
+#endif
+{}
+
+MappedGraph::~MappedGraph(){ close(); }
+
+void MappedGraph::close(){
+#ifdef _WIN32
+    if(base) UnmapViewOfFile(base);
+    if(mapHandle) CloseHandle((HANDLE)mapHandle);
+    if(fileHandle) CloseHandle((HANDLE)fileHandle);
+    mapHandle = fileHandle = 0;
+#else
+    if(base) munmap((void*)base, length);
+    if(fd >= 0) ::close(fd);
+    fd = -1;
+#endif
+    base = 0; length = 0;
+    csr = CsrView();
+    coords = 0; labelIndex = 0; labelChars = 0;
+}
+
+/* --- Map the file and point the view at its sections; only the header
+   and section bounds are checked here, validate() checks the arrays --- */
+bool MappedGraph::open(const char *path, IoStats *stats, string *err){
+    close();
+    double t0 = nowSec();
+#ifdef _WIN32
+    HANDLE fh = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if(fh == INVALID_HANDLE_VALUE) return fail(err, string("cannot open ") + path);
+    fileHandle = fh;
+    LARGE_INTEGER sz;
+    if(!GetFileSizeEx(fh, &sz)){ close(); return fail(err, "cannot stat file"); }
+    length = (uint64_t)sz.QuadPart;
+    if(length < sizeof(GvgHeader)){ close(); return fail(err, "file too small"); }
+    mapHandle = CreateFileMappingA(fh, 0, PAGE_READONLY, 0, 0, 0);
+    if(!mapHandle){ close(); return fail(err, "CreateFileMapping failed"); }
+    base = (const char*)MapViewOfFile((HANDLE)mapHandle, FILE_MAP_READ, 0, 0, 0);
+    if(!base){ close(); return fail(err, "MapViewOfFile failed"); }
+#else
+    fd = ::open(path, O_RDONLY);
+    if(fd < 0) return fail(err, string("cannot open ") + path);
+    struct stat st;
+    if(fstat(fd, &st) != 0){ close(); return fail(err, "cannot stat file"); }
+    length = (uint64_t)st.st_size;
+    if(length < sizeof(GvgHeader)){ close(); return fail(err, "file too small"); }
+    void *p = mmap(0, length, PROT_READ, MAP_SHARED, fd, 0);
+    if(p == MAP_FAILED){ close(); return fail(err, "mmap failed"); }
+    base = (const char*)p;
+#endif
+
+    const GvgHeader &h = *(const GvgHeader*)base;
+    if(memcmp(h.magic, GVG_MAGIC, 8) != 0){ close(); return fail(err, "not a .gvg file"); }
+    if(h.endian != GVG_ENDIAN){ close(); return fail(err, "byte order mismatch"); }
+    if(h.version != GVG_VERSION){ close(); return fail(err, "unsupported .gvg version " + intToStr(h.version)); }
+    if(h.n > 0x7fffffffull || h.m > length || h.fileSize > length) { close(); return fail(err, "corrupt header"); }
+    bool weighted = (h.flags & GVG_WEIGHTED) != 0;
+    bool ok = within(h.offsetsPos, 8*(h.n+1), length) && within(h.targetsPos, 4*h.m, length)
+           && (!weighted || within(h.weightsPos, 4*h.m, length))
+           && (!(h.flags & GVG_COORDS) || within(h.coordsPos, 8*h.n, length))
+           && (!(h.flags & GVG_LABELS) || within(h.labelIndexPos, 4*(h.n+1), length))
+           && (h.offsetsPos % 8) == 0;
+    if(!ok){ close(); return fail(err, "section out of bounds"); }
+
+    csr.n = (int)h.n;
+    csr.m = (int64_t)h.m;
+    csr.offsets = (const int64_t*)(base + h.offsetsPos);
+    csr.targets = (const int32_t*)(base + h.targetsPos);
+    csr.weights = weighted ? (const int32_t*)(base + h.weightsPos) : 0;
+    csr.weighted = weighted;
+    csr.directed = (h.flags & GVG_DIRECTED) != 0;
+    if(csr.offsets[h.n] != (int64_t)h.m){ close(); return fail(err, "offsets do not match edge count"); }
+    if(h.flags & GVG_COORDS) coords = (const int32_t*)(base + h.coordsPos);
+    if(h.flags & GVG_LABELS){
+        labelIndex = (const uint32_t*)(base + h.labelIndexPos);
+        labelChars = base + h.labelCharsPos;
+        if(!within(h.labelCharsPos, labelIndex[h.n], length)){ close(); return fail(err, "labels out of bounds"); }
+    }
+
+    if(stats){ stats->edges = csr.m; stats->bytes = (int64_t)length; stats->seconds = nowSec() - t0; }
+    return true;
+}
+
+/* --- Every offset and target, in one pass: rows must not run backwards
+   or past m, and targets must name a vertex --- */
+static bool checkCsr(const CsrView &c, string *err){
+    if(c.offsets[0] < 0) return fail(err, "corrupt offsets");
+    for(int v=0;v<c.n;v++)
+        if(c.offsets[v+1] < c.offsets[v] || c.offsets[v+1] > c.m) return fail(err, "corrupt offsets at vertex " + intToStr(v));
+    for(int64_t k=c.offsets[0]; k<c.m; k++)
+        if(c.targets[k] < 0 || c.targets[k] >= c.n) return fail(err, "edge target out of range at entry " + intToStr(k));
+    return true;
+}
+
+/* --- The arrays as checkCsr does, then the label index --- */
+bool MappedGraph::validate(string *err) const {
+    if(!base) return fail(err, "no file open");
+    if(!checkCsr(csr, err)) return false;
+    if(labelIndex)
+        for(int v=0;v<csr.n;v++)
+            if(labelIndex[v+1] < labelIndex[v]) return fail(err, "corrupt label index at vertex " + intToStr(v));
+    return true;
+}
+
+string MappedGraph::label(int v) const {
+    if(!labelIndex) return intToStr(v);
+    return string(labelChars + labelIndex[v], labelChars + labelIndex[v+1]);
+}
+
+/* ===================== text ===================== */
+
+/* --- Fixed-buffer line reader: lines are returned in place, never copied --- */
+class LineReader {
+public:
+    explicit LineReader(FILE *file): f(file), buf(1 << 20), start(0), end(0), eof(false), tooLong(false), bytes(0) {}
+
+    bool next(const char *&b, const char *&e){
+        for(;;){
+            if(start < end){
+                const char *nl = (const char*)memchr(&buf[start], '\n', end - start);
+                if(nl){
+                    b = &buf[start]; e = nl;
+                    start = (size_t)(nl - &buf[0]) + 1;
+                    return true;
+                }
+            }
+            if(eof){
+                if(start < end){ b = &buf[start]; e = &buf[0] + end; start = end; return true; }
+                return false;
+            }
+            if(start > 0){
+                memmove(&buf[0], &buf[start], end - start);
+                end -= start; start = 0;
+            }
+            if(end == buf.size()){ tooLong = true; return false; }
+            size_t got = fread(&buf[end], 1, buf.size() - end, f);
+            bytes += (int64_t)got;
+            end += got;
+            if(got == 0) eof = true;
+        }
+    }
+
+    bool lineTooLong() const { return tooLong; }
+    int64_t bytesRead() const { return bytes; }
+
+private:
+    FILE *f;
+    vector<char> buf;
+    size_t start, end;
+    bool eof, tooLong;
+    int64_t bytes;
+};
+
+static void skipSpace(const char *&p, const char *e){
+    while(p < e && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+}
+
+static bool parseInt(const char *&p, const char *e, int64_t &v){
+    skipSpace(p, e);
+    bool neg = false;
+    if(p < e && *p == '-'){ neg = true; p++; }
+    if(p >= e || *p < '0' || *p > '9') return false;
+    int64_t x = 0;
+    while(p < e && *p >= '0' && *p <= '9'){
+        x = x*10 + (*p - '0'); p++;
+        if(x > 0x7fffffff) return false;            // no id, count or weight is wider
+    }
+    v = neg ? -x : x;
+    return true;
+}
+
+static void skipWord(const char *&p, const char *e){
+    skipSpace(p, e);
+    while(p < e && *p != ' ' && *p != '\t' && *p != '\r') p++;
+}
+
+/* --- One line -> at most one edge. Returns false on a malformed line. --- */
+static bool parseEdgeLine(TextFormat fmt, const char *p, const char *e, bool &isEdge,
+                          int64_t &u, int64_t &v, int64_t &w, int64_t &declaredN){
+    isEdge = false;
+    skipSpace(p, e);
+    if(p >= e) return true;
+    if(fmt == FORMAT_EDGE_LIST){
+        if(*p == '#' || *p == '%'){
+            /* "# ... n=<count>" (as exportText writes) keeps trailing isolated vertices */
+            for(const char *q = p; q + 2 < e; q++)
+                if(q[0]=='n' && q[1]=='=' && (q==p || q[-1]==' ')){
+                    q += 2;
+                    if(q < e && *q >= '0' && *q <= '9' && !parseInt(q, e, declaredN)) return false;
+                    break;
+                }
+            return true;
+        }
+        if(!parseInt(p, e, u) || !parseInt(p, e, v)) return false;
+        w = 1;
+        skipSpace(p, e);
+        if(p < e && (*p == '-' || (*p >= '0' && *p <= '9')) && !parseInt(p, e, w)) return false;
+        isEdge = true;
+        return u >= 0 && v >= 0;
+    }
+    char tag = *p++;
+    if(tag == 'c') return true;
+    if(tag == 'p'){
+        int64_t m;
+        skipWord(p, e);
+        if(!parseInt(p, e, declaredN) || !parseInt(p, e, m)) return false;
+        return true;
+    }
+    if(tag == 'a' || tag == 'e'){
+        if(!parseInt(p, e, u) || !parseInt(p, e, v)) return false;
+        w = 1;
+        if(tag == 'a' && !parseInt(p, e, w)) return false;
+        u--; v--;
+        isEdge = true;
+        return u >= 0 && v >= 0;
+    }
+    return true;    // other DIMACS line types (n, t, ...) are ignored
+}
+
+bool importText(const char *path, TextFormat fmt, bool directed, bool weighted,
+                CsrGraph &out, IoStats *stats, string *err){
+    double t0 = nowSec();
+    out = CsrGraph();
+    out.directed = directed;
+    out.weighted = weighted;
+
+    /* pass 1: degrees */
+    FILE *f = fopen(path, "rb");
+    if(!f) return fail(err, string("cannot open ") + path);
+    vector<int64_t> deg;
+    int64_t declaredN = 0, lineNo = 0, entries = 0, maxSeen = -1;
+    {
+        LineReader lr(f);
+        const char *b, *e;
+        while(lr.next(b, e)){
+            lineNo++;
+            bool isEdge; int64_t u, v, w;
+            if(!parseEdgeLine(fmt, b, e, isEdge, u, v, w, declaredN)){
+                fclose(f);
+                return fail(err, string(path) + ":" + intToStr(lineNo) + ": malformed line");
+            }
+            if(!isEdge) continue;
+            if(u >= TEXT_MAX_VERTICES || v >= TEXT_MAX_VERTICES){
+                fclose(f);
+                return fail(err, string(path) + ":" + intToStr(lineNo) + ": vertex id out of range");
+            }
+            if(weighted && (w < 1 || w > TEXT_MAX_WEIGHT)){
+                fclose(f);
+                return fail(err, string(path) + ":" + intToStr(lineNo) + ": weight out of range");
+            }
+            maxSeen = max(maxSeen, max(u, v));
+            int64_t hi = max(u, v) + 1;
+            if((int64_t)deg.size() < hi) deg.resize((size_t)min(TEXT_MAX_VERTICES, max<int64_t>(hi, (int64_t)deg.size()*3/2)));
+            deg[u]++; entries++;
+            if(!directed && u != v){ deg[v]++; entries++; }
+        }
+        if(lr.lineTooLong()){ fclose(f); return fail(err, "line longer than 1 MB"); }
+        if(stats) stats->bytes = lr.bytesRead();
+    }
+    if(declaredN < 0 || declaredN > TEXT_MAX_VERTICES){ fclose(f); return fail(err, "declared vertex count out of range"); }
+    int n = (int)max(declaredN, maxSeen + 1);       // a directed target may have no row of its own
+
+    out.offsets.assign(n + 1, 0);
+    for(int i=0;i<n;i++) out.offsets[i+1] = out.offsets[i] + (i < (int64_t)deg.size() ? deg[i] : 0);
+    deg.clear(); deg.shrink_to_fit();
+    out.targets.resize(entries);
+    if(weighted) out.weights.resize(entries);
+    vector<int64_t> pos(out.offsets.begin(), out.offsets.end() - 1);
+
+    /* pass 2: fill */
+    rewind(f);
+    {
+        LineReader lr(f);
+        const char *b, *e;
+        int64_t dummy = 0;
+        while(lr.next(b, e)){
+            bool isEdge; int64_t u, v, w;
+            parseEdgeLine(fmt, b, e, isEdge, u, v, w, dummy);
+            if(!isEdge) continue;
+            int64_t p = pos[u]++;
+            out.targets[p] = (int32_t)v;
+            if(weighted) out.weights[p] = (int32_t)w;
+            if(!directed && u != v){
+                p = pos[v]++;
+                out.targets[p] = (int32_t)u;
+                if(weighted) out.weights[p] = (int32_t)w;
+            }
+        }
+    }
+    fclose(f);
+    if(stats){ stats->edges = entries; stats->seconds = nowSec() - t0; }
+    return true;
+}
+
+/* --- Buffered writer with hand-rolled integer formatting --- */
+class TextWriter {
+public:
+    explicit TextWriter(FILE *file): f(file), used(0), bytes(0), ok(true) { buf.resize(1 << 20); }
+    ~TextWriter(){ flush(); }
+
+    void put(char c){ if(used == buf.size()) flush(); buf[used++] = c; }
+    void put(const char *s){ while(*s) put(*s++); }
+    void num(int64_t v){
+        char tmp[24]; int len = 0;
+        if(v < 0){ put('-'); v = -v; }
+        do { tmp[len++] = (char)('0' + v % 10); v /= 10; } while(v);
+        while(len) put(tmp[--len]);
+    }
+    void flush(){
+        if(used && fwrite(&buf[0], 1, used, f) != used) ok = false;
+        bytes += (int64_t)used;
+        used = 0;
+    }
+    bool good() const { return ok; }
+    int64_t written() const { return bytes; }
+
+private:
+    FILE *f;
+    vector<char> buf;
+    size_t used;
+    int64_t bytes;
+    bool ok;
+};
+
+/* --- Undirected graphs write each edge once (u <= v) --- */
+bool exportText(const char *path, TextFormat fmt, const CsrView &g, IoStats *stats, string *err){
+    double t0 = nowSec();
+    FILE *f = fopen(path, "wb");
+    if(!f) return fail(err, string("cannot create ") + path);
+    int64_t count = 0;
+    for(int u=0; u<g.n; u++)
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++)
+            if(g.directed || g.targets[i] >= u) count++;
+    bool ok;
+    {
+        TextWriter w(f);
+        if(fmt == FORMAT_DIMACS){
+            w.put("c written by Graph-Visualizer\np sp "); w.num(g.n); w.put(' '); w.num(count); w.put('\n');
+        } else {
+            w.put("# "); w.put(g.directed ? "directed" : "undirected"); w.put(" n="); w.num(g.n); w.put(" m="); w.num(count); w.put('\n');
+        }
+        for(int u=0; u<g.n; u++)
+            for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+                int v = g.targets[i];
+                if(!g.directed && v < u) continue;
+                int wt = g.weights ? g.weights[i] : 1;
+                if(fmt == FORMAT_DIMACS){ w.put("a "); w.num(u+1); w.put(' '); w.num(v+1); w.put(' '); w.num(wt); }
+                else { w.num(u); w.put(' '); w.num(v); if(g.weighted){ w.put(' '); w.num(wt); } }
+                w.put('\n');
+            }
+        w.flush();
+        ok = w.good();
+        if(stats) stats->bytes = w.written();
+    }
+    ok = (fclose(f) == 0) && ok;
+    if(!ok) return fail(err, string("write failed: ") + path);
+    if(stats){ stats->edges = count; stats->seconds = nowSec() - t0; }
+    return true;
+}
+
+/* ===================== editor model ===================== */
+
+/* --- Tombstones are not written: a fragmented graph is saved compacted --- */
+bool saveGraph(const char *path, const Graph &g, IoStats *stats, string *err){
+    if(g.nodeCount == g.slotCount()){
+        CsrGraph c = buildCsr(g);
+        return saveBinary(path, c.view(), &g.nodes, stats, err);
+    }
+    Graph packed;
+    packed.directed = g.directed; packed.weighted = g.weighted;
+    vector<Node> ns(g.nodes); AdjList as(g.adj);
+    packed.swapContents(ns, as);
+    vector<int> remap;
+    packed.compact(remap);
+    CsrGraph c = buildCsr(packed);
+    return saveBinary(path, c.view(), &packed.nodes, stats, err);
+}
+
+static bool endsWith(const string &s, const char *suffix){
+    size_t k = strlen(suffix);
+    return s.size() >= k && s.compare(s.size() - k, k, suffix) == 0;
+}
+
+/* --- CSR rows -> adjacency lists; nodes get stored or grid positions --- */
+static void csrToModel(const CsrView &c, const MappedGraph *mg, vector<Node> &nodes, AdjList &adj){
+    int cols = 1;
+    while((int64_t)cols*cols < c.n) cols++;
+    nodes.resize(c.n);
+    adj.assign(c.n, AdjRow());
+    for(int i=0;i<c.n;i++){
+        Node &nd = nodes[i];
+        if(mg && mg->hasCoords()){ nd.x = mg->x(i); nd.y = mg->y(i); }
+        else { nd.x = 40 + (i % cols) * 60; nd.y = 110 + (i / cols) * 60; }
+        nd.label = mg ? mg->label(i) : intToStr(i);
+        nd.visited = false;
+        AdjRow &row = adj[i];
+        row.reserve((size_t)c.degree(i));
+        for(int64_t k=c.offsets[i]; k<c.offsets[i+1]; k++)
+            row.push_back(make_pair((int)c.targets[k], c.weights ? (int)c.weights[k] : 1));
+    }
+}
+
+bool loadGraph(const char *path, vector<Node> &nodes, AdjList &adj,
+               bool &directed, bool &weighted, IoStats *stats, string *err){
+    double t0 = nowSec();
+    char magic[8] = {0};
+    FILE *f = fopen(path, "rb");
+    if(!f) return fail(err, string("cannot open ") + path);
+    size_t got = fread(magic, 1, 8, f);
+    fclose(f);
+
+    IoStats st;
+    if(got == 8 && memcmp(magic, GVG_MAGIC, 8) == 0){
+        MappedGraph mg;
+        if(!mg.open(path, &st, err) || !mg.validate(err)) return false;
+        directed = mg.view().directed;
+        weighted = mg.view().weighted;
+        csrToModel(mg.view(), &mg, nodes, adj);
+    } else {
+        string p(path);
+        TextFormat fmt = (endsWith(p, ".gr") || endsWith(p, ".dimacs")) ? FORMAT_DIMACS : FORMAT_EDGE_LIST;
+        CsrGraph c;
+        if(!importText(path, fmt, directed, weighted, c, &st, err) || !checkCsr(c.view(), err)) return false;
+        csrToModel(c.view(), 0, nodes, adj);
+    }
+    if(stats){ *stats = st; stats->seconds = nowSec() - t0; }
+    return true;
+}
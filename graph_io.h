@@ -0,0 +1,120 @@
+/* graph_io.h - saving and loading graphs.
+
+   Binary (.gvg, version 1): a fixed little-endian header followed by
+   8-byte aligned sections - CSR offsets (int64, n+1), targets (int32, m),
+   optional weights (int32, m), optional node coordinates (int32 x,y per
+   node) and optional labels (uint32 offsets n+1 + characters).  The file
+   can be memory-mapped and used as a read-only CsrView without parsing.
+
+   Text: edge lists ("u v [w]" per line, 0-based, '#' or '%' comments; a
+   comment containing "n=<count>" sets the vertex count) and
+   DIMACS ("p sp n m", "a u v w" 1-based, "c" comments).  Import streams
+   the file twice through a fixed buffer - once to count degrees, once to
+   fill the CSR - so the only memory that grows with the input is the CSR.
+   Vertex ids are capped (TEXT_MAX_VERTICES) since the CSR is sized by the
+   largest one, and weights must lie in the editor's positive range. */
+#ifndef GRAPH_IO_H
+#define GRAPH_IO_H
+
+#include "graph_core.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/* --- Throughput report filled by every load/save --- */
+struct IoStats {
+    int64_t edges;          // edges (CSR entries) read or written
+    int64_t bytes;
+    double seconds;
+
+    IoStats(): edges(0), bytes(0), seconds(0) {}
+    double edgesPerSecond() const { return seconds > 0 ? edges / seconds : 0; }
+};
+
+enum TextFormat { FORMAT_EDGE_LIST, FORMAT_DIMACS };
+
+/* --- Binary format --- */
+const uint32_t GVG_VERSION = 1;
+
+enum GvgFlags {
+    GVG_DIRECTED = 1,
+    GVG_WEIGHTED = 2,
+    GVG_COORDS   = 4,
+    GVG_LABELS   = 8
+};
+
+struct GvgHeader {
+    char     magic[8];          // "GVGRAPH\0"
+    uint32_t version;
+    uint32_t endian;            // 0x01020304 as written
+    uint32_t flags;             // GvgFlags
+    uint32_t reserved;
+    uint64_t n, m;
+    uint64_t offsetsPos, targetsPos, weightsPos, coordsPos, labelIndexPos, labelCharsPos;
+    uint64_t fileSize;
+};
+
+/* `nodes` (optional) supplies coordinates and labels, index-aligned with g. */
+bool saveBinary(const char *path, const CsrView &g, const std::vector<Node> *nodes,
+                IoStats *stats = 0, std::string *err = 0);
+
+/* --- Read-only memory-mapped .gvg file --- */
+class MappedGraph {
+public:
+    MappedGraph();
+    ~MappedGraph();
+
+    bool open(const char *path, IoStats *stats = 0, std::string *err = 0);
+    void close();
+
+    /* open() checks the header and section bounds only; this reads every
+       offset, target and label index (O(n + m)) before the arrays are
+       trusted as a graph */
+    bool validate(std::string *err = 0) const;
+
+    bool isOpen() const { return base != 0; }
+    const CsrView &view() const { return csr; }
+    bool hasCoords() const { return coords != 0; }
+    bool hasLabels() const { return labelIndex != 0; }
+    int  x(int v) const { return coords[2*v]; }
+    int  y(int v) const { return coords[2*v+1]; }
+    std::string label(int v) const;
+
+private:
+    const char *base;
+    uint64_t length;
+    CsrView csr;
+    const int32_t *coords;
+    const uint32_t *labelIndex;
+    const char *labelChars;
+#ifdef _WIN32
+    void *fileHandle, *mapHandle;
+#else
+    int fd;
+#endif
+
+    MappedGraph(const MappedGraph &);
+    MappedGraph &operator=(const MappedGraph &);
+};
+
+/* --- Streaming text import / export --- */
+const int64_t TEXT_MAX_VERTICES = (int64_t)1 << 26;    // vertex ids and declared counts must stay below
+const int64_t TEXT_MAX_WEIGHT = 999999;                 // weighted imports take 1..this (the weight popup's range)
+
+bool importText(const char *path, TextFormat fmt, bool directed, bool weighted,
+                CsrGraph &out, IoStats *stats = 0, std::string *err = 0);
+bool exportText(const char *path, TextFormat fmt, const CsrView &g,
+                IoStats *stats = 0, std::string *err = 0);
+
+/* --- Editor model <-> files --- */
+bool saveGraph(const char *path, const Graph &g, IoStats *stats = 0, std::string *err = 0);
+
+/* Loads .gvg (detected by magic), DIMACS (.gr / .dimacs) or an edge list
+   into node/adjacency vectors ready for Graph::swapContents.  Nodes
+   without stored coordinates are placed on a grid. `directed`/`weighted`
+   are taken from the file when it records them. */
+bool loadGraph(const char *path, std::vector<Node> &nodes, AdjList &adj,
+               bool &directed, bool &weighted, IoStats *stats = 0, std::string *err = 0);
+
+#endif
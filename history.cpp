@@ -0,0 +1,238 @@
+#include "history.h"
+#include "profile.h"
+
+using namespace std;
+
+/* --- Footprint of one entry (what trimming by budget counts) --- */
+size_t Edit::bytes() const {
+    size_t b = sizeof(Edit) + node.label.capacity();
+    b += row.capacity() * sizeof(row[0]);
+    b += removed.capacity() * sizeof(RemovedEdge);
+    b += clearedNodes.capacity() * sizeof(Node);
+    for(size_t i=0;i<clearedNodes.size();i++) b += clearedNodes[i].label.capacity();
+    b += clearedAdj.capacity() * sizeof(AdjRow);
+    for(size_t i=0;i<clearedAdj.size();i++) b += clearedAdj[i].capacity() * sizeof(clearedAdj[i][0]);
+    b += remap.capacity() * sizeof(int);
+    b += positions.capacity() * sizeof(positions[0]);
+    b += (batch.capacity() - batch.size()) * sizeof(Edit);
+    for(size_t i=0;i<batch.size();i++) b += batch[i].bytes();
+    return b;
+}
+
+History::History(int maxEntries, size_t byteBudget)
+    : ring(maxEntries > 0 ? maxEntries : 1), head(0), count(0), cursor(0), bytes(0), budget(byteBudget), batchDepth(0) {}
+
+void History::reset(){
+    for(int i=0;i<count;i++) at(i) = Edit();
+    head=0; count=0; cursor=0; bytes=0; batchDepth=0;
+}
+
+void History::setLimits(int maxEntries, size_t byteBudget){
+    reset();
+    ring.assign(maxEntries > 0 ? maxEntries : 1, Edit());
+    budget = byteBudget;
+}
+
+void History::dropOldest(){
+    bytes -= ring[head].cost;
+    ring[head] = Edit();
+    head = (head + 1) % ring.size();
+    count--; cursor--;
+}
+
+/* --- New edit: the redo tail is discarded, the oldest entry evicted if full --- */
+Edit &History::push(){
+    if(batchDepth > 0){
+        Edit &b = at(count-1);
+        b.batch.push_back(Edit());
+        return b.batch.back();
+    }
+    while(count > cursor){
+        Edit &e = at(count-1);
+        bytes -= e.cost;
+        e = Edit();
+        count--;
+    }
+    if(count == (int)ring.size()) dropOldest();
+    count++; cursor++;
+    return at(count-1);
+}
+
+/* --- Keep the newest entry even if it alone exceeds the budget --- */
+void History::commit(){
+    if(batchDepth > 0) return;          // endBatch() accounts the whole batch
+    Edit &e = at(count-1);
+    e.cost = e.bytes();
+    bytes += e.cost;
+    while(count > 1 && bytes > budget) dropOldest();
+}
+
+int History::addNode(Graph &g,int x,int y){
+    PROFILE_SCOPE("history.edit");
+    int id = g.addNode(x,y);
+    Edit &e = push();
+    e.kind = EDIT_ADD_NODE; e.u = id; e.node = g.nodes[id];
+    commit();
+    return id;
+}
+
+void History::addEdge(Graph &g,int u,int v,int w){
+    PROFILE_SCOPE("history.edit");
+    g.addEdge(u,v,w);
+    Edit &e = push();
+    e.kind = EDIT_ADD_EDGE; e.u = u; e.v = v; e.w = w;
+    commit();
+}
+
+void History::deleteNode(Graph &g,int id){
+    PROFILE_SCOPE("history.edit");
+    Edit &e = push();
+    e.kind = EDIT_DELETE_NODE; e.u = id;
+    e.node = g.nodes[id];
+    e.row = g.adj[id];
+    g.deleteNode(id, &e.removed);
+    commit();
+}
+
+void History::deleteEdge(Graph &g,int u,int k){
+    PROFILE_SCOPE("history.edit");
+    Edit &e = push();
+    e.kind = EDIT_DELETE_EDGE; e.u = u; e.k = k;
+    e.v = g.adj[u][k].first; e.w = g.adj[u][k].second;
+    g.deleteEdge(u,k,&e.km);
+    commit();
+}
+
+/* --- Clear moves the graph into the entry instead of copying it --- */
+void History::clear(Graph &g){
+    PROFILE_SCOPE("history.edit");
+    Edit &e = push();
+    e.kind = EDIT_CLEAR;
+    g.swapContents(e.clearedNodes, e.clearedAdj);
+    commit();
+}
+
+/* --- Load a whole graph (file open) as one undoable step; the flags travel
+   with the contents and are set before observers see the reset --- */
+static void swapReplace(Graph &g, Edit &e){
+    bool d = g.directed, w = g.weighted;
+    g.setFlags(e.u != 0, e.v != 0);
+    e.u = d; e.v = w;
+    g.swapContents(e.clearedNodes, e.clearedAdj);
+}
+
+void History::replace(Graph &g, vector<Node> &nodes, AdjList &adj, bool directed, bool weighted){
+    PROFILE_SCOPE("history.edit");
+    Edit &e = push();
+    e.kind = EDIT_REPLACE;
+    e.clearedNodes.swap(nodes);
+    e.clearedAdj.swap(adj);
+    e.u = directed; e.v = weighted;
+    swapReplace(g, e);
+    commit();
+}
+
+/* --- Compaction renumbers every id the log refers to, so it is logged too
+   (as the remap) and undone before the edit that triggered it --- */
+bool History::compactIfFragmented(Graph &g){
+    if(!g.wantsCompaction() || cursor == 0 || batchDepth > 0) return false;
+    PROFILE_SCOPE("history.edit");
+    Edit &e = push();
+    e.kind = EDIT_COMPACT;
+    g.compact(e.remap, &e.clearedNodes);
+    commit();
+    return true;
+}
+
+/* --- A finished auto-layout: the entry keeps the positions from before it
+   and undo/redo just swap them with the graph's --- */
+void History::moveNodes(Graph &, vector< pair<int,int> > &before){
+    PROFILE_SCOPE("history.edit");
+    Edit &e = push();
+    e.kind = EDIT_MOVE;
+    e.positions.swap(before);
+    commit();
+}
+
+/* --- A vertex reordering: the entry keeps the permutation, and undo
+   applies its inverse --- */
+void History::permute(Graph &g, vector<int> &perm){
+    PROFILE_SCOPE("history.edit");
+    Edit &e = push();
+    e.kind = EDIT_PERMUTE;
+    g.permute(perm);
+    e.remap.swap(perm);
+    commit();
+}
+
+static void unpermute(Graph &g, const vector<int> &perm){
+    vector<int> inv(perm.size());
+    for(size_t i=0;i<perm.size();i++) inv[perm[i]] = (int)i;
+    g.permute(inv);
+}
+
+/* --- Batches: one ring entry whose children are the edits --- */
+void History::beginBatch(size_t expectedEdits){
+    if(batchDepth++ > 0) return;
+    batchDepth = 0;
+    Edit &e = push();
+    e.kind = EDIT_BATCH;
+    e.batch.reserve(expectedEdits);
+    batchDepth = 1;
+}
+
+void History::endBatch(){
+    if(batchDepth == 0 || --batchDepth > 0) return;
+    Edit &e = at(count-1);
+    if(e.batch.empty()){ e = Edit(); count--; cursor--; return; }
+    commit();
+}
+
+static void undoEdit(Graph &g, Edit &e){
+    switch(e.kind){
+        case EDIT_ADD_NODE:    g.deleteNode(e.u); break;
+        case EDIT_ADD_EDGE:    g.unaddEdge(e.u, e.v); break;
+        case EDIT_DELETE_NODE: g.restoreNode(e.u, e.node, e.row, e.removed); break;
+        case EDIT_DELETE_EDGE: g.reinsertEdge(e.u, e.k, e.v, e.w, e.km); break;
+        case EDIT_CLEAR:       g.swapContents(e.clearedNodes, e.clearedAdj); break;
+        case EDIT_REPLACE:     swapReplace(g, e); break;
+        case EDIT_MOVE:        g.swapPositions(e.positions); break;
+        case EDIT_BATCH:       for(size_t i=e.batch.size(); i-- > 0; ) undoEdit(g, e.batch[i]); break;
+        case EDIT_PERMUTE:     unpermute(g, e.remap); break;
+        case EDIT_COMPACT:     break;   // paired with its predecessor in undo()
+    }
+}
+
+static void redoEdit(Graph &g, Edit &e){
+    switch(e.kind){
+        case EDIT_ADD_NODE:    g.restoreNode(e.u, e.node, AdjRow(), vector<RemovedEdge>()); break;
+        case EDIT_ADD_EDGE:    g.addEdge(e.u, e.v, e.w); break;
+        case EDIT_DELETE_NODE: e.removed.clear(); g.deleteNode(e.u, &e.removed); break;
+        case EDIT_DELETE_EDGE: g.deleteEdge(e.u, e.k, &e.km); break;
+        case EDIT_CLEAR:       g.swapContents(e.clearedNodes, e.clearedAdj); break;
+        case EDIT_REPLACE:     swapReplace(g, e); break;
+        case EDIT_MOVE:        g.swapPositions(e.positions); break;
+        case EDIT_COMPACT:     e.clearedNodes.clear(); g.compact(e.remap, &e.clearedNodes); break;
+        case EDIT_BATCH:       for(size_t i=0; i<e.batch.size(); i++) redoEdit(g, e.batch[i]); break;
+        case EDIT_PERMUTE:     g.permute(e.remap); break;
+    }
+}
+
+bool History::undo(Graph &g){
+    if(cursor == 0 || batchDepth > 0) return false;
+    Edit &e = at(--cursor);
+    if(e.kind == EDIT_COMPACT){
+        g.uncompact(e.remap, e.clearedNodes);
+        e.clearedNodes.clear();
+        return cursor == 0 || undo(g);
+    }
+    undoEdit(g, e);
+    return true;
+}
+
+bool History::redo(Graph &g){
+    if(cursor == count || batchDepth > 0) return false;
+    redoEdit(g, at(cursor++));
+    if(cursor < count && at(cursor).kind == EDIT_COMPACT) redo(g);
+    return true;
+}
@@ -0,0 +1,96 @@
+/* history.h - undo/redo over a Graph as a log of edits (deltas).
+   Each entry stores only what its edit changed, so undo/redo cost is
+   proportional to the edit, not to the graph.  Entries live in a ring
+   buffer capped both by count and by an approximate byte budget. */
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "graph_core.h"
+
+#include <stddef.h>
+#include <vector>
+
+enum EditKind {
+    EDIT_ADD_NODE,
+    EDIT_ADD_EDGE,
+    EDIT_DELETE_NODE,
+    EDIT_DELETE_EDGE,
+    EDIT_CLEAR,
+    EDIT_REPLACE,
+    EDIT_MOVE,              // every node repositioned at once (auto-layout)
+    EDIT_COMPACT,           // rides along with the edit before it (undone/redone together)
+    EDIT_BATCH,             // several edits applied, undone and redone as one
+    EDIT_PERMUTE            // every id renumbered by a vertex ordering
+};
+
+/* --- One recorded edit --- */
+struct Edit {
+    EditKind kind;
+    int u, v, w, k;                     // node id / edge (u,v,weight) / position in adj[u];
+                                        // replace: the other side's directed/weighted flags
+    int km;                             // delete edge: mirror position in adj[v], or -1
+    Node node;                          // add/delete node: the node itself
+    AdjRow row;                         // delete node: its own adjacency row
+    std::vector<RemovedEdge> removed;   // delete node: entries dropped from other rows
+    std::vector<Node> clearedNodes;     // clear/replace: the other graph, moved (not copied) in;
+                                        // compact: the tombstones
+    AdjList clearedAdj;
+    std::vector<int> remap;             // compact: old id -> new id or -1; permute: old id -> new id
+    std::vector< std::pair<int,int> > positions;   // move: the other side's (x,y) per slot
+    std::vector<Edit> batch;            // batch: its edits, in the order they were applied
+    size_t cost;                        // bytes() when recorded
+
+    Edit(): kind(EDIT_ADD_NODE), u(-1), v(-1), w(0), k(-1), km(-1), node(), cost(0) {}
+    size_t bytes() const;               // approximate heap + inline footprint
+};
+
+class History {
+public:
+    static const int MAX_UNDO = 120;
+    static const size_t DEFAULT_BUDGET = 64u << 20;    // 64 MB
+
+    History(int maxEntries = MAX_UNDO, size_t byteBudget = DEFAULT_BUDGET);
+
+    void reset();                       // forget every entry
+
+    /* edits: apply to g and record the delta */
+    int  addNode(Graph &g,int x,int y);
+    void addEdge(Graph &g,int u,int v,int w);
+    void deleteNode(Graph &g,int id);
+    void deleteEdge(Graph &g,int u,int k);
+    void clear(Graph &g);
+    void replace(Graph &g, std::vector<Node> &nodes, AdjList &adj, bool directed, bool weighted); // takes the contents
+    bool compactIfFragmented(Graph &g); // renumbers when g.wantsCompaction()
+    void moveNodes(Graph &g, std::vector< std::pair<int,int> > &before);  // g already moved; takes `before`
+    void permute(Graph &g, std::vector<int> &perm);     // applies and takes the permutation
+
+    /* every edit between beginBatch() and the matching endBatch() becomes
+       part of one entry (an empty batch leaves none); batches nest, and
+       compaction waits until the batch is over */
+    void beginBatch(size_t expectedEdits = 0);
+    void endBatch();
+    bool inBatch() const { return batchDepth > 0; }
+
+    bool undo(Graph &g);
+    bool redo(Graph &g);
+
+    int    undoCount() const { return cursor; }
+    int    redoCount() const { return count - cursor; }
+    size_t bytesUsed() const { return bytes; }
+    void   setLimits(int maxEntries, size_t byteBudget);
+
+private:
+    std::vector<Edit> ring;             // capacity == maxEntries
+    int head;                           // ring index of the oldest entry
+    int count;                          // live entries (undo + redo)
+    int cursor;                         // entries [0, cursor) are applied
+    size_t bytes, budget;
+    int batchDepth;                     // open beginBatch() calls
+
+    Edit &at(int i) { return ring[(head + i) % ring.size()]; }
+    Edit &push();                       // drops redo entries, returns a fresh slot (in a batch: a fresh child)
+    void  commit();                     // accounts the newest entry, enforces limits
+    void  dropOldest();
+};
+
+#endif
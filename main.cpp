@@ -1,568 +1,1280 @@
-#include <graphics.h>
-#include <conio.h>
-#include <stdlib.h>
-#include <stdio.h>
-#include <math.h>
-#include <vector>
-#include <queue>
-#include <stack>
-#include <string>
-#include <sstream>
-#include <iostream>
-#include <limits>
-#include <windows.h>
-
-using namespace std;
-
-/* --- Window / layout constants --- */
-const int WIN_W = 1000;
-const int WIN_H = 650;
-const int UI_H  = 70;
-const int NODE_RADIUS = 22;
-const unsigned long DOUBLE_CLICK_MS = 400UL;
-
-/* --- Basic node type --- */
-struct Node {
-    int x, y;
-    string label;
-    bool visited;
-};
-
-/* --- Interaction modes --- */
-enum Mode {
-    MODE_ADD_NODE,
-    MODE_ADD_EDGE,
-    MODE_BFS,
-    MODE_DFS,
-    MODE_SELF_LOOP,
-    MODE_DELETE_NODE,
-    MODE_DELETE_EDGE,
-    MODE_NONE
-};
-
-/* --- Global state --- */
-static vector<Node> nodes;
-static vector< vector< pair<int,int> > > adj; // adjacency: (to, weight)
-static int nodeCount = 0;
-static Mode currentMode = MODE_ADD_NODE;
-static int selNode = -1;
-
-/* --- Undo/Redo snapshot --- */
-struct Snapshot {
-    vector<Node> s_nodes;
-    vector< vector< pair<int,int> > > s_adj;
-    int s_nodeCount;
-};
-static vector<Snapshot> undoStack;
-static vector<Snapshot> redoStack;
-const int MAX_UNDO = 120;
-
-/* --- Double buffering pages --- */
-static int activePage = 0;
-static int visualPage = 1;
-
-/* --- Graph options --- */
-static bool GLOBAL_WEIGHTED = false;
-static bool GLOBAL_DIRECTED = false;
-
-/* --- Double-click tracking --- */
-static unsigned long lastClickTime = 0;
-static int lastClickNode = -1;
-
-/* --- Utility: int -> string --- */
-string intToStr(int v) { stringstream ss; ss << v; return ss.str(); }
-
-/* --- Save current state for undo --- */
-void saveSnapshot() {
-    Snapshot s;
-    s.s_nodes = nodes;
-    s.s_adj = adj;
-    s.s_nodeCount = nodeCount;
-    undoStack.push_back(s);
-    if ((int)undoStack.size() > MAX_UNDO) undoStack.erase(undoStack.begin());
-    redoStack.clear();
-}
-
-/* --- Apply a snapshot (undo/redo) --- */
-void applySnapshot(const Snapshot &s) {
-    nodes = s.s_nodes;
-    adj = s.s_adj;
-    nodeCount = s.s_nodeCount;
-}
-
-/* --- Find node under a point (returns index or -1) --- */
-int findNodeAt(int mx, int my) {
-    for (int i = 0; i < nodeCount; ++i) {
-        int dx = mx - nodes[i].x;
-        int dy = my - nodes[i].y;
-        if (dx*dx + dy*dy <= NODE_RADIUS*NODE_RADIUS) return i;
-    }
-    return -1;
-}
-
-/* --- Simple rect hit test --- */
-bool pointInRect(int mx,int my,int x,int y,int w,int h) {
-    return mx >= x && mx <= x + w && my >= y && my <= y + h;
-}
-
-/* --- Draw a toolbar button --- */
-void drawButton(int x,int y,int w,int h,const string &txt,bool active,bool hover) {
-    int fill = active ? LIGHTCYAN : (hover ? LIGHTGRAY+2 : LIGHTGRAY);
-    setfillstyle(SOLID_FILL, fill);
-    bar(x,y,x+w,y+h);
-    setcolor(BLACK);
-    rectangle(x,y,x+w,y+h);
-    setbkcolor(fill);
-    outtextxy(x+10, y + (h/2 - textheight((char*)txt.c_str())/2), (char*)txt.c_str());
-}
-
-/* --- Draw the UI toolbar --- */
-void drawUI(int hoverButtonIndex) {
-    setfillstyle(SOLID_FILL, LIGHTGRAY);
-    bar(0, 0, WIN_W, UI_H);
-    rectangle(0,0,WIN_W-1,UI_H-1);
-
-    drawButton(10,15,110,40,"Add Node", currentMode==MODE_ADD_NODE, hoverButtonIndex==0);
-    drawButton(130,15,110,40,"Add Edge", currentMode==MODE_ADD_EDGE, hoverButtonIndex==1);
-    drawButton(250,15,80,40,"BFS", currentMode==MODE_BFS, hoverButtonIndex==2);
-    drawButton(340,15,80,40,"DFS", currentMode==MODE_DFS, hoverButtonIndex==3);
-    drawButton(430,15,80,40,"Undo", false, hoverButtonIndex==4);
-    drawButton(520,15,80,40,"Redo", false, hoverButtonIndex==5);
-    drawButton(610,15,100,40,"Self Loop", currentMode==MODE_SELF_LOOP, hoverButtonIndex==6);
-    drawButton(730,15,80,40,"Clear", false, hoverButtonIndex==7);
-
-    setcolor(BLACK);
-    string s1 = "Weighted: "; s1 += GLOBAL_WEIGHTED ? "YES" : "NO";
-    string s2 = "Directed: "; s2 += GLOBAL_DIRECTED ? "YES" : "NO";
-    outtextxy(10,3,(char*)s1.c_str());
-    outtextxy(200,3,(char*)s2.c_str());
-}
-
-/* --- Draw an arrow head between two points --- */
-void drawArrowHead(int x1,int y1,int x2,int y2) {
-    double dx = x2 - x1, dy = y2 - y1;
-    double len = sqrt(dx*dx + dy*dy);
-    if (len < 1.0) return;
-    double ux = dx/len, uy = dy/len;
-    int back = 12, side = 6;
-    double bx = x2 - ux*back, by = y2 - uy*back;
-    double sx = -uy*side, sy = ux*side;
-    int ax = (int)(bx + sx), ay = (int)(by + sy);
-    int bx2 = (int)(bx - sx), by2 = (int)(by - sy);
-    line(x2,y2,ax,ay); line(ax,ay,bx2,by2); line(bx2,by2,x2,y2);
-}
-
-/* --- Draw a self-loop clearly outside the node (always visible) --- */
-void drawSelfLoop(int idx) {
-    int x = nodes[idx].x;
-    int y = nodes[idx].y;
-    int r = NODE_RADIUS;
-    int ovalW = r + 10;
-    int ovalH = r/2 + 6;
-    int cx = x + r + 8;
-    int cy = y - r - 8;
-
-    setcolor(DARKGRAY);
-    setlinestyle(SOLID_LINE, 0, 2);
-    ellipse(cx, cy, 0, 360, ovalW, ovalH);
-
-    int ax = cx - ovalW/2 + 2;
-    int ay = cy + ovalH/2 - 2;
-    drawArrowHead(ax-4, ay-3, ax, ay);
-
-    if(GLOBAL_WEIGHTED){
-        int w = -1;
-        for(int k=0;k<(int)adj[idx].size();k++){
-            if(adj[idx][k].first==idx){ w = adj[idx][k].second; break; }
-        }
-        if(w>=0){
-            string ws = intToStr(w);
-            int tw = textwidth((char*)ws.c_str()), th = textheight((char*)ws.c_str());
-            int tx = cx - tw/2;
-            int ty = cy - ovalH - th - 4;
-            setfillstyle(SOLID_FILL, LIGHTGRAY);
-            bar(tx-4, ty-2, tx+tw+4, ty+th+2);
-            outtextxy(tx, ty, (char*)ws.c_str());
-        }
-    }
-}
-
-/* --- Draw an edge between two nodes --- */
-void drawEdgeVisual(int a,int b,int weight) {
-    int x1 = nodes[a].x, y1 = nodes[a].y;
-    int x2 = nodes[b].x, y2 = nodes[b].y;
-    double dx = x2 - x1, dy = y2 - y1;
-    double dist = sqrt(dx*dx + dy*dy);
-    if(dist<1.0) return;
-    double ux = dx/dist, uy = dy/dist;
-    int sx = (int)(x1 + ux*NODE_RADIUS), sy = (int)(y1 + uy*NODE_RADIUS);
-    int ex = (int)(x2 - ux*NODE_RADIUS), ey = (int)(y2 - uy*NODE_RADIUS);
-    setcolor(DARKGRAY);
-    line(sx,sy,ex,ey);
-    if(GLOBAL_WEIGHTED){
-        string ws = intToStr(weight);
-        int mx = (sx+ex)/2, my=(sy+ey)/2;
-        int tw=textwidth((char*)ws.c_str()), th=textheight((char*)ws.c_str());
-        setfillstyle(SOLID_FILL,LIGHTGRAY);
-        bar(mx-tw/2-4,my-th/2-2,mx+tw/2+4,my+th/2+2);
-        outtextxy(mx-tw/2,my-th/2,(char*)ws.c_str());
-    }
-    if(GLOBAL_DIRECTED) drawArrowHead(sx,sy,ex,ey);
-}
-
-/* --- Main redraw: edges, nodes, self-loops (self-loops on top) --- */
-void drawAll(int hoverNode=-1,int hoverButton=-1){
-    setactivepage(activePage);
-    setfillstyle(SOLID_FILL, WHITE);
-    bar(0,UI_H,WIN_W,WIN_H);
-    drawUI(hoverButton);
-
-    for(int i=0;i<(int)adj.size();i++){
-        for(int j=0;j<(int)adj[i].size();j++){
-            int to = adj[i][j].first;
-            if(to != i){
-                if(GLOBAL_DIRECTED || to > i) drawEdgeVisual(i,to,adj[i][j].second);
-            }
-        }
-    }
-
-    for(int i=0;i<nodeCount;i++){
-        int fill=LIGHTCYAN;
-        if(nodes[i].visited) fill=LIGHTGREEN;
-        if(i==hoverNode) fill=YELLOW;
-        setfillstyle(SOLID_FILL, fill);
-        fillellipse(nodes[i].x,nodes[i].y,NODE_RADIUS,NODE_RADIUS);
-        setcolor(BLACK);
-        circle(nodes[i].x,nodes[i].y,NODE_RADIUS);
-        string lab=nodes[i].label;
-        int tw=textwidth((char*)lab.c_str()), th=textheight((char*)lab.c_str());
-        outtextxy(nodes[i].x-tw/2,nodes[i].y-th/2,(char*)lab.c_str());
-    }
-
-    for(int i=0;i<(int)adj.size();i++){
-        for(int j=0;j<(int)adj[i].size();j++){
-            int to = adj[i][j].first;
-            if(to == i) drawSelfLoop(i);
-        }
-    }
-
-    setvisualpage(activePage);
-    activePage = 1-activePage;
-    visualPage = 1-visualPage;
-}
-
-/* --- BFS / DFS visualization helpers --- */
-void resetVisited(){ for(int i=0;i<nodeCount;i++) nodes[i].visited=false; }
-
-void visualizeVisit(int idx,int delayMs){
-    nodes[idx].visited=true;
-    drawAll();
-    delay(delayMs);
-}
-
-void BFS_visual(int start){
-    if(start<0||start>=nodeCount) return;
-    resetVisited();
-    queue<int> q; q.push(start); nodes[start].visited=true;
-    while(!q.empty()){
-        int u=q.front(); q.pop();
-        visualizeVisit(u,220);
-        for(int k=0;k<(int)adj[u].size();k++){
-            int v=adj[u][k].first;
-            if(!nodes[v].visited){ nodes[v].visited=true; q.push(v);}
-        }
-    }
-}
-
-void DFS_visual(int start){
-    if(start<0||start>=nodeCount) return;
-    resetVisited();
-    stack<int> st; st.push(start);
-    while(!st.empty()){
-        int u=st.top(); st.pop();
-        if(nodes[u].visited) continue;
-        visualizeVisit(u,220);
-        for(int i=(int)adj[u].size()-1;i>=0;i--){
-            int v=adj[u][i].first;
-            if(!nodes[v].visited) st.push(v);
-        }
-    }
-}
-
-/* --- Geometry helper: distance point-to-segment --- */
-double distPointToSegment(int px,int py,int ax,int ay,int bx,int by){
-    double vx=bx-ax,vy=by-ay;
-    double wx=px-ax,wy=py-ay;
-    double c1=vx*wx+vy*wy;
-    double c2=vx*vx+vy*vy;
-    double t=(c2<1e-6)?0.0:c1/c2;
-    if(t<0)t=0;if(t>1)t=1;
-    double cx=ax+t*vx,cy=ay+t*vy;
-    double dx=px-cx,dy=py-cy;
-    return sqrt(dx*dx+dy*dy);
-}
-
-/* --- Find an edge near a point (for delete) --- */
-pair<int,int> findEdgeNear(int mx,int my,double threshold=8.0){
-    for(int u=0;u<(int)adj.size();u++){
-        for(int k=0;k<(int)adj[u].size();k++){
-            int v=adj[u][k].first;
-            if(u==v) continue;
-            if(!GLOBAL_DIRECTED && v<u) continue;
-            int ax=nodes[u].x, ay=nodes[u].y, bx=nodes[v].x, by=nodes[v].y;
-            double d=distPointToSegment(mx,my,ax,ay,bx,by);
-            if(d<=threshold) return make_pair(u,k);
-        }
-    }
-    // Self-loop proximity
-    for(int u=0;u<(int)adj.size();u++){
-        for(int k=0;k<(int)adj[u].size();k++){
-            if(adj[u][k].first==u){
-                int cx=nodes[u].x;
-                int cy=nodes[u].y-NODE_RADIUS-(NODE_RADIUS/2);
-                int dx=mx-cx, dy=my-cy;
-                if(dx*dx+dy*dy<=(NODE_RADIUS/2+8)*(NODE_RADIUS/2+8)) return make_pair(u,k);
-            }
-        }
-    }
-    return make_pair(-1,-1);
-}
-
-/* --- Undo / redo implementation --- */
-void doUndo(){
-    if((int)undoStack.size()==0) return;
-    Snapshot cur; cur.s_nodes=nodes; cur.s_adj=adj; cur.s_nodeCount=nodeCount;
-    redoStack.push_back(cur);
-    Snapshot s=undoStack.back(); undoStack.pop_back();
-    applySnapshot(s); drawAll();
-}
-
-void doRedo(){
-    if((int)redoStack.size()==0) return;
-    Snapshot cur; cur.s_nodes=nodes; cur.s_adj=adj; cur.s_nodeCount=nodeCount;
-    undoStack.push_back(cur);
-    Snapshot s=redoStack.back(); redoStack.pop_back();
-    applySnapshot(s); drawAll();
-}
-
-/* --- Popup: ask the user for edge weight
-     (Centered text in the input box; popup clamped to window.) --- */
-int popupGetWeight(int px,int py){
-    int boxW=260, boxH=100;
-    int bx = px - boxW/2;
-    int by = py - boxH/2;
-
-    if(bx < 10) bx = 10;
-    if(bx + boxW > WIN_W - 10) bx = WIN_W - boxW - 10;
-    if(by + boxH > WIN_H - 20) by = WIN_H - boxH - 20;
-    if(by < UI_H + 20) by = UI_H + 20;
-
-    string text = "";
-    bool done=false, canceled=false;
-    settextstyle(3,0,2);
-    setbkcolor(LIGHTGRAY);
-
-    setactivepage(activePage);
-    setvisualpage(activePage);
-
-    while(!done){
-        setactivepage(activePage);
-
-        // draw popup background
-        setfillstyle(SOLID_FILL,LIGHTGRAY);
-        bar(bx,by,bx+boxW,by+boxH);
-        setcolor(BLACK);
-        rectangle(bx,by,bx+boxW,by+boxH);
-
-        // title
-        outtextxy(bx+10, by+10, (char*)"Enter Edge Weight (digits)");
-
-        // input field rectangle
-        int inputY = by + 40, inputH = 30;
-        rectangle(bx+10, inputY, bx+boxW-10, inputY+inputH);
-
-        // centered display text inside the input rectangle (horizontally + vertically)
-        string display = text.empty() ? "" : text;
-        int tw = textwidth((char*)display.c_str());
-        int th = textheight((char*)display.c_str());
-        int tx = bx + (boxW - tw) / 2;                     // center horizontally
-        int ty = inputY + (inputH - th) / 2;               // center vertically
-        outtextxy(tx, ty, (char*)display.c_str());
-
-        setvisualpage(activePage);
-
-        delay(20);
-        if(kbhit()){
-            int c = getch();
-            if(c==13){ if(!text.empty()) done=true; }
-            else if(c==27){ canceled=true; done=true; }
-            else if(c==8){ if(!text.empty()) text.erase(text.size()-1); }
-            else if(c>='0' && c<='9' && text.size()<6) text.push_back((char)c);
-        }
-    }
-
-    settextstyle(DEFAULT_FONT,0,1);
-    if(canceled) return -1;
-    int val=1; stringstream ss(text); ss>>val; if(val<=0) val=1;
-    return val;
-}
-
-/* --- Program entry: initialize, main loop, input handling --- */
-int main(){
-    int wchoice=0, dchoice=0;
-    while(true){ cout<<"Weighted graph? (1=Yes,0=No): "; if(cin>>wchoice && (wchoice==0||wchoice==1)) break; cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); }
-    while(true){ cout<<"Directed graph? (1=Yes,0=No): "; if(cin>>dchoice && (dchoice==0||dchoice==1)) break; cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); }
-    GLOBAL_WEIGHTED = (wchoice==1);
-    GLOBAL_DIRECTED = (dchoice==1);
-
-    initwindow(WIN_W, WIN_H, "Graph Editor - Dev-C++ / WinBGIm");
-    activePage=0; visualPage=1; setactivepage(activePage); setvisualpage(visualPage); cleardevice();
-
-    nodes.clear(); adj.clear(); nodeCount=0; currentMode=MODE_ADD_NODE; selNode=-1;
-    undoStack.clear(); redoStack.clear();
-    Snapshot base; base.s_nodes=nodes; base.s_adj=adj; base.s_nodeCount=nodeCount;
-    undoStack.push_back(base);
-
-    drawAll();
-
-    int prevHoverNode=-1, prevHoverButton=-1;
-    bool running=true;
-    while(running){
-        if(kbhit()){
-            char ch=getch();
-            if(ch==27) break;
-            if(ch=='u'||ch=='U'){ doUndo(); continue; }
-            if(ch=='r'||ch=='R'){ doRedo(); continue; }
-        }
-
-        int mx = mousex(), my = mousey();
-        int hoverNode = findNodeAt(mx,my);
-        int hoverButton = -1;
-
-        if(pointInRect(mx,my,10,15,110,40)) hoverButton=0;
-        else if(pointInRect(mx,my,130,15,110,40)) hoverButton=1;
-        else if(pointInRect(mx,my,250,15,80,40)) hoverButton=2;
-        else if(pointInRect(mx,my,340,15,80,40)) hoverButton=3;
-        else if(pointInRect(mx,my,430,15,80,40)) hoverButton=4;
-        else if(pointInRect(mx,my,520,15,80,40)) hoverButton=5;
-        else if(pointInRect(mx,my,610,15,100,40)) hoverButton=6;
-        else if(pointInRect(mx,my,730,15,80,40)) hoverButton=7;
-
-        if(prevHoverNode!=hoverNode || prevHoverButton!=hoverButton){
-            drawAll(hoverNode, hoverButton);
-            prevHoverNode = hoverNode; prevHoverButton = hoverButton;
-        }
-
-        if(ismouseclick(WM_LBUTTONDOWN)){
-            clearmouseclick(WM_LBUTTONDOWN);
-
-            if(hoverButton!=-1){
-                switch(hoverButton){
-                    case 0: currentMode=MODE_ADD_NODE; selNode=-1; break;
-                    case 1: currentMode=MODE_ADD_EDGE; selNode=-1; break;
-                    case 2: currentMode=MODE_BFS; selNode=-1; break;
-                    case 3: currentMode=MODE_DFS; selNode=-1; break;
-                    case 4: doUndo(); break;
-                    case 5: doRedo(); break;
-                    case 6: currentMode=MODE_SELF_LOOP; selNode=-1; break;
-                    case 7: saveSnapshot(); nodes.clear(); adj.clear(); nodeCount=0; selNode=-1; drawAll(); break;
-                }
-                continue;
-            }
-
-            if(currentMode==MODE_ADD_NODE && my>UI_H+10){
-                saveSnapshot();
-                Node n; n.x=mx; n.y=my; n.label=intToStr(nodeCount); n.visited=false;
-                nodes.push_back(n);
-                adj.resize(nodes.size());
-                nodeCount++;
-                drawAll();
-            }
-            else if(currentMode==MODE_ADD_EDGE){
-                int id = findNodeAt(mx,my);
-                if(id!=-1){
-                    unsigned long now = GetTickCount();
-                    if(lastClickNode==id && now-lastClickTime<=DOUBLE_CLICK_MS){
-                        lastClickNode = -1;
-                        lastClickTime = 0;
-                        selNode = -1;
-                        continue;
-                    }
-
-                    if(selNode==-1){ selNode=id; lastClickNode=id; lastClickTime=now; }
-                    else if(selNode!=id){
-                        saveSnapshot();
-                        int w=1;
-                        if(GLOBAL_WEIGHTED){
-                            int got = popupGetWeight((nodes[selNode].x+nodes[id].x)/2, (nodes[selNode].y+nodes[id].y)/2);
-                            if(got<0){ selNode=-1; drawAll(); continue; }
-                            w = got;
-                        }
-                        adj[selNode].push_back(make_pair(id,w));
-                        if(!GLOBAL_DIRECTED) adj[id].push_back(make_pair(selNode,w));
-                        selNode=-1; drawAll();
-                    }
-                }
-            }
-            else if(currentMode==MODE_SELF_LOOP){
-                int id = findNodeAt(mx,my);
-                if(id!=-1){
-                    bool exists=false;
-                    for(int k=0;k<(int)adj[id].size();k++) if(adj[id][k].first==id) exists=true;
-                    if(!exists){
-                        saveSnapshot();
-                        int w = 1;
-                        if(GLOBAL_WEIGHTED){
-                            int got = popupGetWeight(nodes[id].x, nodes[id].y - NODE_RADIUS - 10);
-                            if(got<0){ drawAll(); continue; }
-                            w = got;
-                        }
-                        adj[id].push_back(make_pair(id,w));
-                        drawAll();
-                    }
-                }
-            }
-            else if(currentMode==MODE_DELETE_NODE){
-                int id=findNodeAt(mx,my);
-                if(id!=-1){
-                    saveSnapshot();
-                    nodes.erase(nodes.begin()+id);
-                    adj.erase(adj.begin()+id);
-                    for(int i=0;i<(int)adj.size();i++){
-                        for(int j=0;j<(int)adj[i].size();j++){
-                            if(adj[i][j].first==id){ adj[i][j].first = -1; }
-                        }
-                        for(int j=0;j<(int)adj[i].size();){
-                            if(adj[i][j].first==-1) { adj[i].erase(adj[i].begin()+j); }
-                            else {
-                                if(adj[i][j].first>id) adj[i][j].first--;
-                                j++;
-                            }
-                        }
-                    }
-                    nodeCount--; drawAll();
-                }
-            }
-            else if(currentMode==MODE_DELETE_EDGE){
-                pair<int,int> e=findEdgeNear(mx,my);
-                if(e.first!=-1){
-                    saveSnapshot();
-                    adj[e.first].erase(adj[e.first].begin()+e.second);
-                    drawAll();
-                }
-            }
-            else if(currentMode==MODE_BFS){
-                int id=findNodeAt(mx,my);
-                if(id!=-1) BFS_visual(id);
-            }
-            else if(currentMode==MODE_DFS){
-                int id=findNodeAt(mx,my);
-                if(id!=-1) DFS_visual(id);
-            }
-        }
-    }
-
-    closegraph();
-    return 0;
-}
-
+#include <graphics.h>
+#include <conio.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <limits>
+#include <atomic>
+#include <chrono>
+#include <string.h>
+#include <windows.h>
+
+#include "graph_core.h"
+#include "algo_worker.h"
+#include "components.h"
+#include "damage.h"
+#include "force_layout.h"
+#include "graph_io.h"
+#include "history.h"
+#include "multi_bfs.h"
+#include "profile.h"
+#include "raster.h"
+#include "reorder.h"
+#include "scene.h"
+#include "script.h"
+#include "shortest_path.h"
+#include "spatial_index.h"
+#include "trace.h"
+#include "viewport.h"
+
+using namespace std;
+
+/* --- Window / layout constants --- */
+const int WIN_W = 1000;
+const int WIN_H = 650;
+const int UI_H  = 70;
+const unsigned long DOUBLE_CLICK_MS = 400UL;
+
+/* --- Interaction modes --- */
+enum Mode {
+    MODE_ADD_NODE,
+    MODE_ADD_EDGE,
+    MODE_BFS,
+    MODE_DFS,
+    MODE_SSSP,
+    MODE_SELF_LOOP,
+    MODE_DELETE_NODE,
+    MODE_DELETE_EDGE,
+    MODE_NONE
+};
+
+/* --- Global state --- */
+static Graph graph;
+static vector<Node> &nodes = graph.nodes;
+static AdjList &adj = graph.adj;
+static Mode currentMode = MODE_ADD_NODE;
+static int selNode = -1;
+
+/* --- Undo/Redo history --- */
+static History history;
+
+/* --- Hit-test grid, kept in sync with `graph` through GraphObserver --- */
+static SpatialIndex spatial(NODE_RADIUS);
+
+/* --- Camera (viewport.h): the area under the toolbar shows the world
+   through `view`; arrow keys or a right-button drag pan, [ and ] zoom
+   about the mouse, H goes back to 1:1.  Far out, or where the view is
+   too dense, the graph is drawn from `bundles`. --- */
+static Viewport view;
+static GridBundles bundles;
+static bool viewBundled = false;            // how the current layer was drawn
+static const Rect VIEW_AREA = { 0, UI_H, WIN_W-1, WIN_H-1 };
+const int PAN_STEP = 80;
+const double ZOOM_STEP = 1.25;
+const int TEXT_PAD = 32;                    // text keeps its pixel size when zoomed out
+
+/* --- BFS/DFS playback: the traversal is recorded into `trace` on the
+   worker thread, against a frozen copy of the graph, and replayed by
+   `player` from the main loop while the rest is still arriving --- */
+static Trace trace;
+static TracePlayer player;
+static vector<int> traceChanged;
+static CsrSnapshot snapshot;
+static bool traceFirstStep = false;     // show the root as soon as its step arrives
+void wakeMainLoop();
+static AlgorithmWorker worker(wakeMainLoop);
+
+/* --- Auto-layout: a few iterations per frame from the main loop; the
+   positions from before it started are logged as one undoable move --- */
+static ForceLayout layout;
+static bool layoutRunning = false;
+static vector< pair<int,int> > layoutBefore, layoutFrame;
+const int LAYOUT_ITERS_PER_FRAME = 3;
+
+/* --- Components (C): nodes coloured by connected component, or strongly
+   connected component in a directed graph --- */
+static Connectivity components;
+static bool componentsShown = false;
+static unsigned shownComponents = 0;        // components.version() last painted
+static const int COMPONENT_COLORS[] = { LIGHTCYAN, LIGHTRED, LIGHTMAGENTA, CYAN, BROWN, LIGHTGRAY, MAGENTA };
+const int COMPONENT_COLOR_COUNT = sizeof(COMPONENT_COLORS)/sizeof(COMPONENT_COLORS[0]);
+
+/* --- Double buffering pages --- */
+static int activePage = 0;
+static int visualPage = 1;
+
+/* --- Graph options (stored on the graph, aliased for drawing code) --- */
+static bool &GLOBAL_WEIGHTED = graph.weighted;
+static bool &GLOBAL_DIRECTED = graph.directed;
+
+/* --- Double-click tracking --- */
+static unsigned long lastClickTime = 0;
+static int lastClickNode = -1;
+
+/* --- Utility: int -> string --- */
+string intToStr(int v) { stringstream ss; ss << v; return ss.str(); }
+
+/* --- Find node under a point (returns index or -1) --- */
+int findNodeAt(int mx, int my) {
+    PROFILE_SCOPE("hit test");
+    if(my <= UI_H) return -1;
+    return spatial.nodeAt(view.toWorldX(mx), view.toWorldY(my));
+}
+
+/* --- Screen area of a world rectangle, with room for unscaled text --- */
+Rect onScreen(const Rect &world){ return view.toScreen(world, view.scale < 1.0 ? TEXT_PAD : 0); }
+
+/* --- World rectangle behind a screen one, grown so that edges whose
+   weight box or arrow reaches into it are found too --- */
+Rect worldBehind(const Rect &screen){
+    Rect w = view.toWorld(screen);
+    int pad = (int)ceil(view.toWorldLen(TEXT_PAD));
+    return makeRect(w.x0-pad, w.y0-pad, w.x1+pad, w.y1+pad);
+}
+
+/* --- Simple rect hit test --- */
+bool pointInRect(int mx,int my,int x,int y,int w,int h) {
+    return mx >= x && mx <= x + w && my >= y && my <= y + h;
+}
+
+/* --- Toolbar buttons (index = hover id) --- */
+struct Button { int x, y, w, h; const char *text; };
+static const int BUTTON_COUNT = 10;
+static const Button BUTTONS[BUTTON_COUNT] = {
+    { 10,15,110,40,"Add Node"}, {130,15,110,40,"Add Edge"}, {250,15,80,40,"BFS"},  {340,15,80,40,"DFS"},
+    {430,15, 80,40,"Undo"},     {520,15, 80,40,"Redo"},     {610,15,100,40,"Self Loop"}, {730,15,80,40,"Clear"},
+    {820,15, 90,40,"Shortest"}, {920,15,70,40,"Layout"}
+};
+
+bool buttonActive(int i){
+    switch(i){
+        case 0: return currentMode==MODE_ADD_NODE;
+        case 1: return currentMode==MODE_ADD_EDGE;
+        case 2: return currentMode==MODE_BFS;
+        case 3: return currentMode==MODE_DFS;
+        case 6: return currentMode==MODE_SELF_LOOP;
+        case 8: return currentMode==MODE_SSSP;
+        case 9: return layoutRunning;
+    }
+    return false;
+}
+
+/* --- Input events and frame pacing ---
+   WinBGIm calls the mouse handlers on its window thread; they only note
+   that input arrived and wake the main loop, which reads the newest
+   position, so a burst of moves becomes one hover update.  Keys have no
+   notification, so an idle loop still wakes every KEY_POLL_MS to look at
+   kbhit().  Playback, layout and hover repaints run at most once per frame
+   period (--fps=N, 0 = uncapped); clicks and keys are handled at once. */
+const int DEFAULT_FPS = 60;
+const unsigned long KEY_POLL_MS = 10UL;
+static int64_t frameUs = 1000000/DEFAULT_FPS;
+static HANDLE inputEvent;
+static atomic<bool> mouseMoved(false);
+static atomic<int64_t> inputStampUs(0);     // first mouse event since the loop last looked
+static int64_t pendingInputUs = 0;          // input the next page flip answers, 0 if none
+
+static int64_t nowUs(){
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void noteInput(){
+    int64_t none = 0;
+    inputStampUs.compare_exchange_strong(none, nowUs());
+    SetEvent(inputEvent);
+}
+
+void wakeMainLoop(){ SetEvent(inputEvent); }
+
+void onMouseMove(int,int){ mouseMoved = true; noteInput(); }
+void onMouseDown(int,int){ noteInput(); }
+
+/* --- Right-button drag pans; the main loop applies it once per frame --- */
+static atomic<bool> rightDown(false);
+static atomic<int> dragX(0), dragY(0);
+
+void onRightDown(int x,int y){ dragX = x; dragY = y; rightDown = true; noteInput(); }
+void onRightUp(int,int){ rightDown = false; noteInput(); }
+
+/* --- Sleep until a mouse event arrives or ms milliseconds pass --- */
+void waitForInput(unsigned long ms){
+    PROFILE_SCOPE("idle");
+    WaitForSingleObject(inputEvent, ms);
+}
+
+/* --- Latency from an input event to the page flip that shows it, and the
+   process's CPU time: the F overlay shows both, the exit summary too --- */
+struct LatencyStats { int64_t count, sumUs, maxUs; };
+static LatencyStats latency = { 0, 0, 0 };
+
+void notePresented(){
+    if(!pendingInputUs) return;
+    int64_t us = nowUs() - pendingInputUs;
+    pendingInputUs = 0;
+    latency.count++; latency.sumUs += us; latency.maxUs = max(latency.maxUs, us);
+    PROFILE_GAUGE("input.latency_us", us);
+}
+
+static int64_t fileTimeUs(const FILETIME &ft){
+    return (int64_t)(((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime) / 10;
+}
+
+int64_t processCpuUs(){
+    FILETIME created, exited, kernel, user;
+    if(!GetProcessTimes(GetCurrentProcess(), &created, &exited, &kernel, &user)) return 0;
+    return fileTimeUs(kernel) + fileTimeUs(user);
+}
+
+/* --- Retained-mode redraw state ---
+   LAYER_PAGE caches the white canvas with every non-loop edge drawn on it.
+   A frame copies the damaged rectangles from that layer and repaints only
+   the toolbar, nodes and self-loops inside them.  With two display pages
+   the back page is one frame behind, so it also gets last frame's damage. */
+const int LAYER_PAGE = 2;
+static bool layerDirty = true;
+static DamageList damage, prevDamage;
+static int shownHoverNode = -1, shownHoverButton = -1;
+static FrameStats lastFrame;
+static vector<char> blitBuf;
+
+/* --- Primitive wrappers: translate into the clip viewport and count --- */
+static int vpX = 0, vpY = 0;
+static long framePrims = 0;
+
+void pLine(int x1,int y1,int x2,int y2){ line(x1-vpX,y1-vpY,x2-vpX,y2-vpY); framePrims++; }
+void pBar(int x1,int y1,int x2,int y2){ bar(x1-vpX,y1-vpY,x2-vpX,y2-vpY); framePrims++; }
+void pRect(int x1,int y1,int x2,int y2){ rectangle(x1-vpX,y1-vpY,x2-vpX,y2-vpY); framePrims++; }
+void pFillEllipse(int x,int y,int rx,int ry){ fillellipse(x-vpX,y-vpY,rx,ry); framePrims++; }
+void pCircle(int x,int y,int r){ circle(x-vpX,y-vpY,r); framePrims++; }
+void pEllipse(int x,int y,int rx,int ry){ ellipse(x-vpX,y-vpY,0,360,rx,ry); framePrims++; }
+void pText(int x,int y,const char *s){ outtextxy(x-vpX,y-vpY,(char*)s); framePrims++; }
+
+void setClip(const Rect &r){ setviewport(r.x0,r.y0,r.x1,r.y1,1); vpX=r.x0; vpY=r.y0; }
+void clearClip(){ setviewport(0,0,WIN_W-1,WIN_H-1,1); vpX=0; vpY=0; }
+
+/* --- Draw a toolbar button --- */
+void drawButton(int x,int y,int w,int h,const char *txt,bool active,bool hover) {
+    int fill = active ? LIGHTCYAN : (hover ? LIGHTGRAY+2 : LIGHTGRAY);
+    setfillstyle(SOLID_FILL, fill);
+    pBar(x,y,x+w,y+h);
+    setcolor(BLACK);
+    pRect(x,y,x+w,y+h);
+    setbkcolor(fill);
+    pText(x+10, y + (h/2 - textheight((char*)txt)/2), txt);
+}
+
+/* --- Draw the UI toolbar --- */
+void drawUI(int hoverButtonIndex) {
+    setfillstyle(SOLID_FILL, LIGHTGRAY);
+    pBar(0, 0, WIN_W, UI_H);
+    pRect(0,0,WIN_W-1,UI_H-1);
+
+    for(int i=0;i<BUTTON_COUNT;i++){
+        const Button &b = BUTTONS[i];
+        drawButton(b.x,b.y,b.w,b.h,b.text, buttonActive(i), hoverButtonIndex==i);
+    }
+
+    setcolor(BLACK);
+    setbkcolor(LIGHTGRAY);
+    pText(10,3,GLOBAL_WEIGHTED ? "Weighted: YES" : "Weighted: NO");
+    pText(130,3,GLOBAL_DIRECTED ? "Directed: YES" : "Directed: NO");
+    char buf[32];
+    snprintf(buf, sizeof buf, "Zoom %d%%%s", (int)(view.scale*100+0.5), viewBundled ? " bundled" : "");
+    pText(250,3,buf);
+}
+
+/* --- Canvas over WinBGIm: the scene code (scene.h) draws through the
+   viewport-translating, counting wrappers above --- */
+class BgiCanvas : public Canvas {
+public:
+    void setColor(int c){ setcolor(c); }
+    void setFillColor(int c){ setfillstyle(SOLID_FILL, c); }
+    void setTextBackground(int c){ setbkcolor(c); }
+    void setLineWidth(int w){ setlinestyle(SOLID_LINE, 0, w); }
+    void line(int x1,int y1,int x2,int y2){ pLine(x1,y1,x2,y2); }
+    void bar(int x1,int y1,int x2,int y2){ pBar(x1,y1,x2,y2); }
+    void rect(int x1,int y1,int x2,int y2){ pRect(x1,y1,x2,y2); }
+    void fillEllipse(int x,int y,int rx,int ry){ pFillEllipse(x,y,rx,ry); }
+    void circle(int x,int y,int r){ pCircle(x,y,r); }
+    void ellipse(int x,int y,int rx,int ry){ pEllipse(x,y,rx,ry); }
+    void text(int x,int y,const char *s){ pText(x,y,s); }
+    int textWidth(const char *s){ return textwidth((char*)s); }
+    int textHeight(const char *s){ return textheight((char*)s); }
+};
+static BgiCanvas bgi;
+static SceneText sceneText;     // labels and weights interned with their BGI text sizes
+
+/* --- A node's fill: hover, then traversal state, then component --- */
+int nodeFill(int i){
+    if(i==shownHoverNode) return YELLOW;
+    if(nodes[i].visited) return LIGHTGREEN;
+    if(player.state(i)==TracePlayer::FRONTIER) return LIGHTBLUE;
+    if(componentsShown) return COMPONENT_COLORS[components.component(i) % COMPONENT_COLOR_COUNT];
+    return LIGHTCYAN;
+}
+
+/* --- Draw one node disk with its label --- */
+void drawNode(int i){ drawNode(bgi, graph, i, nodeFill(i), &sceneText, &view); }
+
+/* --- Rebuild the cached layer: white canvas + the non-loop edges in
+   view, or the bundled graph when the view is aggregated --- */
+void rebuildLayer(){
+    PROFILE_SCOPE("draw.layer");
+    setactivepage(LAYER_PAGE);
+    clearClip();
+    setfillstyle(SOLID_FILL, WHITE);
+    pBar(0,UI_H,WIN_W,WIN_H);
+    setClip(VIEW_AREA);
+    Rect world = worldBehind(VIEW_AREA);
+    bool bundled = viewAggregated(spatial, view, world);
+    if(bundled) drawBundles(bgi, bundles, graph, view, world);
+    else drawEdgesInView(bgi, graph, spatial, view, world, &sceneText);
+    clearClip();
+    if(bundled != viewBundled) damage.add(makeRect(0,0,WIN_W,14));     // zoom label
+    viewBundled = bundled;
+    layerDirty = false;
+}
+
+/* --- Copy a rectangle of the cached layer onto the active page --- */
+void blitLayer(const Rect &r){
+    unsigned sz = imagesize(r.x0,r.y0,r.x1,r.y1);
+    if(blitBuf.size() < sz) blitBuf.resize(sz);
+    setactivepage(LAYER_PAGE);
+    getimage(r.x0,r.y0,r.x1,r.y1,&blitBuf[0]);
+    setactivepage(activePage);
+    putimage(r.x0,r.y0,&blitBuf[0],COPY_PUT);
+    framePrims++;
+}
+
+/* --- Nodes and self-loops inside the visible part of r (self-loops on
+   top), each in id order like a full redraw.  A bundled view has its
+   nodes in the layer; only coloured ones are marked, and only where
+   something changed. --- */
+void drawSceneOverlay(const Rect &r, bool everything){
+    static vector<int> ids;                 // reused: a steady frame allocates nothing
+    Rect w = view.toWorld(r);
+    if(viewBundled){
+        if(everything) return;
+        spatial.nodesInRect(w.x0,w.y0,w.x1,w.y1,ids);
+        sort(ids.begin(),ids.end());
+        setcolor(DARKGRAY);
+        for(int k=0;k<(int)ids.size();k++){
+            int fill = nodeFill(ids[k]);
+            if(fill==LIGHTCYAN) continue;
+            setfillstyle(SOLID_FILL, fill);
+            pFillEllipse(view.toScreenX(nodes[ids[k]].x), view.toScreenY(nodes[ids[k]].y), 3, 3);
+        }
+        return;
+    }
+    spatial.nodesInRect(w.x0,w.y0,w.x1,w.y1,ids);
+    sort(ids.begin(),ids.end());
+    for(int k=0;k<(int)ids.size();k++) drawNode(ids[k]);
+
+    /* a loop sits up and to the right of its node, so widen the search */
+    int reach = 3*NODE_RADIUS + 40;
+    spatial.nodesInRect(w.x0-reach,w.y0-reach,w.x1+reach,w.y1+reach,ids);
+    sort(ids.begin(),ids.end());
+    for(int k=0;k<(int)ids.size();k++){
+        int i = ids[k];
+        if(!graph.hasSelfLoop(i)) continue;
+        if(!rectsOverlap(r, onScreen(selfLoopBounds(nodes[i],NODE_RADIUS,GLOBAL_WEIGHTED)))) continue;
+        drawSelfLoop(bgi, graph, i, &sceneText, &view);
+    }
+}
+
+/* --- Everything above the layer inside r: the scene clipped to the view
+   area, then the toolbar over it --- */
+void drawOverlay(const Rect &r, bool everything){
+    Rect scene;
+    if(rectIntersect(r, VIEW_AREA, scene)){
+        setClip(scene);
+        drawSceneOverlay(scene, everything);
+        if(everything) clearClip(); else setClip(r);
+    }
+    if(r.y0 <= UI_H) drawUI(shownHoverButton);
+}
+
+/* --- Profiler overlay (F): one row under the buttons, refreshed a few
+   times a second from the profiler's half-second averages --- */
+static bool statsShown = false;
+static unsigned long statsTick = 0;
+const unsigned long STATS_REFRESH_MS = 250UL;
+const int STATS_Y = 57;
+
+static double zoneMsOf(const char *name){
+    int z = profiler().findZone(name);
+    return z<0 ? 0.0 : profiler().zoneMs(z);
+}
+
+static double counterOf(const char *name){
+    int c = profiler().findCounter(name);
+    return c<0 ? 0.0 : profiler().counterValue(c);
+}
+
+/* undirected edges are stored in both rows, self-loops once */
+static int edgeTotal(){
+    int entries = (int)graph.index.size();
+    if(GLOBAL_DIRECTED) return entries;
+    int loops = 0;
+    for(int i=0;i<graph.slotCount();i++) if(graph.hasSelfLoop(i)) loops++;
+    return (entries + loops)/2;
+}
+
+void sampleGauges(){
+    PROFILE_GAUGE("graph.nodes", graph.nodeCount);
+    PROFILE_GAUGE("graph.edges", edgeTotal());
+    PROFILE_GAUGE("history.bytes", (int64_t)history.bytesUsed());
+
+    static int64_t lastCpu = processCpuUs(), lastWall = nowUs();
+    int64_t cpu = processCpuUs(), wall = nowUs();
+    if(wall > lastWall) PROFILE_GAUGE("process.cpu_permille", (cpu - lastCpu)*1000/(wall - lastWall));
+    lastCpu = cpu; lastWall = wall;
+}
+
+void drawProfileStats(){
+    Profiler &p = profiler();
+    char buf[192];
+    snprintf(buf, sizeof buf, "%.0f fps %.2f ms busy | draw %.2f hit %.2f in %.2f trav %.2f hist %.2f | V %.0f E %.0f undo %.0fK | cpu %.1f%% lat %.1f ms alloc %.0f",
+             p.fps(), p.frameMs() - zoneMsOf("idle"), zoneMsOf("draw"), zoneMsOf("hit test"), zoneMsOf("input"),
+             zoneMsOf("traversal.record") + zoneMsOf("traversal.step"),
+             zoneMsOf("history.edit") + zoneMsOf("history.undo") + zoneMsOf("history.redo"),
+             counterOf("graph.nodes"), counterOf("graph.edges"), counterOf("history.bytes")/1024.0,
+             counterOf("process.cpu_permille")/10.0, counterOf("input.latency_us")/1000.0,
+             counterOf("draw.allocs"));
+    setcolor(p.tracing() ? RED : BLACK);
+    setbkcolor(LIGHTGRAY);
+    setfillstyle(SOLID_FILL, LIGHTGRAY);
+    bar(2,STATS_Y,WIN_W-2,STATS_Y+10);
+    outtextxy(10,STATS_Y+1,buf);
+}
+
+/* --- Redraw report in the toolbar: primitives issued by the last frame --- */
+void drawFrameStats(){
+    setcolor(BLACK);
+    setbkcolor(LIGHTGRAY);
+    setfillstyle(SOLID_FILL, LIGHTGRAY);
+    char buf[64];
+    if(lastFrame.full) snprintf(buf, sizeof buf, "Redraw: %ld prims, full", lastFrame.prims);
+    else snprintf(buf, sizeof buf, "Redraw: %ld prims, %d rects", lastFrame.prims, lastFrame.rects);
+    bar(400,2,WIN_W-2,12);
+    outtextxy(400,3,buf);
+    if(player.loaded()){
+        snprintf(buf, sizeof buf, "Trace %d/%d%s @%d/s%s", (int)player.position(), (int)player.length(),
+                 worker.finished() ? "" : "+", (int)(player.speed()+0.5), player.isPaused() ? " ||" : "");
+        outtextxy(740,3,buf);
+    }
+    if(componentsShown){
+        snprintf(buf, sizeof buf, "%s%d", GLOBAL_DIRECTED ? "SCCs: " : "Comps: ", components.componentCount());
+        outtextxy(730-textwidth(buf),3,buf);     // left of the trace position
+    }
+    if(statsShown) drawProfileStats();
+}
+
+/* --- Present the damaged regions (or everything) and flip pages --- */
+void present(){
+    if(componentsShown && components.version()!=shownComponents){ shownComponents = components.version(); damage.addAll(); }
+    if(damage.empty() && prevDamage.empty() && !layerDirty) return;
+    PROFILE_SCOPE("draw");
+    int64_t allocs = heapAllocations();
+    if(layerDirty){ rebuildLayer(); damage.addAll(); }
+    setactivepage(activePage);
+    clearClip();
+
+    static DamageList todo;                 // reused, like ids in drawOverlay
+    todo = damage;
+    todo.merge(prevDamage);
+    Rect screen = makeRect(0,0,WIN_W-1,WIN_H-1);
+    int rects = 0;
+    if(todo.isFull()){
+        blitLayer(screen);
+        drawOverlay(screen, true);
+    } else {
+        const vector<Rect> &rs = todo.rects();
+        for(int i=0;i<(int)rs.size();i++){
+            Rect r;
+            if(!rectIntersect(rs[i], screen, r)) continue;
+            blitLayer(r);
+            setClip(r);
+            drawOverlay(r, false);
+            clearClip();
+            rects++;
+        }
+    }
+    lastFrame.prims = framePrims;
+    lastFrame.rects = rects;
+    lastFrame.full = todo.isFull();
+    drawFrameStats();
+
+    setvisualpage(activePage);
+    notePresented();
+    activePage = 1-activePage;
+    visualPage = 1-visualPage;
+    prevDamage = damage;
+    damage.clear();
+    PROFILE_COUNT("draw.prims", framePrims);
+    PROFILE_COUNT("draw.allocs", heapAllocations() - allocs);
+    framePrims = 0;
+}
+
+/* --- Damage helpers --- */
+void damageNode(int i){
+    if(!graph.isAlive(i)) return;
+    damage.add(onScreen(nodeBounds(nodes[i],NODE_RADIUS)));
+}
+
+void damageButton(int b){
+    if(b<0) return;
+    const Button &bt = BUTTONS[b];
+    damage.add(makeRect(bt.x,bt.y,bt.x+bt.w,bt.y+bt.h));
+}
+
+/* --- Drop any BFS/DFS playback (its node ids may no longer be valid),
+   cancelling the recording if it is still running --- */
+static int pathSource = -1, pathTarget = -1;     // a path search the worker is running
+static bool eccentricityPending = false;        // D's search, likewise
+
+void stopPlayback(){
+    if(pathTarget>=0 || eccentricityPending){
+        worker.cancel();
+        pathSource = pathTarget = -1;
+        eccentricityPending = false;
+    }
+    if(!player.loaded()) return;
+    worker.cancel();
+    player.unload();
+    for(int i=0;i<graph.slotCount();i++) nodes[i].visited=false;
+    damage.addAll();
+}
+
+/* --- A structural change the layer can't patch: rebuild it, repaint all --- */
+void invalidateAll(){ stopPlayback(); layerDirty = true; damage.addAll(); }
+
+/* --- Full redraw: layer (edges), toolbar, nodes, self-loops on top --- */
+void drawAll(){
+    damage.addAll();
+    present();
+}
+
+/* --- A new edge is drawn straight onto the layer; only its area repaints
+   (a bundled layer is redrawn: the new edge may join a bundle) --- */
+void drawNewEdge(int u,int v,int w){
+    if(u==v){ damage.add(onScreen(selfLoopBounds(nodes[u],NODE_RADIUS,GLOBAL_WEIGHTED))); return; }
+    if(viewBundled){ layerDirty = true; return; }
+    if(!layerDirty){
+        setactivepage(LAYER_PAGE);
+        setClip(VIEW_AREA);
+        if(GLOBAL_DIRECTED || v>u) drawEdge(bgi,graph,u,v,w,&sceneText,&view); else drawEdge(bgi,graph,v,u,w,&sceneText,&view);
+        clearClip();
+    }
+    damage.add(onScreen(edgeBounds(nodes[u],nodes[v],NODE_RADIUS,GLOBAL_WEIGHTED,GLOBAL_DIRECTED)));
+}
+
+/* --- The camera moved: every pixel of the scene changes, but playback,
+   selection and layout carry on --- */
+void viewChanged(){
+    layerDirty = true;
+    damage.addAll();
+    present();
+}
+
+/* --- [ / ]: zoom about the mouse when it is over the scene, else about
+   the middle of the view --- */
+void zoomView(double factor){
+    int mx = mousex(), my = mousey();
+    if(mx < 0 || mx >= WIN_W || my <= UI_H || my >= WIN_H){ mx = WIN_W/2; my = (UI_H+WIN_H)/2; }
+    view.zoomAbout(mx, my, factor);
+    viewChanged();
+}
+
+/* --- View keys: arrows pan (extended codes after a 0 or 224 prefix),
+   [ ] zoom, H resets --- */
+bool handleViewKey(int key){
+    if(key==0 || key==224){
+        switch(getch()){
+            case 72: view.panBy(0, PAN_STEP); break;
+            case 80: view.panBy(0, -PAN_STEP); break;
+            case 75: view.panBy(PAN_STEP, 0); break;
+            case 77: view.panBy(-PAN_STEP, 0); break;
+            default: return true;
+        }
+        viewChanged();
+        return true;
+    }
+    switch(key){
+        case ']': zoomView(ZOOM_STEP); return true;
+        case '[': zoomView(1.0/ZOOM_STEP); return true;
+        case 'h': case 'H': view.reset(); viewChanged(); return true;
+    }
+    return false;
+}
+
+/* --- BFS / DFS visualization helpers --- */
+void resetVisited(){ for(int i=0;i<graph.slotCount();i++) nodes[i].visited=false; damage.addAll(); }
+
+/* --- Push the player's state changes into the nodes and repaint them --- */
+void applyTraceChanges(){
+    for(int k=0;k<(int)traceChanged.size();k++){
+        int v=traceChanged[k];
+        if(!graph.isAlive(v)) continue;
+        nodes[v].visited = player.state(v)==TracePlayer::DONE;
+        damageNode(v);
+    }
+    traceChanged.clear();
+    damage.add(makeRect(400,0,WIN_W,14));    // trace position in the toolbar
+    present();
+}
+
+/* --- Hand the traversal to the worker and start replaying it; a run
+   already in progress is abandoned (another root restarts it) --- */
+void startPlayback(AlgoKind kind,int start){
+    stopPlayback();
+    resetVisited();
+    {
+        PROFILE_SCOPE("traversal.record");
+        trace.clear(graph.vertexCount());
+        worker.start(kind, start, snapshot, graph);     // freezes on the worker after an edit
+    }
+    player.load(trace);
+    player.play();
+    traceFirstStep = true;
+    applyTraceChanges();
+}
+
+void collectSearch();
+
+/* --- Append what the worker has recorded since the last call --- */
+void collectTrace(){
+    if(pathTarget>=0 || eccentricityPending){ collectSearch(); return; }
+    if(!player.loaded()) return;
+    bool added;
+    { PROFILE_SCOPE("traversal.record"); added = worker.collect(trace); }
+    if(!added) return;
+    if(traceFirstStep && trace.steps>0){ traceFirstStep = false; player.step(traceChanged); }
+    applyTraceChanges();
+}
+
+/* --- Esc: stop a recording still in progress (what arrived stays) --- */
+bool cancelTraversal(){
+    if(pathTarget>=0 || eccentricityPending){
+        stopPlayback();
+        cout<<"Search cancelled"<<endl;
+        return true;
+    }
+    if(!player.loaded() || worker.finished()) return false;
+    worker.cancel();
+    cout<<"Traversal cancelled after "<<trace.steps<<" steps"<<endl;
+    damage.add(makeRect(400,0,WIN_W,14));
+    present();
+    return true;
+}
+
+void BFS_visual(int start){ startPlayback(ALGO_BFS,start); }
+
+void DFS_visual(int start){ startPlayback(ALGO_DFS,start); }
+
+/* --- Shortest paths: the first click replays Dijkstra's settle order from
+   the source (the shortest-path tree growing), the second click marks the
+   path to the target.  The second reads the tree the worker kept from the
+   first when the graph is unchanged; otherwise the worker searches the
+   current snapshot again and collectPath marks the path when it is done,
+   so neither click waits for a search. --- */
+void SSSP_visual(int source){ startPlayback(ALGO_SSSP,source); }
+
+void markPath(const SsspResult &sssp,int source,int target){
+    vector<int> path;
+    shortestPath(sssp, target, path);
+    resetVisited();
+    for(size_t k=0;k<path.size();k++) if(graph.isAlive(path[k])) nodes[path[k]].visited=true;
+    if(path.empty()){
+        cout<<"No path from "<<nodes[source].label<<" to "<<nodes[target].label<<endl;
+    } else {
+        cout<<"Distance "<<sssp.dist[target]<<":";
+        for(size_t k=0;k<path.size();k++) cout<<(k ? " -> " : " ")<<nodes[path[k]].label;
+        cout<<endl;
+    }
+    present();
+}
+
+void showShortestPath(int source,int target){
+    shared_ptr<const AlgoResult> done = worker.result();
+    bool reuse = done && done->kind==ALGO_SSSP && done->start==source &&
+                 snapshot.current(graph) && snapshot.get(graph)==done->graph;
+    stopPlayback();
+    if(reuse){ markPath(done->sssp, source, target); return; }
+    resetVisited();
+    present();
+    pathSource = source; pathTarget = target;
+    worker.start(ALGO_PATH, source, snapshot, graph);
+}
+
+/* --- D: every node's eccentricity from one bit-parallel multi-source BFS
+   (multi_bfs.h) over the snapshot, run by the worker (Esc cancels); the
+   centre (eccentricity == radius) is marked when it is done --- */
+void showEccentricity(){
+    if(graph.nodeCount==0) return;
+    vector<int32_t> live;
+    for(int i=0;i<graph.slotCount();i++) if(nodes[i].alive) live.push_back(i);
+    stopPlayback();
+    resetVisited();
+    present();
+    cout<<"Eccentricities of "<<live.size()<<" nodes... (Esc cancels)"<<endl;
+    eccentricityPending = true;
+    worker.startEccentricity(live, snapshot, graph);
+}
+
+void markCentre(const MultiBfsResult &ms){
+    resetVisited();
+    cout<<"Diameter "<<ms.diameter<<", radius "<<ms.radius;
+    if(components.componentCount()>1) cout<<(GLOBAL_DIRECTED ? " (not strongly connected:" : " (not connected:")<<" over reachable pairs only)";
+    cout<<"; centre:";
+    for(size_t k=0;k<ms.sources.size();k++)
+        if(ms.eccentricity[k]==ms.radius && graph.isAlive(ms.sources[k])){
+            nodes[ms.sources[k]].visited=true;
+            cout<<" "<<nodes[ms.sources[k]].label;
+        }
+    cout<<endl;
+    present();
+}
+
+/* --- A path search's or D's result, once the worker has it --- */
+void collectSearch(){
+    Trace none;
+    worker.collect(none);
+    if(!worker.finished()) return;
+    shared_ptr<const AlgoResult> done = worker.result();
+    int source = pathSource, target = pathTarget;
+    pathSource = pathTarget = -1;
+    eccentricityPending = false;
+    if(!done) return;
+    if(done->kind==ALGO_ECCENTRICITY) markCentre(done->eccentricity);
+    else if(graph.isAlive(source) && graph.isAlive(target)) markPath(done->sssp, source, target);
+}
+
+/* --- O: renumber the nodes so neighbours get nearby ids (reorder.h),
+   cycling RCM -> degree -> BFS order.  Labels stay on their nodes, so the
+   picture does not change; undo puts the old ids back. --- */
+static int nextOrder = ORDER_RCM;
+
+void reorderNodes(){
+    if(graph.nodeCount==0) return;
+    VertexOrder kind = (VertexOrder)nextOrder;
+    nextOrder = (nextOrder+1) % 3;
+    vector<int> perm;
+    OrderProfile before;
+    {
+        CsrGraph csr = buildCsr(graph);
+        before = orderProfile(csr.view());
+        computeVertexOrder(csr.view(), kind, perm);
+    }
+    selNode = -1;
+    history.permute(graph, perm);
+    OrderProfile after = orderProfile(buildCsr(graph).view());
+    cout<<"Reordered ("<<vertexOrderName(kind)<<"): bandwidth "<<before.bandwidth<<" -> "<<after.bandwidth
+        <<", mean id gap "<<before.meanGap<<" -> "<<after.meanGap<<endl;
+    invalidateAll(); present();
+}
+
+/* --- Auto-layout --- */
+void startLayout(){
+    if(graph.nodeCount==0) return;
+    stopPlayback();
+    layoutBefore.resize(graph.slotCount());
+    for(int i=0;i<graph.slotCount();i++) layoutBefore[i]=make_pair(nodes[i].x,nodes[i].y);
+    layout.start(graph);
+    layoutRunning = true;
+}
+
+/* --- Copy the layout, fitted to the canvas, into the graph and repaint
+   (loops sit up and to the right of their node, hence the wider margin) --- */
+void showLayout(){
+    layoutFrame.resize(graph.slotCount());
+    for(int i=0;i<graph.slotCount();i++) layoutFrame[i]=make_pair(nodes[i].x,nodes[i].y);
+    Rect w = view.toWorld(VIEW_AREA);        // fitted to what is in view
+    layout.fit(w.x0+NODE_RADIUS+10, w.y0+3*NODE_RADIUS+10, w.x1+1-3*NODE_RADIUS-10, w.y1+1-NODE_RADIUS-10, layoutFrame);
+    graph.swapPositions(layoutFrame);
+    invalidateAll();
+    present();
+}
+
+/* --- Any edit stops the layout first, so the logged move is complete --- */
+void stopLayout(){
+    if(!layoutRunning) return;
+    layoutRunning = false;
+    history.moveNodes(graph, layoutBefore);
+    damageButton(9);
+    present();
+}
+
+/* --- C: colour nodes by component --- */
+void toggleComponents(){
+    componentsShown = !componentsShown;
+    if(componentsShown) cout<<components.componentCount()<<(GLOBAL_DIRECTED ? " strongly connected" : " connected")<<" components"<<endl;
+    damage.addAll();
+    present();
+}
+
+/* --- F: stats overlay; T: start / stop a Chrome trace (written to
+   trace.json).  The profiler only runs while either is on. --- */
+static const char *TRACE_FILE = "trace.json";
+
+void toggleStats(){
+    statsShown = !statsShown;
+    profiler().enabled = statsShown || profiler().tracing();
+    damage.add(makeRect(0,0,WIN_W,UI_H));
+    present();
+}
+
+void toggleTrace(){
+    Profiler &p = profiler();
+    if(!p.tracing()){
+        p.startTrace();
+        cout<<"Tracing to "<<TRACE_FILE<<" (T again to stop)"<<endl;
+    } else {
+        size_t n = p.traceEvents();
+        string err;
+        if(p.stopTrace(TRACE_FILE, &err)) cout<<"Wrote "<<n<<" trace events to "<<TRACE_FILE<<endl;
+        else cout<<"Trace failed: "<<err<<endl;
+        p.enabled = statsShown;
+    }
+    damage.add(makeRect(0,STATS_Y,WIN_W,STATS_Y+10));
+    present();
+}
+
+/* --- Playback keys: space pause, . / , step, + / - speed, b / e seek --- */
+bool handlePlaybackKey(int ch){
+    if(!player.loaded()) return false;
+    switch(ch){
+        case ' ': if(player.isPaused()) player.play(); else player.pause(); break;
+        case '.': player.pause(); player.step(traceChanged); break;
+        case ',': player.pause(); player.stepBack(traceChanged); break;
+        case '+': case '=': player.setSpeed(player.speed()*2); break;
+        case '-': player.setSpeed(player.speed()/2); break;
+        case 'b': case 'B': player.seek(0,traceChanged); break;
+        case 'e': case 'E': player.skipToEnd(traceChanged); break;
+        default: return false;
+    }
+    applyTraceChanges();
+    return true;
+}
+
+/* --- Find an edge near a point (for delete); returns (u, index in adj[u]).
+   Undirected edges are reported from their lower endpoint, matching the
+   copy drawAll draws. --- */
+pair<int,int> findEdgeNear(int mx,int my,double threshold=8.0){
+    PROFILE_SCOPE("hit test");
+    if(my <= UI_H) return make_pair(-1,-1);
+    pair<int,int> e = spatial.edgeNear(view.toWorldX(mx),view.toWorldY(my),view.toWorldLen(threshold));
+    if(e.first<0) return make_pair(-1,-1);
+    int u=e.first, v=e.second;
+    if(!GLOBAL_DIRECTED && v<u) swap(u,v);
+    int k = graph.findEdge(u,v);
+    return k>=0 ? make_pair(u,k) : make_pair(-1,-1);
+}
+
+/* --- Undo / redo implementation --- */
+void doUndo(){
+    bool done;
+    { PROFILE_SCOPE("history.undo"); done = history.undo(graph); }
+    if(done){ invalidateAll(); present(); }
+}
+
+void doRedo(){
+    bool done;
+    { PROFILE_SCOPE("history.redo"); done = history.redo(graph); }
+    if(done){ invalidateAll(); present(); }
+}
+
+/* --- Save / load (S / L keys, or a file named on the command line) --- */
+static const char *GRAPH_FILE = "graph.gvg";
+
+static void reportIo(const char *what, const char *path, const IoStats &st){
+    cout<<what<<" "<<path<<": "<<st.edges<<" edges, "<<st.bytes<<" bytes in "
+        <<st.seconds*1000.0<<" ms ("<<(int64_t)st.edgesPerSecond()<<" edges/s)"<<endl;
+}
+
+void saveToFile(const char *path){
+    IoStats st; string err;
+    if(saveGraph(path, graph, &st, &err)) reportIo("Saved", path, st);
+    else cout<<"Save failed: "<<err<<endl;
+}
+
+/* --- P: the same scene through the headless rasterizer, as a PNG --- */
+static const char *IMAGE_FILE = "graph.png";
+
+void exportImage(const char *path){
+    unsigned long t0 = GetTickCount();
+    SoftCanvas img(WIN_W, WIN_H);
+    img.clear(WHITE);
+    drawScene(img, graph, 0, &view);
+    img.flush();
+    string err;
+    if(img.savePNG(path, &err)) cout<<"Exported "<<path<<" in "<<GetTickCount()-t0<<" ms"<<endl;
+    else cout<<"Export failed: "<<err<<endl;
+}
+
+/* --- X (or --script=FILE at startup): run a batch command script; each
+   batch is one undo step and one repaint, and the last bfs/dfs it asks
+   for is replayed afterwards --- */
+static const char *SCRIPT_FILE = "script.txt";
+
+class EditorScriptHost : public ScriptHost {
+public:
+    int start;
+    bool bfs;
+    EditorScriptHost(): start(-1), bfs(true) {}
+    void batchApplied(const Graph &){ invalidateAll(); present(); }
+    void traverse(const Graph &, bool b, int s){ bfs = b; start = s; }
+};
+
+void runScriptCommands(const char *path){
+    stopLayout();
+    selNode = -1;
+    EditorScriptHost host;
+    ScriptStats st; string err;
+    bool ok = runScriptFile(path, graph, history, &host, &st, &err);
+    cout<<"Script "<<path<<": "<<st.commands<<" commands in "<<st.batches<<" batches, "
+        <<st.seconds*1000.0<<" ms ("<<(int64_t)st.commandsPerSecond()<<" commands/s)"<<endl;
+    if(!ok) cout<<"Script stopped: "<<err<<endl;
+    if(host.start>=0 && graph.isAlive(host.start)) startPlayback(host.bfs ? ALGO_BFS : ALGO_DFS, host.start);
+}
+
+/* --- Text formats carry no flags: the current directed/weighted settings apply --- */
+bool loadFromFile(const char *path){
+    vector<Node> ns; AdjList as;
+    bool d = GLOBAL_DIRECTED, w = GLOBAL_WEIGHTED;
+    IoStats st; string err;
+    if(!loadGraph(path, ns, as, d, w, &st, &err)){ cout<<"Load failed: "<<err<<endl; return false; }
+    reportIo("Loaded", path, st);
+    history.replace(graph, ns, as, d, w);
+    invalidateAll(); present();
+    return true;
+}
+
+/* --- Popup: ask the user for edge weight
+     (Centered text in the input box; popup clamped to window.) --- */
+int popupGetWeight(int px,int py){
+    int boxW=260, boxH=100;
+    int bx = px - boxW/2;
+    int by = py - boxH/2;
+
+    if(bx < 10) bx = 10;
+    if(bx + boxW > WIN_W - 10) bx = WIN_W - boxW - 10;
+    if(by + boxH > WIN_H - 20) by = WIN_H - boxH - 20;
+    if(by < UI_H + 20) by = UI_H + 20;
+
+    string text = "";
+    bool done=false, canceled=false;
+    settextstyle(3,0,2);
+    setbkcolor(LIGHTGRAY);
+
+    setactivepage(activePage);
+    setvisualpage(activePage);
+
+    bool dirty=true;
+    while(!done){
+        /* redraw only after a key changed the text; sleep in between */
+        if(!dirty){
+            if(!kbhit()){ waitForInput(KEY_POLL_MS); continue; }
+            int c = getch();
+            if(c==13){ if(!text.empty()) done=true; }
+            else if(c==27){ canceled=true; done=true; }
+            else if(c==8){ if(!text.empty()) text.erase(text.size()-1); }
+            else if(c>='0' && c<='9' && text.size()<6) text.push_back((char)c);
+            dirty=true;
+            continue;
+        }
+        dirty=false;
+        setactivepage(activePage);
+
+        // draw popup background
+        setfillstyle(SOLID_FILL,LIGHTGRAY);
+        bar(bx,by,bx+boxW,by+boxH);
+        setcolor(BLACK);
+        rectangle(bx,by,bx+boxW,by+boxH);
+
+        // title
+        outtextxy(bx+10, by+10, (char*)"Enter Edge Weight (digits)");
+
+        // input field rectangle
+        int inputY = by + 40, inputH = 30;
+        rectangle(bx+10, inputY, bx+boxW-10, inputY+inputH);
+
+        // centered display text inside the input rectangle (horizontally + vertically)
+        string display = text.empty() ? "" : text;
+        int tw = textwidth((char*)display.c_str());
+        int th = textheight((char*)display.c_str());
+        int tx = bx + (boxW - tw) / 2;                     // center horizontally
+        int ty = inputY + (inputH - th) / 2;               // center vertically
+        outtextxy(tx, ty, (char*)display.c_str());
+
+        setvisualpage(activePage);
+    }
+
+    settextstyle(DEFAULT_FONT,0,1);
+    if(canceled) return -1;
+    int val=1; stringstream ss(text); ss>>val; if(val<=0) val=1;
+    return val;
+}
+
+/* --- Program entry: initialize, main loop, input handling --- */
+int main(int argc,char **argv){
+    const char *startFile = 0, *startScript = 0;
+    for(int i=1;i<argc;i++){
+        if(!strncmp(argv[i],"--fps=",6)){ int fps = atoi(argv[i]+6); frameUs = fps>0 ? 1000000/fps : 0; }
+        else if(!strncmp(argv[i],"--script=",9)) startScript = argv[i]+9;
+        else startFile = argv[i];
+    }
+    string sf = startFile ? startFile : "";
+    bool flagsInFile = sf.size()>4 && sf.compare(sf.size()-4,4,".gvg")==0;
+    int wchoice=0, dchoice=0;
+    while(!flagsInFile){ cout<<"Weighted graph? (1=Yes,0=No): "; if(cin>>wchoice && (wchoice==0||wchoice==1)) break; cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); }
+    while(!flagsInFile){ cout<<"Directed graph? (1=Yes,0=No): "; if(cin>>dchoice && (dchoice==0||dchoice==1)) break; cin.clear(); cin.ignore(numeric_limits<streamsize>::max(),'\n'); }
+    GLOBAL_WEIGHTED = (wchoice==1);
+    GLOBAL_DIRECTED = (dchoice==1);
+
+    initwindow(WIN_W, WIN_H, "Graph Editor - Dev-C++ / WinBGIm");
+    activePage=0; visualPage=1; setactivepage(activePage); setvisualpage(visualPage); cleardevice();
+
+    graph.clear(); currentMode=MODE_ADD_NODE; selNode=-1;
+    history.reset();
+    spatial.rebuild(graph);
+    graph.addObserver(&spatial);
+    components.rebuild(graph);
+    graph.addObserver(&components);
+    graph.addObserver(&sceneText);
+    graph.addObserver(&snapshot);
+    graph.addObserver(&bundles);
+
+    drawAll();
+    if(startFile && loadFromFile(startFile)) history.reset();
+    if(startScript) runScriptCommands(startScript);
+
+    inputEvent = CreateEvent(0, FALSE, FALSE, 0);
+    registermousehandler(WM_MOUSEMOVE, onMouseMove);
+    registermousehandler(WM_LBUTTONDOWN, onMouseDown);
+    registermousehandler(WM_RBUTTONDOWN, onRightDown);
+    registermousehandler(WM_RBUTTONUP, onRightUp);
+    timeBeginPeriod(1);                         // 1 ms timer resolution for the waits
+    int64_t startUs = nowUs(), startCpu = processCpuUs();
+
+    int prevHoverNode=-1, prevHoverButton=-1;
+    int64_t lastAnimUs = nowUs(), nextFrameUs = lastAnimUs;
+    bool hoverPending = true;
+    bool running=true;
+    while(running){
+        /* sleep until a mouse event, the next key poll, or (while something
+           animates or a hover update waits) the next frame */
+        bool animating = (player.loaded() && !player.isPaused() && !player.atEnd()) || layoutRunning;
+        int64_t waitUs = KEY_POLL_MS*1000;
+        if(animating || hoverPending) waitUs = min(waitUs, nextFrameUs - nowUs());
+        if(waitUs > 0 && !kbhit() && !ismouseclick(WM_LBUTTONDOWN)) waitForInput((unsigned long)((waitUs+999)/1000));
+
+        profiler().nextFrame();
+        int64_t stamp = inputStampUs.exchange(0);
+        if(!hoverPending) pendingInputUs = 0;   // earlier input that changed nothing
+        if(stamp && !pendingInputUs) pendingInputUs = stamp;
+        int key = -1;
+        {
+            PROFILE_SCOPE("input");
+            if(kbhit()) key = getch();
+        }
+        if(key>=0){
+            char ch=(char)key;
+            if(!pendingInputUs) pendingInputUs = nowUs();
+            if(ch==27){ if(cancelTraversal()) continue; break; }
+            if(ch=='f'||ch=='F'){ toggleStats(); continue; }
+            if(ch=='t'||ch=='T'){ toggleTrace(); continue; }
+            if(ch=='c'||ch=='C'){ toggleComponents(); continue; }
+            if(handleViewKey(key)) continue;
+            stopLayout();
+            if(ch=='u'||ch=='U'){ doUndo(); continue; }
+            if(ch=='r'||ch=='R'){ doRedo(); continue; }
+            if(ch=='s'||ch=='S'){ saveToFile(GRAPH_FILE); continue; }
+            if(ch=='l'||ch=='L'){ loadFromFile(GRAPH_FILE); continue; }
+            if(ch=='p'||ch=='P'){ exportImage(IMAGE_FILE); continue; }
+            if(ch=='x'||ch=='X'){ runScriptCommands(SCRIPT_FILE); continue; }
+            if(ch=='d'||ch=='D'){ showEccentricity(); continue; }
+            if(ch=='o'||ch=='O'){ reorderNodes(); continue; }
+            if(handlePlaybackKey(ch)) continue;
+        }
+
+        collectTrace();
+        int64_t now = nowUs();
+        bool frameDue = now >= nextFrameUs;
+        if(frameDue){
+            if(player.loaded() && !player.isPaused() && !player.atEnd()){
+                { PROFILE_SCOPE("traversal.step"); player.advance((now-lastAnimUs)/1e6, traceChanged); }
+                if(!traceChanged.empty()) applyTraceChanges();
+            }
+            if(layoutRunning){
+                bool more;
+                { PROFILE_SCOPE("layout"); more = layout.step(LAYOUT_ITERS_PER_FRAME); }
+                showLayout();
+                if(!more) stopLayout();
+            }
+            lastAnimUs = now;
+        }
+        unsigned long tick = GetTickCount();
+        if(profiler().enabled && tick-statsTick >= STATS_REFRESH_MS){
+            sampleGauges();
+            if(statsShown){ damage.add(makeRect(0,STATS_Y,WIN_W,STATS_Y+10)); present(); }
+            statsTick = tick;
+        }
+
+        /* hover follows the newest mouse position once per frame; a click
+           is handled at once */
+        if(mouseMoved.exchange(false)) hoverPending = true;
+        bool clicked = ismouseclick(WM_LBUTTONDOWN);
+        if(frameDue && (animating || hoverPending)) nextFrameUs = now + frameUs;
+        if(!clicked && !(frameDue && hoverPending)) continue;
+        hoverPending = false;
+
+        int mx, my;
+        {
+            PROFILE_SCOPE("input");
+            mx = mousex(); my = mousey();
+        }
+        /* right-button drag: pan by how far the mouse moved since the last frame */
+        if(rightDown){
+            int px = dragX.exchange(mx), py = dragY.exchange(my);
+            if(mx!=px || my!=py){ view.panBy(mx-px, my-py); viewChanged(); }
+        }
+        int hoverNode = findNodeAt(mx,my);
+        int hoverButton = -1;
+
+        for(int b=0;b<BUTTON_COUNT && hoverButton<0;b++)
+            if(pointInRect(mx,my,BUTTONS[b].x,BUTTONS[b].y,BUTTONS[b].w,BUTTONS[b].h)) hoverButton=b;
+
+        if(prevHoverNode!=hoverNode || prevHoverButton!=hoverButton){
+            damageNode(prevHoverNode); damageNode(hoverNode);
+            damageButton(prevHoverButton); damageButton(hoverButton);
+            shownHoverNode = hoverNode; shownHoverButton = hoverButton;
+            present();
+            prevHoverNode = hoverNode; prevHoverButton = hoverButton;
+        }
+
+        if(ismouseclick(WM_LBUTTONDOWN)){
+            clearmouseclick(WM_LBUTTONDOWN);
+
+            if(hoverButton==9){
+                if(layoutRunning) stopLayout(); else startLayout();
+                damage.add(makeRect(0,0,WIN_W,UI_H));
+                present();
+                continue;
+            }
+            stopLayout();
+
+            if(hoverButton!=-1){
+                switch(hoverButton){
+                    case 0: currentMode=MODE_ADD_NODE; selNode=-1; break;
+                    case 1: currentMode=MODE_ADD_EDGE; selNode=-1; break;
+                    case 2: currentMode=MODE_BFS; selNode=-1; break;
+                    case 3: currentMode=MODE_DFS; selNode=-1; break;
+                    case 4: doUndo(); break;
+                    case 5: doRedo(); break;
+                    case 6: currentMode=MODE_SELF_LOOP; selNode=-1; break;
+                    case 7: history.clear(graph); selNode=-1; invalidateAll(); break;
+                    case 8: currentMode=MODE_SSSP; selNode=-1; break;
+                }
+                damage.add(makeRect(0,0,WIN_W,UI_H));
+                present();
+                continue;
+            }
+
+            if(currentMode==MODE_ADD_NODE && my>UI_H+10){
+                damageNode(history.addNode(graph,view.toWorldX(mx),view.toWorldY(my)));
+                present();
+            }
+            else if(currentMode==MODE_ADD_EDGE){
+                int id = findNodeAt(mx,my);
+                if(id!=-1){
+                    unsigned long now = GetTickCount();
+                    if(lastClickNode==id && now-lastClickTime<=DOUBLE_CLICK_MS){
+                        lastClickNode = -1;
+                        lastClickTime = 0;
+                        selNode = -1;
+                        continue;
+                    }
+
+                    if(selNode==-1){ selNode=id; lastClickNode=id; lastClickTime=now; }
+                    else if(graph.hasEdge(selNode,id)){ selNode=-1; }      // no duplicate edges
+                    else if(selNode!=id){
+                        int w=1;
+                        if(GLOBAL_WEIGHTED){
+                            int got = popupGetWeight(view.toScreenX((nodes[selNode].x+nodes[id].x)/2), view.toScreenY((nodes[selNode].y+nodes[id].y)/2));
+                            if(got<0){ selNode=-1; drawAll(); continue; }
+                            w = got;
+                        }
+                        history.addEdge(graph,selNode,id,w);
+                        drawNewEdge(selNode,id,w);
+                        if(GLOBAL_WEIGHTED) damage.addAll();    // repaint over the popup
+                        selNode=-1; present();
+                    }
+                }
+            }
+            else if(currentMode==MODE_SELF_LOOP){
+                int id = findNodeAt(mx,my);
+                if(id!=-1){
+                    if(!graph.hasSelfLoop(id)){
+                        int w = 1;
+                        if(GLOBAL_WEIGHTED){
+                            int got = popupGetWeight(view.toScreenX(nodes[id].x), view.toScreenY(nodes[id].y) - view.toScreenLen(NODE_RADIUS) - 10);
+                            if(got<0){ drawAll(); continue; }
+                            w = got;
+                        }
+                        history.addEdge(graph,id,id,w);
+                        drawNewEdge(id,id,w);
+                        if(GLOBAL_WEIGHTED) damage.addAll();
+                        present();
+                    }
+                }
+            }
+            else if(currentMode==MODE_DELETE_NODE){
+                int id=findNodeAt(mx,my);
+                if(id!=-1){
+                    history.deleteNode(graph,id);
+                    history.compactIfFragmented(graph);
+                    invalidateAll(); present();
+                }
+            }
+            else if(currentMode==MODE_DELETE_EDGE){
+                pair<int,int> e=findEdgeNear(mx,my);
+                if(e.first!=-1){
+                    history.deleteEdge(graph,e.first,e.second);
+                    invalidateAll(); present();
+                }
+            }
+            else if(currentMode==MODE_BFS){
+                int id=findNodeAt(mx,my);
+                if(id!=-1) BFS_visual(id);
+            }
+            else if(currentMode==MODE_DFS){
+                int id=findNodeAt(mx,my);
+                if(id!=-1) DFS_visual(id);
+            }
+            else if(currentMode==MODE_SSSP){
+                int id=findNodeAt(mx,my);
+                if(id!=-1){
+                    if(selNode==-1 || !graph.isAlive(selNode)){ selNode=id; SSSP_visual(id); }
+                    else if(selNode!=id){ showShortestPath(selNode,id); selNode=-1; }
+                    else { selNode=-1; stopPlayback(); present(); }
+                }
+            }
+        }
+    }
+
+    timeEndPeriod(1);
+    double secs = (nowUs() - startUs)/1e6;
+    cout<<"Session "<<secs<<" s, CPU "<<(processCpuUs() - startCpu)/1e4/secs<<"%";
+    if(latency.count) cout<<", input-to-flip latency mean "<<latency.sumUs/1e3/latency.count
+                          <<" ms, max "<<latency.maxUs/1e3<<" ms ("<<latency.count<<" updates)";
+    cout<<endl;
+    closegraph();
+    return 0;
+}
+
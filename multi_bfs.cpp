@@ -0,0 +1,169 @@
+/* multi_bfs.cpp - bit-parallel multi-source BFS */
+#include "multi_bfs.h"
+
+#include <algorithm>
+
+using namespace std;
+
+/* --- Index of the lowest set bit (x != 0) --- */
+static inline int lowBit(uint64_t x){
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    int b = 0;
+    while(!(x & 1)){ x >>= 1; b++; }
+    return b;
+#endif
+}
+
+static const int DENSE_DIVISOR = 8;         // sweep all vertices once a frontier has > n/8 edges
+
+/* --- One worker's bitsets (W words per vertex) and frontier lists --- */
+struct MsWorkspace {
+    vector<uint64_t> seen, visit, next;
+    vector<int32_t> cur, nxt;
+};
+
+/* --- count (<= 64*W) sources starting at sources[first], in one traversal --- */
+template<int W>
+static int runBatch(const CsrView &g, MultiBfsResult &out, int first, int count, MsWorkspace &ws, bool distances,
+                    const atomic<bool> *cancel){
+    int n = g.n;
+    const int64_t *offsets = g.offsets;     // locals: stores to the (uint64_t) bitsets
+    const int32_t *targets = g.targets;     // may alias the int64_t offsets otherwise
+    size_t words = (size_t)n * W;
+    if(ws.seen.size() != words){
+        ws.seen.assign(words, 0); ws.visit.assign(words, 0); ws.next.assign(words, 0);
+        ws.cur.reserve(n); ws.nxt.reserve(n);
+    } else {
+        fill(ws.seen.begin(), ws.seen.end(), 0);
+    }
+    uint64_t *seen = &ws.seen[0], *visit = &ws.visit[0], *next = &ws.next[0];
+    vector<int32_t> &cur = ws.cur, &nxt = ws.nxt;
+    cur.clear(); nxt.clear();
+    uint16_t *dist = distances ? &out.dist[(size_t)first * n] : 0;
+
+    for(int k=0;k<count;k++){
+        int s = out.sources[first + k];
+        uint64_t bit = (uint64_t)1 << (k & 63), *fs = visit + (size_t)s*W, any = 0;
+        for(int w=0;w<W;w++) any |= fs[w];
+        if(!any) cur.push_back(s);          // a source listed twice is one frontier vertex
+        seen[(size_t)s*W + k/64] |= bit;
+        fs[k/64] |= bit;
+        out.eccentricity[first + k] = 0;
+        if(dist) dist[(size_t)k*n + s] = 0;
+    }
+
+    int level = 0;
+    while(!cur.empty()){
+        if(cancel && cancel->load(memory_order_relaxed)) break;
+        level++;
+        /* a frontier with many edges writes to much of the graph: then
+           skip listing the targets and sweep every vertex afterwards */
+        int64_t frontierEdges = 0;
+        for(size_t i=0;i<cur.size();i++) frontierEdges += offsets[cur[i]+1] - offsets[cur[i]];
+        bool sweep = frontierEdges > n / DENSE_DIVISOR;
+
+        /* push: every frontier vertex ORs its bits into its neighbours */
+        for(size_t i=0;i<cur.size();i++){
+            int v = cur[i];
+            uint64_t *fv = visit + (size_t)v*W, bits[W];
+            for(int w=0;w<W;w++){ bits[w] = fv[w]; fv[w] = 0; }
+            for(int64_t e=offsets[v], end=offsets[v+1]; e<end; e++){
+                int u = targets[e];
+                uint64_t *nu = next + (size_t)u*W;
+                if(!sweep){
+                    uint64_t any = 0;
+                    for(int w=0;w<W;w++) any |= nu[w];
+                    if(!any) nxt.push_back(u);
+                }
+                for(int w=0;w<W;w++) nu[w] |= bits[w];
+            }
+        }
+        cur.clear();
+
+        /* keep the bits not seen before: they form the next frontier */
+        uint64_t levelBits[W] = { 0 };
+        int64_t candidates = sweep ? n : (int64_t)nxt.size();
+        for(int64_t i=0;i<candidates;i++){
+            int u = sweep ? (int)i : nxt[i];
+            uint64_t *nu = next + (size_t)u*W, *su = seen + (size_t)u*W, *fu = visit + (size_t)u*W;
+            uint64_t any = 0;
+            for(int w=0;w<W;w++){
+                uint64_t fresh = nu[w] & ~su[w];
+                nu[w] = 0;
+                su[w] |= fresh;
+                fu[w] = fresh;
+                levelBits[w] |= fresh;
+                any |= fresh;
+            }
+            if(!any) continue;
+            cur.push_back(u);
+            if(dist){
+                uint16_t d = (uint16_t)min(level, (int)MULTI_BFS_UNREACHED - 1);
+                for(int w=0;w<W;w++)
+                    for(uint64_t x=fu[w]; x; x &= x-1) dist[(size_t)(w*64 + lowBit(x))*n + u] = d;
+            }
+        }
+        nxt.clear();
+        for(int w=0;w<W;w++)
+            for(uint64_t x=levelBits[w]; x; x &= x-1) out.eccentricity[first + w*64 + lowBit(x)] = level;
+    }
+
+    /* a source reaches everything iff its bit is in every vertex's seen set */
+    uint64_t all[W];
+    for(int w=0;w<W;w++) all[w] = ~(uint64_t)0;
+    for(int v=0;v<n;v++)
+        for(int w=0;w<W;w++) all[w] &= seen[(size_t)v*W + w];
+    for(int k=0;k<count;k++) out.reachesAll[first + k] = (uint8_t)((all[k/64] >> (k & 63)) & 1);
+    return level - 1;
+}
+
+void multiSourceBfs(const CsrView &g, const vector<int32_t> &sources, MultiBfsResult &out,
+                    const MultiBfsOptions &opt, ThreadPool &pool){
+    int n = g.n;
+    out.sources = sources;
+    if(sources.empty()){
+        out.sources.resize(n);
+        for(int v=0;v<n;v++) out.sources[v] = v;
+    }
+    int count = (int)out.sources.size();
+    for(int k=0;k<count;k++){
+        if(out.sources[k] < 0 || out.sources[k] >= n){ count = k; break; }   // stop at a bad id
+    }
+    out.sources.resize(count);
+    out.eccentricity.assign(count, 0);
+    out.reachesAll.assign(count, 0);
+    out.dist.clear();
+    if(opt.distances) out.dist.assign((size_t)count * n, MULTI_BFS_UNREACHED);
+    out.diameter = 0; out.radius = 0; out.connected = count > 0; out.levels = 0;
+    if(count == 0) return;
+
+    /* words per vertex: the requested width, or fewer when there are few sources */
+    int W = 1;
+    while(W < 8 && W*64 < opt.width && W*64 < count) W *= 2;
+    int per = W*64;
+    int64_t batches = (count + per - 1) / per;
+
+    vector<MsWorkspace> ws(pool.size());
+    vector<int> levels(pool.size(), 0);
+    pool.parallelFor(0, batches, 1, [&](int64_t lo, int64_t hi, int worker){
+        for(int64_t b=lo; b<hi; b++){
+            if(opt.cancel && opt.cancel->load(memory_order_relaxed)) break;
+            int first = (int)(b*per), k = min(per, count - first);
+            int l = 0;
+            switch(W){
+            case 1: l = runBatch<1>(g, out, first, k, ws[worker], opt.distances, opt.cancel); break;
+            case 2: l = runBatch<2>(g, out, first, k, ws[worker], opt.distances, opt.cancel); break;
+            case 4: l = runBatch<4>(g, out, first, k, ws[worker], opt.distances, opt.cancel); break;
+            default: l = runBatch<8>(g, out, first, k, ws[worker], opt.distances, opt.cancel); break;
+            }
+            levels[worker] += l;
+        }
+    });
+
+    out.diameter = *max_element(out.eccentricity.begin(), out.eccentricity.end());
+    out.radius = *min_element(out.eccentricity.begin(), out.eccentricity.end());
+    for(int k=0;k<count;k++) if(!out.reachesAll[k]) out.connected = false;
+    for(size_t w=0;w<levels.size();w++) out.levels += levels[w];
+}
@@ -0,0 +1,80 @@
+#include "parallel.h"
+
+#include <algorithm>
+
+using namespace std;
+
+ThreadPool::ThreadPool(int threads)
+    : job(0), jobEnd(0), jobGrain(1), next(0), active(0), generation(0), stopping(false) {
+    if(threads <= 0) threads = (int)thread::hardware_concurrency();
+    if(threads <= 0) threads = 1;
+    for(int i=1;i<threads;i++) workers.push_back(thread(&ThreadPool::workerLoop, this, i));
+}
+
+ThreadPool::~ThreadPool(){
+    {
+        lock_guard<mutex> lk(m);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(size_t i=0;i<workers.size();i++) workers[i].join();
+}
+
+void ThreadPool::runChunks(int id){
+    for(;;){
+        int64_t lo = next.fetch_add(jobGrain);
+        if(lo >= jobEnd) break;
+        (*job)(lo, min(lo + jobGrain, jobEnd), id);
+    }
+}
+
+void ThreadPool::workerLoop(int id){
+    uint64_t seen = 0;
+    for(;;){
+        unique_lock<mutex> lk(m);
+        wake.wait(lk, [&]{ return stopping || generation != seen; });
+        if(stopping) return;
+        seen = generation;
+        lk.unlock();
+        runChunks(id);
+        lk.lock();
+        if(--active == 0) done.notify_all();
+    }
+}
+
+void ThreadPool::parallelFor(int64_t begin, int64_t end, int64_t grain, const Task &fn){
+    if(begin >= end) return;
+    if(grain < 1) grain = 1;
+    if(workers.empty() || end - begin <= grain){ fn(begin, end, 0); return; }
+
+    lock_guard<mutex> call(callMutex);
+    {
+        lock_guard<mutex> lk(m);
+        job = &fn; jobEnd = end; jobGrain = grain;
+        next.store(begin);
+        active = (int)workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    runChunks(0);
+    unique_lock<mutex> lk(m);
+    done.wait(lk, [&]{ return active == 0; });
+    job = 0;
+}
+
+ThreadPool &defaultPool(){
+    static ThreadPool pool;
+    return pool;
+}
+
+/* --- AtomicBitmap --- */
+void AtomicBitmap::resize(int64_t bits){
+    nbits = bits;
+    nwords = (bits + 63) >> 6;
+    words.reset(new atomic<uint64_t>[nwords > 0 ? nwords : 1]);
+    clear();
+}
+
+void AtomicBitmap::clear(){
+    for(int64_t i=0;i<nwords;i++) words[i].store(0, memory_order_relaxed);
+}
@@ -0,0 +1,122 @@
+/* parallel.h - small fork/join helpers shared by the parallel algorithms:
+   a persistent thread pool with a chunked parallelFor, an atomic bitmap
+   for visited/frontier sets, and a single-producer / single-consumer ring
+   for handing results from one thread to another. */
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/* --- Fixed set of workers; the calling thread takes part as worker 0 ---
+   parallelFor hands out [begin,end) in chunks of `grain` from a shared
+   counter (dynamic load balancing).  Calls are serialised; calling
+   parallelFor from inside a task is not supported. */
+class ThreadPool {
+public:
+    typedef std::function<void(int64_t lo, int64_t hi, int worker)> Task;
+
+    explicit ThreadPool(int threads = 0);   // 0 = hardware concurrency
+    ~ThreadPool();
+
+    int size() const { return (int)workers.size() + 1; }
+    void parallelFor(int64_t begin, int64_t end, int64_t grain, const Task &fn);
+
+private:
+    std::vector<std::thread> workers;
+    std::mutex m, callMutex;
+    std::condition_variable wake, done;
+    const Task *job;
+    int64_t jobEnd, jobGrain;
+    std::atomic<int64_t> next;
+    int active;
+    uint64_t generation;
+    bool stopping;
+
+    void workerLoop(int id);
+    void runChunks(int id);
+};
+
+ThreadPool &defaultPool();      // shared pool sized to the machine
+
+/* --- Fixed-size bitmap with atomic set (lock-free) --- */
+class AtomicBitmap {
+public:
+    AtomicBitmap(): nbits(0), nwords(0) {}
+    explicit AtomicBitmap(int64_t bits) { resize(bits); }
+
+    void resize(int64_t bits);
+    void clear();                       // not thread-safe against concurrent set()
+    bool test(int64_t i) const { return (words[i>>6].load(std::memory_order_relaxed) >> (i&63)) & 1; }
+    bool set(int64_t i){                // true if this call flipped the bit
+        uint64_t mask = (uint64_t)1 << (i&63);
+        return !(words[i>>6].fetch_or(mask, std::memory_order_relaxed) & mask);
+    }
+    uint64_t word(int64_t w) const { return words[w].load(std::memory_order_relaxed); }
+    int64_t wordCount() const { return nwords; }
+    int64_t size() const { return nbits; }
+
+private:
+    std::unique_ptr< std::atomic<uint64_t>[] > words;
+    int64_t nbits, nwords;
+};
+
+/* --- Bounded single-producer / single-consumer ring (lock-free) ---
+   Exactly one thread pushes and one other thread pops.  Each side owns
+   one index and publishes it with a release store; the other side reads
+   it with an acquire load, and only when its cached copy says the ring
+   looks full (or empty), so in steady state the two threads do not touch
+   each other's cache line.  Capacity is rounded up to a power of two. */
+template<class T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity): head(0), tail(0), headSeen(0), tailSeen(0) {
+        size_t c = 2;
+        while(c < capacity) c *= 2;
+        slots.resize(c);
+        mask = c - 1;
+    }
+
+    /* producer: false when the ring is full */
+    bool push(const T &x){
+        size_t t = tail.load(std::memory_order_relaxed);
+        if(t - headSeen == slots.size()){
+            headSeen = head.load(std::memory_order_acquire);
+            if(t - headSeen == slots.size()) return false;
+        }
+        slots[t & mask] = x;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /* consumer: false when the ring is empty */
+    bool pop(T &x){
+        size_t h = head.load(std::memory_order_relaxed);
+        if(h == tailSeen){
+            tailSeen = tail.load(std::memory_order_acquire);
+            if(h == tailSeen) return false;
+        }
+        x = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return slots.size(); }
+
+private:
+    std::vector<T> slots;
+    size_t mask;
+    alignas(64) std::atomic<size_t> head;   // next slot to pop (written by the consumer)
+    alignas(64) std::atomic<size_t> tail;   // next slot to push (written by the producer)
+    alignas(64) size_t headSeen;            // producer's copy of head
+    alignas(64) size_t tailSeen;            // consumer's copy of tail
+};
+
+#endif
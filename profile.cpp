@@ -0,0 +1,190 @@
+/* profile.cpp - scoped timers, counters, frame statistics, Chrome trace */
+#include "profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <new>
+
+using namespace std;
+
+Profiler theProfiler;
+
+static const int64_t WINDOW_NS = 500000000;     // statistics window
+
+int64_t Profiler::nowNs(){
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Profiler::Profiler()
+    : enabled(false), maxEvents(0), traceOn(false), frameStart(nowNs()), winStart(frameStart),
+      winMaxNs(0), traceStart(0), winFrames(0), winFps(0), winFrameMs(0), winMaxMs(0), frameZone(-1) {}
+
+int Profiler::findZone(const char *name) const {
+    for(int i=0;i<(int)zones.size();i++) if(!strcmp(zones[i].name, name)) return i;
+    return -1;
+}
+
+int Profiler::findCounter(const char *name) const {
+    for(int i=0;i<(int)counters.size();i++) if(!strcmp(counters[i].name, name)) return i;
+    return -1;
+}
+
+int Profiler::zone(const char *name){
+    int z = findZone(name);
+    if(z >= 0) return z;
+    Zone nz = { name, 0, 0, 0, 0, 0.0, 0.0 };
+    zones.push_back(nz);
+    return (int)zones.size() - 1;
+}
+
+int Profiler::counter(const char *name, bool gauge){
+    int c = findCounter(name);
+    if(c >= 0) return c;
+    Counter nc = { name, gauge, 0, 0, INT64_MIN, 0.0 };
+    counters.push_back(nc);
+    return (int)counters.size() - 1;
+}
+
+void Profiler::record(int z, int64_t t0, int64_t t1){
+    zones[z].ns += t1 - t0;
+    zones[z].calls++;
+    if(traceOn && events.size() < maxEvents){
+        Event e = { z, t0, t1 - t0 };
+        events.push_back(e);
+    }
+}
+
+/* --- Fold the frame into the window; publish the window's averages
+   every WINDOW_NS --- */
+void Profiler::nextFrame(){
+    int64_t now = nowNs();
+    if(!enabled){ frameStart = winStart = now; winFrames = 0; winMaxNs = 0; return; }
+    if(frameZone < 0) frameZone = zone("frame");
+    record(frameZone, frameStart, now);
+    winMaxNs = max(winMaxNs, now - frameStart);
+    winFrames++;
+    frameStart = now;
+
+    for(size_t i=0;i<zones.size();i++){
+        Zone &z = zones[i];
+        z.winNs += z.ns; z.winCalls += z.calls;
+        z.ns = z.calls = 0;
+    }
+    for(size_t i=0;i<counters.size();i++){
+        Counter &c = counters[i];
+        if(traceOn && c.cur != c.traced && events.size() < maxEvents){
+            Event e = { -(int)i - 1, now, c.cur };
+            events.push_back(e);
+            c.traced = c.cur;
+        }
+        if(c.gauge) c.win = c.cur;
+        else { c.win += c.cur; c.cur = 0; }
+    }
+
+    if(now - winStart < WINDOW_NS) return;
+    double sec = (now - winStart) / 1e9;
+    winFps = winFrames / sec;
+    winFrameMs = sec * 1e3 / winFrames;
+    winMaxMs = winMaxNs / 1e6;
+    for(size_t i=0;i<zones.size();i++){
+        Zone &z = zones[i];
+        z.avgMs = z.winNs / 1e6 / winFrames;
+        z.avgCalls = (double)z.winCalls / winFrames;
+        z.winNs = z.winCalls = 0;
+    }
+    for(size_t i=0;i<counters.size();i++){
+        Counter &c = counters[i];
+        if(c.gauge) c.shown = (double)c.win;
+        else { c.shown = (double)c.win / winFrames; c.win = 0; }
+    }
+    winStart = now;
+    winFrames = 0;
+    winMaxNs = 0;
+}
+
+/* --- Chrome trace-event JSON --- */
+void Profiler::startTrace(size_t maxEv){
+    events.clear();
+    events.reserve(min<size_t>(maxEv, 65536));
+    maxEvents = maxEv;
+    for(size_t i=0;i<counters.size();i++) counters[i].traced = INT64_MIN;
+    traceOn = true;
+    enabled = true;
+    traceStart = nowNs();
+    frameStart = max(frameStart, traceStart);    // no event before the log starts
+}
+
+static void writeName(FILE *f, const char *s){
+    fputc('"', f);
+    for(; *s; s++){
+        unsigned char ch = (unsigned char)*s;
+        if(ch == '"' || ch == '\\') fprintf(f, "\\%c", ch);
+        else if(ch < 32) fprintf(f, "\\u%04x", ch);
+        else fputc(ch, f);
+    }
+    fputc('"', f);
+}
+
+bool Profiler::stopTrace(const char *path, string *err){
+    traceOn = false;
+    FILE *f = fopen(path, "w");
+    if(!f){
+        if(err) *err = string("cannot create ") + path;
+        events = vector<Event>();
+        return false;
+    }
+    fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for(size_t i=0;i<events.size();i++){
+        const Event &e = events[i];
+        double ts = (e.t0 - traceStart) / 1e3;      // microseconds
+        if(e.id >= 0){
+            fprintf(f, "{\"name\":");
+            writeName(f, zones[e.id].name);
+            fprintf(f, ",\"cat\":\"gv\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}", ts, e.dur / 1e3);
+        } else {
+            fprintf(f, "{\"name\":");
+            writeName(f, counters[-e.id - 1].name);
+            fprintf(f, ",\"ph\":\"C\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"args\":{\"value\":%lld}}", ts, (long long)e.dur);
+        }
+        fputs(i + 1 < events.size() ? ",\n" : "\n", f);
+    }
+    fprintf(f, "]}\n");
+    bool ok = !ferror(f);
+    if(fclose(f) != 0) ok = false;
+    events = vector<Event>();
+    if(!ok && err) *err = string("write failed: ") + path;
+    return ok;
+}
+
+/* --- Allocation counting: operator new over malloc, with the standard
+   new-handler loop; the array and nothrow forms of the library forward
+   here, and every delete form ends in free --- */
+#if GV_PROFILE
+static atomic<int64_t> allocCount(0);
+
+void *operator new(size_t n){
+    allocCount.fetch_add(1, memory_order_relaxed);
+    if(n == 0) n = 1;
+    for(;;){
+        void *p = malloc(n);
+        if(p) return p;
+        new_handler h = get_new_handler();
+        if(!h) throw bad_alloc();
+        h();
+    }
+}
+
+void *operator new[](size_t n){ return operator new(n); }
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+int64_t heapAllocations(){ return allocCount.load(memory_order_relaxed); }
+#else
+int64_t heapAllocations(){ return -1; }
+#endif
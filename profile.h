@@ -0,0 +1,110 @@
+/* profile.h - lightweight instrumentation: named scoped timers and counters
+   accumulated per frame, averaged over half-second windows for the
+   editor's stats overlay, and an optional Chrome trace-event log of every
+   timed scope (load the JSON in chrome://tracing or Perfetto).
+
+   Each call site registers its zone or counter once (a function-local
+   static), so a scope costs one predictable branch while the profiler is
+   off and two clock reads while it is on.  Building with GV_PROFILE=0
+   compiles the macros away.  Main thread only. */
+#ifndef PROFILE_H
+#define PROFILE_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#ifndef GV_PROFILE
+#define GV_PROFILE 1
+#endif
+
+class Profiler {
+public:
+    Profiler();
+
+    bool enabled;                   // timers and counters run (tracing needs it too)
+
+    int zone(const char *name);                         // register (or find) a timed zone
+    int counter(const char *name, bool gauge = false);  // gauge: keeps its last value
+
+    void add(int c, int64_t v){ if(enabled) counters[c].cur += v; }
+    void set(int c, int64_t v){ if(enabled) counters[c].cur = v; }
+    void record(int z, int64_t t0, int64_t t1);         // a scope of zone z ran [t0,t1)
+
+    /* ends the current frame and starts the next one */
+    void nextFrame();
+
+    /* --- averages over the last completed window (about 0.5 s) --- */
+    double fps() const { return winFps; }
+    double frameMs() const { return winFrameMs; }       // mean frame time
+    double maxFrameMs() const { return winMaxMs; }      // slowest frame
+    int    zoneCount() const { return (int)zones.size(); }
+    const char *zoneName(int z) const { return zones[z].name; }
+    double zoneMs(int z) const { return zones[z].avgMs; }       // per frame
+    double zoneCalls(int z) const { return zones[z].avgCalls; } // per frame
+    int    counterCount() const { return (int)counters.size(); }
+    const char *counterName(int c) const { return counters[c].name; }
+    double counterValue(int c) const { return counters[c].shown; }  // per frame, or a gauge's value
+    int    findZone(const char *name) const;            // -1 if never registered
+    int    findCounter(const char *name) const;
+
+    /* --- Chrome trace: every scope, and each counter whenever its per-frame value changes --- */
+    void startTrace(size_t maxEvents = 1 << 20);        // enables the profiler
+    bool tracing() const { return traceOn; }
+    size_t traceEvents() const { return events.size(); }
+    bool stopTrace(const char *path, std::string *err = 0);     // writes the JSON and drops the log
+
+    static int64_t nowNs();
+
+private:
+    struct Zone { const char *name; int64_t ns, calls, winNs, winCalls; double avgMs, avgCalls; };
+    struct Counter { const char *name; bool gauge; int64_t cur, win, traced; double shown; };  // traced: last value logged
+    struct Event { int id; int64_t t0, dur; };          // id < 0: counter sample -(c+1), value in dur
+
+    std::vector<Zone> zones;
+    std::vector<Counter> counters;
+    std::vector<Event> events;
+    size_t maxEvents;
+    bool traceOn;
+    int64_t frameStart, winStart, winMaxNs, traceStart;
+    int winFrames;
+    double winFps, winFrameMs, winMaxMs;
+    int frameZone;
+};
+
+extern Profiler theProfiler;
+inline Profiler &profiler(){ return theProfiler; }
+
+/* --- Heap allocations (calls of the global operator new, any thread)
+   since startup, counted by the replacement operators in profile.cpp;
+   the editor reports the difference across each frame.  -1 when built
+   with GV_PROFILE=0, which keeps the standard operators. --- */
+int64_t heapAllocations();
+
+/* --- Times the enclosing scope while the profiler is enabled --- */
+class ProfileScope {
+public:
+    explicit ProfileScope(int zone): z(zone), t0(theProfiler.enabled ? Profiler::nowNs() : -1) {}
+    ~ProfileScope(){ if(t0 >= 0) theProfiler.record(z, t0, Profiler::nowNs()); }
+private:
+    int z;
+    int64_t t0;
+};
+
+#if GV_PROFILE
+#define PROFILE_CAT2(a,b) a##b
+#define PROFILE_CAT(a,b) PROFILE_CAT2(a,b)
+#define PROFILE_SCOPE(name) \
+    static const int PROFILE_CAT(profileZone_,__LINE__) = theProfiler.zone(name); \
+    ProfileScope PROFILE_CAT(profileScope_,__LINE__)(PROFILE_CAT(profileZone_,__LINE__))
+#define PROFILE_COUNT(name, n) \
+    do { static const int profileId_ = theProfiler.counter(name); theProfiler.add(profileId_, (n)); } while(0)
+#define PROFILE_GAUGE(name, v) \
+    do { static const int profileId_ = theProfiler.counter(name, true); theProfiler.set(profileId_, (v)); } while(0)
+#else
+#define PROFILE_SCOPE(name) do {} while(0)
+#define PROFILE_COUNT(name, n) do {} while(0)
+#define PROFILE_GAUGE(name, v) do {} while(0)
+#endif
+
+#endif
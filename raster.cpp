@@ -0,0 +1,543 @@
+/* raster.cpp - tiled software rasterizer, PPM/PNG export */
+#include "raster.h"
+#include "profile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define RASTER_SSE2 1
+#endif
+
+using namespace std;
+
+/* --- 5x7 glyphs for ' '..'~', one byte per row, bit 4 = leftmost column --- */
+static const unsigned char FONT[95][7] = {
+    {0x00,0x00,0x00,0x00,0x00,0x00,0x00}, {0x04,0x04,0x04,0x04,0x04,0x00,0x04}, {0x0a,0x0a,0x0a,0x00,0x00,0x00,0x00}, {0x0a,0x0a,0x1f,0x0a,0x1f,0x0a,0x0a},
+    {0x04,0x0f,0x14,0x0e,0x05,0x1e,0x04}, {0x18,0x19,0x02,0x04,0x08,0x13,0x03}, {0x0c,0x12,0x14,0x08,0x15,0x12,0x0d}, {0x04,0x04,0x08,0x00,0x00,0x00,0x00},
+    {0x02,0x04,0x08,0x08,0x08,0x04,0x02}, {0x08,0x04,0x02,0x02,0x02,0x04,0x08}, {0x00,0x04,0x15,0x0e,0x15,0x04,0x00}, {0x00,0x04,0x04,0x1f,0x04,0x04,0x00},
+    {0x00,0x00,0x00,0x00,0x0c,0x04,0x08}, {0x00,0x00,0x00,0x1f,0x00,0x00,0x00}, {0x00,0x00,0x00,0x00,0x00,0x0c,0x0c}, {0x00,0x01,0x02,0x04,0x08,0x10,0x00},
+    {0x0e,0x11,0x13,0x15,0x19,0x11,0x0e}, {0x04,0x0c,0x04,0x04,0x04,0x04,0x0e}, {0x0e,0x11,0x01,0x02,0x04,0x08,0x1f}, {0x1f,0x02,0x04,0x02,0x01,0x11,0x0e},
+    {0x02,0x06,0x0a,0x12,0x1f,0x02,0x02}, {0x1f,0x10,0x1e,0x01,0x01,0x11,0x0e}, {0x06,0x08,0x10,0x1e,0x11,0x11,0x0e}, {0x1f,0x01,0x02,0x04,0x08,0x08,0x08},
+    {0x0e,0x11,0x11,0x0e,0x11,0x11,0x0e}, {0x0e,0x11,0x11,0x0f,0x01,0x02,0x0c}, {0x00,0x0c,0x0c,0x00,0x0c,0x0c,0x00}, {0x00,0x0c,0x0c,0x00,0x0c,0x04,0x08},
+    {0x02,0x04,0x08,0x10,0x08,0x04,0x02}, {0x00,0x00,0x1f,0x00,0x1f,0x00,0x00}, {0x08,0x04,0x02,0x01,0x02,0x04,0x08}, {0x0e,0x11,0x01,0x02,0x04,0x00,0x04},
+    {0x0e,0x11,0x01,0x0d,0x15,0x15,0x0e}, {0x0e,0x11,0x11,0x1f,0x11,0x11,0x11}, {0x1e,0x11,0x11,0x1e,0x11,0x11,0x1e}, {0x0e,0x11,0x10,0x10,0x10,0x11,0x0e},
+    {0x1c,0x12,0x11,0x11,0x11,0x12,0x1c}, {0x1f,0x10,0x10,0x1e,0x10,0x10,0x1f}, {0x1f,0x10,0x10,0x1e,0x10,0x10,0x10}, {0x0e,0x11,0x10,0x17,0x11,0x11,0x0f},
+    {0x11,0x11,0x11,0x1f,0x11,0x11,0x11}, {0x0e,0x04,0x04,0x04,0x04,0x04,0x0e}, {0x07,0x02,0x02,0x02,0x02,0x12,0x0c}, {0x11,0x12,0x14,0x18,0x14,0x12,0x11},
+    {0x10,0x10,0x10,0x10,0x10,0x10,0x1f}, {0x11,0x1b,0x15,0x15,0x11,0x11,0x11}, {0x11,0x11,0x19,0x15,0x13,0x11,0x11}, {0x0e,0x11,0x11,0x11,0x11,0x11,0x0e},
+    {0x1e,0x11,0x11,0x1e,0x10,0x10,0x10}, {0x0e,0x11,0x11,0x11,0x15,0x12,0x0d}, {0x1e,0x11,0x11,0x1e,0x14,0x12,0x11}, {0x0f,0x10,0x10,0x0e,0x01,0x01,0x1e},
+    {0x1f,0x04,0x04,0x04,0x04,0x04,0x04}, {0x11,0x11,0x11,0x11,0x11,0x11,0x0e}, {0x11,0x11,0x11,0x11,0x11,0x0a,0x04}, {0x11,0x11,0x11,0x15,0x15,0x15,0x0a},
+    {0x11,0x11,0x0a,0x04,0x0a,0x11,0x11}, {0x11,0x11,0x0a,0x04,0x04,0x04,0x04}, {0x1f,0x01,0x02,0x04,0x08,0x10,0x1f}, {0x0e,0x08,0x08,0x08,0x08,0x08,0x0e},
+    {0x00,0x10,0x08,0x04,0x02,0x01,0x00}, {0x0e,0x02,0x02,0x02,0x02,0x02,0x0e}, {0x04,0x0a,0x11,0x00,0x00,0x00,0x00}, {0x00,0x00,0x00,0x00,0x00,0x00,0x1f},
+    {0x08,0x04,0x02,0x00,0x00,0x00,0x00}, {0x00,0x00,0x0e,0x01,0x0f,0x11,0x0f}, {0x10,0x10,0x16,0x19,0x11,0x11,0x1e}, {0x00,0x00,0x0e,0x10,0x10,0x11,0x0e},
+    {0x01,0x01,0x0d,0x13,0x11,0x11,0x0f}, {0x00,0x00,0x0e,0x11,0x1f,0x10,0x0e}, {0x06,0x09,0x08,0x1c,0x08,0x08,0x08}, {0x00,0x0f,0x11,0x11,0x0f,0x01,0x0e},
+    {0x10,0x10,0x16,0x19,0x11,0x11,0x11}, {0x04,0x00,0x0c,0x04,0x04,0x04,0x0e}, {0x02,0x00,0x06,0x02,0x02,0x12,0x0c}, {0x10,0x10,0x12,0x14,0x18,0x14,0x12},
+    {0x0c,0x04,0x04,0x04,0x04,0x04,0x0e}, {0x00,0x00,0x1a,0x15,0x15,0x11,0x11}, {0x00,0x00,0x16,0x19,0x11,0x11,0x11}, {0x00,0x00,0x0e,0x11,0x11,0x11,0x0e},
+    {0x00,0x00,0x1e,0x11,0x1e,0x10,0x10}, {0x00,0x00,0x0d,0x13,0x0f,0x01,0x01}, {0x00,0x00,0x16,0x19,0x10,0x10,0x10}, {0x00,0x00,0x0e,0x10,0x0e,0x01,0x1e},
+    {0x08,0x08,0x1c,0x08,0x08,0x09,0x06}, {0x00,0x00,0x11,0x11,0x11,0x13,0x0d}, {0x00,0x00,0x11,0x11,0x11,0x0a,0x04}, {0x00,0x00,0x11,0x11,0x15,0x15,0x0a},
+    {0x00,0x00,0x11,0x0a,0x04,0x0a,0x11}, {0x00,0x00,0x11,0x11,0x0f,0x01,0x0e}, {0x00,0x00,0x1f,0x02,0x04,0x08,0x1f}, {0x02,0x04,0x04,0x08,0x04,0x04,0x02},
+    {0x04,0x04,0x04,0x04,0x04,0x04,0x04}, {0x08,0x04,0x04,0x02,0x04,0x04,0x08}, {0x00,0x00,0x08,0x15,0x02,0x00,0x00}
+};
+
+uint32_t SoftCanvas::paletteColor(int c){
+    static const uint32_t PALETTE[16] = {
+        0x000000, 0x0000AA, 0x00AA00, 0x00AAAA, 0xAA0000, 0xAA00AA, 0xAA5500, 0xAAAAAA,
+        0x555555, 0x5555FF, 0x55FF55, 0x55FFFF, 0xFF5555, 0xFF55FF, 0xFFFF55, 0xFFFFFF
+    };
+    return PALETTE[c & 15];
+}
+
+/* --- Fill n pixels with one colour: 8 (AVX2) or 4 (SSE2) per store --- */
+static inline void fillSpan(uint32_t *p, int n, uint32_t c){
+#if defined(__AVX2__)
+    __m256i v8 = _mm256_set1_epi32((int)c);
+    for(; n >= 8; n -= 8, p += 8) _mm256_storeu_si256((__m256i*)p, v8);
+#endif
+#ifdef RASTER_SSE2
+    __m128i v4 = _mm_set1_epi32((int)c);
+    for(; n >= 4; n -= 4, p += 4) _mm_storeu_si128((__m128i*)p, v4);
+#endif
+    for(; n > 0; n--) *p++ = c;
+}
+
+static inline int64_t floorDiv(int64_t a, int64_t b){
+    int64_t q = a / b;
+    if((a % b) != 0 && ((a < 0) != (b < 0))) q--;
+    return q;
+}
+
+/* --- A line in (major, minor) coordinates with u1 <= u2; minorAt gives
+   the rounded minor coordinate of every major step exactly, so any tile
+   can rasterize its own piece and the pieces join up --- */
+struct LineSteps {
+    bool steep;             // major axis is y
+    int64_t u1, v1, u2, v2;
+
+    explicit LineSteps(int x1,int y1,int x2,int y2){
+        steep = llabs((long long)y2 - y1) > llabs((long long)x2 - x1);
+        if(steep){ u1 = y1; v1 = x1; u2 = y2; v2 = x2; }
+        else     { u1 = x1; v1 = y1; u2 = x2; v2 = y2; }
+        if(u1 > u2){ swap(u1, u2); swap(v1, v2); }
+    }
+    int64_t minorAt(int64_t u) const {
+        int64_t du = u2 - u1;
+        if(du == 0) return v1;
+        return v1 + floorDiv(2*(u - u1)*(v2 - v1) + du, 2*du);
+    }
+};
+
+/* --- Half-width of an ellipse row dy below/above the centre --- */
+static inline int spanHalf(int rx, int ry, int dy){
+    if(ry <= 0) return rx;
+    double t = 1.0 - (double)dy*dy / ((double)ry*ry);
+    return (int)(rx * sqrt(max(t, 0.0)) + 0.5);
+}
+
+static const uint32_t NO_TABLE = 0xFFFFFFFFu;
+
+SoftCanvas::SoftCanvas(int width, int height, int tileSize)
+    : w(0), h(0), tile(max(8, tileSize)), tilesX(0), tilesY(0),
+      color(0), fill(0xFFFFFF), back(0xFFFFFF), lineWidth(1), binned(0){
+    resize(width, height);
+}
+
+void SoftCanvas::resize(int width, int height){
+    w = max(1, width); h = max(1, height);
+    tilesX = (w + tile - 1) / tile;
+    tilesY = (h + tile - 1) / tile;
+    fb.assign((size_t)w*h, 0xFFFFFF);
+    bins.assign((size_t)tilesX*tilesY, vector<Cmd>());
+    cmds.clear();
+    textPool.clear();
+    spans.clear();
+    spanIndex.clear();
+}
+
+void SoftCanvas::setColor(int c){ color = paletteColor(c); }
+void SoftCanvas::setFillColor(int c){ fill = paletteColor(c); }
+void SoftCanvas::setTextBackground(int c){ back = paletteColor(c); }
+void SoftCanvas::setLineWidth(int lw){ lineWidth = max(1, min(lw, 255)); }
+
+void SoftCanvas::push(const Cmd &c){ cmds.push_back(c); }
+
+/* commands entirely outside the frame are dropped while recording */
+bool SoftCanvas::offFrame(int64_t x0, int64_t y0, int64_t x1, int64_t y1) const {
+    return x1 < 0 || y1 < 0 || x0 >= w || y0 >= h;
+}
+
+/* the rows of an ellipse are worked out once per size, not per tile and
+   frame: the scene draws thousands of ellipses in two or three sizes */
+uint32_t SoftCanvas::spanTable(int rx, int ry){
+    uint64_t key = (uint64_t)(uint32_t)rx << 32 | (uint32_t)ry;
+    unordered_map<uint64_t, uint32_t>::const_iterator it = spanIndex.find(key);
+    if(it != spanIndex.end()) return it->second;
+    uint32_t off = (uint32_t)spans.size();
+    for(int dy=0; dy<=ry; dy++) spans.push_back(spanHalf(rx, ry, dy));
+    spanIndex[key] = off;
+    return off;
+}
+
+void SoftCanvas::clear(int c){
+    Cmd k = Cmd();
+    k.kind = CMD_BAR; k.color = paletteColor(c);
+    k.a = 0; k.b = 0; k.c = w-1; k.d = h-1;
+    push(k);
+}
+
+void SoftCanvas::line(int x1,int y1,int x2,int y2){
+    Cmd k = Cmd();
+    int pad = lineWidth / 2 + 1;
+    if(offFrame((int64_t)min(x1,x2) - pad, (int64_t)min(y1,y2) - pad, (int64_t)max(x1,x2) + pad, (int64_t)max(y1,y2) + pad)) return;
+    k.kind = CMD_LINE; k.width = (uint8_t)lineWidth; k.color = color;
+    k.a = x1; k.b = y1; k.c = x2; k.d = y2;
+    push(k);
+}
+
+void SoftCanvas::bar(int x1,int y1,int x2,int y2){
+    Cmd k = Cmd();
+    k.kind = CMD_BAR; k.color = fill;
+    k.a = min(x1,x2); k.b = min(y1,y2); k.c = max(x1,x2); k.d = max(y1,y2);
+    if(offFrame(k.a, k.b, k.c, k.d)) return;
+    push(k);
+}
+
+void SoftCanvas::rect(int x1,int y1,int x2,int y2){
+    line(x1,y1,x2,y1); line(x2,y1,x2,y2); line(x2,y2,x1,y2); line(x1,y2,x1,y1);
+}
+
+void SoftCanvas::fillEllipse(int x,int y,int rx,int ry){
+    Cmd k = Cmd();
+    k.kind = CMD_FILL_ELLIPSE; k.color = fill;
+    k.a = x; k.b = y; k.c = abs(rx); k.d = abs(ry);
+    if(offFrame((int64_t)x - k.c, (int64_t)y - k.d, (int64_t)x + k.c, (int64_t)y + k.d)) return;
+    k.text = spanTable(k.c, k.d);
+    push(k);
+    ellipse(x, y, rx, ry);
+}
+
+void SoftCanvas::circle(int x,int y,int r){ ellipse(x, y, r, r); }
+
+void SoftCanvas::ellipse(int x,int y,int rx,int ry){
+    Cmd k = Cmd();
+    k.kind = CMD_ELLIPSE; k.width = (uint8_t)lineWidth; k.color = color;
+    k.a = x; k.b = y; k.c = abs(rx); k.d = abs(ry);
+    if(offFrame((int64_t)x - k.c, (int64_t)y - k.d, (int64_t)x + k.c, (int64_t)y + k.d)) return;
+    k.text = spanTable(k.c, k.d);
+    k.len = k.c >= lineWidth && k.d >= lineWidth ? spanTable(k.c - lineWidth, k.d - lineWidth) : NO_TABLE;
+    push(k);
+}
+
+void SoftCanvas::text(int x,int y,const char *s){
+    size_t len = strlen(s);
+    if(len == 0) return;
+    Cmd k = Cmd();
+    k.kind = CMD_TEXT; k.color = color; k.back = back;
+    k.a = x; k.b = y; k.c = x + 8*(int)len - 1; k.d = y + 7;
+    if(offFrame(k.a, k.b, k.c, k.d)) return;
+    k.text = (uint32_t)textPool.size(); k.len = (uint32_t)len;
+    textPool.append(s, len);
+    push(k);
+}
+
+/* --- Binning --- */
+void SoftCanvas::binBox(uint32_t id, int64_t x0, int64_t y0, int64_t x1, int64_t y1){
+    x0 = max<int64_t>(x0, 0); y0 = max<int64_t>(y0, 0);
+    x1 = min<int64_t>(x1, w-1); y1 = min<int64_t>(y1, h-1);
+    if(x0 > x1 || y0 > y1) return;
+    for(int64_t ty=y0/tile; ty<=y1/tile; ty++)
+        for(int64_t tx=x0/tile; tx<=x1/tile; tx++){ bins[ty*tilesX + tx].push_back(cmds[id]); binned++; }
+}
+
+/* a line goes only into the tiles along it: per tile column (row, when
+   steep) of the major axis, the minor range it covers there */
+void SoftCanvas::binLine(uint32_t id){
+    const Cmd &c = cmds[id];
+    LineSteps L(c.a, c.b, c.c, c.d);
+    int64_t majorSize = L.steep ? h : w, minorSize = L.steep ? w : h;
+    int lo = (c.width - 1) / 2, hi = c.width / 2;
+    int64_t ua = max<int64_t>(L.u1, 0), ub = min<int64_t>(L.u2, majorSize-1);
+    for(int64_t t=ua/tile; ua<=ub && t<=ub/tile; t++){
+        int64_t s0 = max(ua, t*tile), s1 = min(ub, t*tile + tile - 1);
+        int64_t m0 = L.minorAt(s0), m1 = L.minorAt(s1);
+        int64_t v0 = max<int64_t>(min(m0, m1) - lo, 0), v1 = min<int64_t>(max(m0, m1) + hi, minorSize-1);
+        if(v0 > v1) continue;
+        for(int64_t m=v0/tile; m<=v1/tile; m++){
+            int64_t idx = L.steep ? t*tilesX + m : m*tilesX + t;
+            bins[idx].push_back(c); binned++;
+        }
+    }
+}
+
+/* --- Rasterize commands in order, clipped to [X0,X1] x [Y0,Y1] --- */
+void SoftCanvas::render(const vector<Cmd> &list, int X0, int Y0, int X1, int Y1){
+    uint32_t *base = &fb[0];
+
+    for(size_t k=0; k<list.size(); k++){
+        const Cmd &c = list[k];
+        switch(c.kind){
+        case CMD_BAR: {
+            int x0 = max(c.a, X0), x1 = min(c.c, X1);
+            for(int y=max(c.b, Y0); y<=min(c.d, Y1); y++) fillSpan(base + (size_t)y*w + x0, x1 - x0 + 1, c.color);
+            break;
+        }
+        case CMD_LINE: {
+            LineSteps L(c.a, c.b, c.c, c.d);
+            int lo = (c.width - 1) / 2, hi = c.width / 2;
+            int64_t uA = max<int64_t>(L.u1, L.steep ? Y0 : X0), uB = min<int64_t>(L.u2, L.steep ? Y1 : X1);
+            int64_t vMin = L.steep ? X0 : Y0, vMax = L.steep ? X1 : Y1;
+            int64_t du = L.u2 - L.u1, dv = L.v2 - L.v1;
+            /* only the steps whose minor coordinate can reach the clip box
+               (a pixel of slack for rounding) */
+            if(dv == 0){
+                if(L.v1 + hi < vMin || L.v1 - lo > vMax) break;
+            } else {
+                double ta = L.u1 + (double)(vMin - hi - 1 - L.v1) * du / dv;
+                double tb = L.u1 + (double)(vMax + lo + 1 - L.v1) * du / dv;
+                if(ta > tb) swap(ta, tb);
+                uA = max(uA, (int64_t)floor(ta) - 1);
+                uB = min(uB, (int64_t)ceil(tb) + 1);
+            }
+            if(uA > uB) break;
+            /* Bresenham from uA on: r is the rounding remainder of minorAt */
+            int64_t v = L.minorAt(uA);
+            int64_t r = du ? 2*(uA - L.u1)*dv + du - 2*du*(v - L.v1) : 0;
+            for(int64_t u=uA; u<=uB; u++){
+                int64_t v0 = max(v - lo, vMin), v1 = min(v + hi, vMax);
+                for(int64_t m=v0; m<=v1; m++){
+                    if(L.steep) base[(size_t)u*w + m] = c.color;
+                    else        base[(size_t)m*w + u] = c.color;
+                }
+                if(du){
+                    r += 2*dv;
+                    if(r >= 2*du){ r -= 2*du; v++; }
+                    else if(r < 0){ r += 2*du; v--; }
+                }
+            }
+            break;
+        }
+        case CMD_FILL_ELLIPSE: {
+            const int *half = &spans[c.text];
+            for(int y=max(c.b - c.d, Y0); y<=min(c.b + c.d, Y1); y++){
+                int hw = half[abs(y - c.b)];
+                int x0 = max(c.a - hw, X0), x1 = min(c.a + hw, X1);
+                if(x0 <= x1) fillSpan(base + (size_t)y*w + x0, x1 - x0 + 1, c.color);
+            }
+            break;
+        }
+        case CMD_ELLIPSE: {
+            /* the ring between the ellipse and one shrunk by the line width */
+            const int *outer = &spans[c.text];
+            const int *inner = c.len == NO_TABLE ? 0 : &spans[c.len];
+            int iry = c.d - c.width;
+            for(int y=max(c.b - c.d, Y0); y<=min(c.b + c.d, Y1); y++){
+                int dy = abs(y - c.b);
+                int ho = outer[dy];
+                int hi = inner && dy <= iry ? min(inner[dy], ho - 1) : -1;
+                uint32_t *row = base + (size_t)y*w;
+                int segs[2][2] = { { c.a - ho, hi < 0 ? c.a + ho : c.a - hi - 1 }, { c.a + hi + 1, c.a + ho } };
+                for(int s=0; s<(hi < 0 ? 1 : 2); s++){
+                    int x0 = max(segs[s][0], X0), x1 = min(segs[s][1], X1);
+                    if(x0 <= x1) fillSpan(row + x0, x1 - x0 + 1, c.color);
+                }
+            }
+            break;
+        }
+        case CMD_TEXT: {
+            const char *s = textPool.data() + c.text;
+            int x0 = max(c.a, X0), x1 = min(c.c, X1);
+            for(int y=max(c.b, Y0); y<=min(c.d, Y1); y++){
+                uint32_t *row = base + (size_t)y*w;
+                fillSpan(row + x0, x1 - x0 + 1, c.back);
+                int gy = y - c.b;
+                if(gy >= 7) continue;
+                for(int i=(x0 - c.a)/8; i<=(x1 - c.a)/8; i++){
+                    unsigned char ch = (unsigned char)s[i];
+                    if(ch < 32 || ch > 126) ch = '?';
+                    unsigned bits = FONT[ch - 32][gy];
+                    for(int gx=0; bits && gx<5; gx++){
+                        int x = c.a + 8*i + 1 + gx;
+                        if((bits >> (4 - gx)) & 1 && x >= X0 && x <= X1) row[x] = c.color;
+                    }
+                }
+            }
+            break;
+        }
+        }
+    }
+}
+
+void SoftCanvas::flush(ThreadPool &pool){
+    PROFILE_SCOPE("raster.flush");
+    /* one worker gains nothing from tiles and would pay for splitting
+       every row that crosses a tile edge: draw the list as one clip region */
+    if(pool.size() == 1 || bins.size() == 1){
+        binned = (int64_t)cmds.size();
+        render(cmds, 0, 0, w-1, h-1);
+    } else {
+        for(size_t t=0; t<bins.size(); t++) bins[t].clear();
+        binned = 0;
+        for(uint32_t i=0; i<(uint32_t)cmds.size(); i++){
+            const Cmd &c = cmds[i];
+            switch(c.kind){
+            case CMD_LINE: binLine(i); break;
+            case CMD_FILL_ELLIPSE:
+            case CMD_ELLIPSE: binBox(i, (int64_t)c.a - c.c, (int64_t)c.b - c.d, (int64_t)c.a + c.c, (int64_t)c.b + c.d); break;
+            default: binBox(i, c.a, c.b, c.c, c.d); break;
+            }
+        }
+        pool.parallelFor(0, (int64_t)bins.size(), 1, [&](int64_t lo, int64_t hi, int){
+            for(int64_t t=lo; t<hi; t++){
+                if(bins[t].empty()) continue;
+                int x0 = (int)(t % tilesX) * tile, y0 = (int)(t / tilesX) * tile;
+                render(bins[t], x0, y0, min(x0 + tile, w) - 1, min(y0 + tile, h) - 1);
+            }
+        });
+    }
+    cmds.clear();
+    textPool.clear();
+    if(spans.size() > (1u << 20)){ spans.clear(); spanIndex.clear(); }  // many sizes (zooming): start over
+}
+
+/* --- Export --- */
+static bool fail(string *err, const string &msg){
+    if(err) *err = msg;
+    return false;
+}
+
+bool SoftCanvas::savePPM(const char *path, string *err) const {
+    FILE *f = fopen(path, "wb");
+    if(!f) return fail(err, string("cannot create ") + path);
+    fprintf(f, "P6\n%d %d\n255\n", w, h);
+    vector<unsigned char> row((size_t)w*3);
+    bool ok = true;
+    for(int y=0; y<h && ok; y++){
+        const uint32_t *p = &fb[(size_t)y*w];
+        for(int x=0; x<w; x++){ row[3*x] = (unsigned char)(p[x] >> 16); row[3*x+1] = (unsigned char)(p[x] >> 8); row[3*x+2] = (unsigned char)p[x]; }
+        ok = fwrite(&row[0], 1, row.size(), f) == row.size();
+    }
+    if(fclose(f) != 0) ok = false;
+    if(!ok) return fail(err, string("write failed: ") + path);
+    return true;
+}
+
+/* --- Deflate with the fixed Huffman code (RFC 1951, BTYPE 01) and a
+   greedy one-slot hash matcher: flat-coloured drawings compress to a few
+   percent of their size with no tables to transmit --- */
+namespace {
+
+struct BitWriter {
+    vector<unsigned char> &out;
+    uint64_t acc;
+    int nbits;
+
+    explicit BitWriter(vector<unsigned char> &o): out(o), acc(0), nbits(0) {}
+    void put(uint32_t bits, int n){
+        acc |= (uint64_t)bits << nbits;
+        nbits += n;
+        while(nbits >= 8){ out.push_back((unsigned char)acc); acc >>= 8; nbits -= 8; }
+    }
+    void code(uint32_t c, int n){               // Huffman codes go most significant bit first
+        uint32_t r = 0;
+        for(int i=0; i<n; i++) r |= ((c >> i) & 1) << (n - 1 - i);
+        put(r, n);
+    }
+    void finish(){ if(nbits > 0) out.push_back((unsigned char)acc); acc = 0; nbits = 0; }
+};
+
+const int LEN_BASE[29]  = { 3,4,5,6,7,8,9,10,11,13,15,17,19,23,27,31,35,43,51,59,67,83,99,115,131,163,195,227,258 };
+const int LEN_EXTRA[29] = { 0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2,3,3,3,3,4,4,4,4,5,5,5,5,0 };
+const int DIST_BASE[30] = { 1,2,3,4,5,7,9,13,17,25,33,49,65,97,129,193,257,385,513,769,
+                            1025,1537,2049,3073,4097,6145,8193,12289,16385,24577 };
+const int DIST_EXTRA[30] = { 0,0,0,0,1,1,2,2,3,3,4,4,5,5,6,6,7,7,8,8,9,9,10,10,11,11,12,12,13,13 };
+
+void putSymbol(BitWriter &bw, int sym){
+    if(sym < 144)      bw.code(0x30 + sym, 8);
+    else if(sym < 256) bw.code(0x190 + sym - 144, 9);
+    else if(sym < 280) bw.code(sym - 256, 7);
+    else               bw.code(0xC0 + sym - 280, 8);
+}
+
+void putMatch(BitWriter &bw, int len, int dist){
+    int i = 28;
+    while(LEN_BASE[i] > len) i--;
+    putSymbol(bw, 257 + i);
+    bw.put(len - LEN_BASE[i], LEN_EXTRA[i]);
+    int j = 29;
+    while(DIST_BASE[j] > dist) j--;
+    bw.code(j, 5);
+    bw.put(dist - DIST_BASE[j], DIST_EXTRA[j]);
+}
+
+void deflateFixed(const unsigned char *data, size_t n, vector<unsigned char> &out){
+    const int HASH_BITS = 15, WINDOW = 32768, MAX_LEN = 258;
+    vector<int64_t> head((size_t)1 << HASH_BITS, -1);
+    BitWriter bw(out);
+    bw.put(1, 1);                               // final block
+    bw.put(1, 2);                               // fixed Huffman
+    size_t i = 0;
+    while(i < n){
+        int len = 0, dist = 0;
+        if(i + 3 <= n){
+            uint32_t key = (uint32_t)data[i] | (uint32_t)data[i+1] << 8 | (uint32_t)data[i+2] << 16;
+            uint32_t hsh = (key * 2654435761u) >> (32 - HASH_BITS);
+            int64_t cand = head[hsh];
+            head[hsh] = (int64_t)i;
+            if(cand >= 0 && (int64_t)i - cand <= WINDOW){
+                size_t maxLen = min<size_t>(MAX_LEN, n - i);
+                size_t l = 0;
+                while(l < maxLen && data[cand + l] == data[i + l]) l++;
+                if(l >= 3){ len = (int)l; dist = (int)(i - cand); }
+            }
+        }
+        if(len){
+            putMatch(bw, len, dist);
+            i += len;
+        } else putSymbol(bw, data[i++]);
+    }
+    putSymbol(bw, 256);
+    bw.finish();
+}
+
+struct CrcTable {
+    uint32_t v[256];
+    CrcTable(){
+        for(uint32_t k=0; k<256; k++){
+            uint32_t c = k;
+            for(int b=0; b<8; b++) c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            v[k] = c;
+        }
+    }
+};
+
+uint32_t crc32Update(uint32_t crc, const unsigned char *p, size_t n){
+    static const CrcTable table;
+    crc = ~crc;
+    for(size_t i=0; i<n; i++) crc = table.v[(crc ^ p[i]) & 255] ^ (crc >> 8);
+    return ~crc;
+}
+
+uint32_t adler32(const unsigned char *p, size_t n){
+    uint32_t a = 1, b = 0;
+    while(n > 0){
+        size_t k = min<size_t>(n, 5552);        // largest run before b can overflow
+        n -= k;
+        for(; k>0; k--){ a += *p++; b += a; }
+        a %= 65521; b %= 65521;
+    }
+    return b << 16 | a;
+}
+
+void putBE32(vector<unsigned char> &v, uint32_t x){
+    v.push_back((unsigned char)(x >> 24)); v.push_back((unsigned char)(x >> 16));
+    v.push_back((unsigned char)(x >> 8));  v.push_back((unsigned char)x);
+}
+
+void putChunk(vector<unsigned char> &file, const char *type, const vector<unsigned char> &data){
+    putBE32(file, (uint32_t)data.size());
+    size_t start = file.size();
+    file.insert(file.end(), type, type + 4);
+    file.insert(file.end(), data.begin(), data.end());
+    putBE32(file, crc32Update(0, &file[start], file.size() - start));
+}
+
+}
+
+bool SoftCanvas::savePNG(const char *path, string *err) const {
+    /* scanlines, each prefixed with filter type 0 (none) */
+    size_t stride = (size_t)w*3 + 1;
+    vector<unsigned char> raw(stride * h);
+    for(int y=0; y<h; y++){
+        unsigned char *r = &raw[y*stride];
+        const uint32_t *p = &fb[(size_t)y*w];
+        r[0] = 0;
+        for(int x=0; x<w; x++){ r[1+3*x] = (unsigned char)(p[x] >> 16); r[2+3*x] = (unsigned char)(p[x] >> 8); r[3+3*x] = (unsigned char)p[x]; }
+    }
+
+    vector<unsigned char> file, ihdr, idat;
+    static const unsigned char SIGNATURE[8] = { 137, 'P', 'N', 'G', 13, 10, 26, 10 };
+    file.insert(file.end(), SIGNATURE, SIGNATURE + 8);
+    putBE32(ihdr, (uint32_t)w);
+    putBE32(ihdr, (uint32_t)h);
+    unsigned char fmt[5] = { 8, 2, 0, 0, 0 };   // 8-bit RGB, deflate, no filter method, no interlace
+    ihdr.insert(ihdr.end(), fmt, fmt + 5);
+    putChunk(file, "IHDR", ihdr);
+
+    idat.push_back(0x78); idat.push_back(0x01); // zlib header: deflate, 32K window
+    deflateFixed(&raw[0], raw.size(), idat);
+    putBE32(idat, adler32(&raw[0], raw.size()));
+    putChunk(file, "IDAT", idat);
+    putChunk(file, "IEND", vector<unsigned char>());
+
+    FILE *f = fopen(path, "wb");
+    if(!f) return fail(err, string("cannot create ") + path);
+    bool ok = fwrite(&file[0], 1, file.size(), f) == file.size();
+    if(fclose(f) != 0) ok = false;
+    if(!ok) return fail(err, string("write failed: ") + path);
+    return true;
+}
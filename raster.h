@@ -0,0 +1,93 @@
+/* raster.h - headless software backend for Canvas.
+   Drawing calls are recorded into a display list.  flush() bins every
+   command into the square tiles it touches (a line only into the tiles
+   along its path) and rasterizes the tiles in parallel on the thread pool;
+   each tile replays its commands in order, clipped to itself, so the image
+   does not depend on the thread count.  A one-thread pool skips the tiles
+   and draws the list in a single pass (same pixels).  Everything is drawn as horizontal
+   spans filled with SIMD stores; lines use exact integer stepping, so a
+   line split across tiles has no seams.  Text uses a built-in 5x7 font in
+   8x8 cells.
+
+   The framebuffer is 0x00RRGGBB, row-major, and can be written as binary
+   PPM or PNG (zlib stream with fixed-Huffman LZ77, no external library). */
+#ifndef RASTER_H
+#define RASTER_H
+
+#include "parallel.h"
+#include "scene.h"
+
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class SoftCanvas : public Canvas {
+public:
+    SoftCanvas(int width, int height, int tileSize = 128);
+
+    void resize(int width, int height);             // drops pending commands
+    void clear(int color);                          // queues a full-frame fill
+
+    void setColor(int c);
+    void setFillColor(int c);
+    void setTextBackground(int c);
+    void setLineWidth(int w);
+
+    void line(int x1,int y1,int x2,int y2);
+    void bar(int x1,int y1,int x2,int y2);
+    void rect(int x1,int y1,int x2,int y2);
+    void fillEllipse(int x,int y,int rx,int ry);
+    void circle(int x,int y,int r);
+    void ellipse(int x,int y,int rx,int ry);
+    void text(int x,int y,const char *s);
+
+    int textWidth(const char *s) { return 8*(int)strlen(s); }
+    int textHeight(const char *) { return 8; }
+
+    /* rasterize and drop the pending commands */
+    void flush(ThreadPool &pool = defaultPool());
+
+    int width() const { return w; }
+    int height() const { return h; }
+    int tileSize() const { return tile; }
+    const uint32_t *pixels() const { return &fb[0]; }
+    uint32_t pixel(int x,int y) const { return fb[(size_t)y*w + x]; }
+    size_t pendingCommands() const { return cmds.size(); }
+    int64_t lastBinned() const { return binned; }   // (command, tile) pairs of the last flush
+
+    bool savePPM(const char *path, std::string *err = 0) const;
+    bool savePNG(const char *path, std::string *err = 0) const;
+
+    static uint32_t paletteColor(int c);            // BGI colour -> 0x00RRGGBB
+
+private:
+    enum { CMD_LINE, CMD_BAR, CMD_FILL_ELLIPSE, CMD_ELLIPSE, CMD_TEXT };
+    struct Cmd {
+        uint8_t kind, width;
+        uint32_t color, back;       // back: background of CMD_TEXT
+        int a, b, c, d;             // endpoints, corners, or centre + radii
+        uint32_t text, len;         // CMD_TEXT: slice of textPool; ellipses: row tables in spans
+    };
+
+    int w, h, tile, tilesX, tilesY;
+    std::vector<uint32_t> fb;
+    std::vector<Cmd> cmds;
+    std::string textPool;
+    std::vector< std::vector<Cmd> > bins;           // per tile: copies of its commands, in order
+    std::vector<int> spans;                         // ellipse half-width per row, for each size seen
+    std::unordered_map<uint64_t, uint32_t> spanIndex;   // (rx, ry) -> offset of its rows in spans
+    uint32_t color, fill, back;
+    int lineWidth;
+    int64_t binned;
+
+    void push(const Cmd &c);
+    bool offFrame(int64_t x0, int64_t y0, int64_t x1, int64_t y1) const;
+    uint32_t spanTable(int rx, int ry);
+    void binBox(uint32_t id, int64_t x0, int64_t y0, int64_t x1, int64_t y1);
+    void binLine(uint32_t id);
+    void render(const std::vector<Cmd> &list, int X0, int Y0, int X1, int Y1);
+};
+
+#endif
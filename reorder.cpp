@@ -0,0 +1,167 @@
+/* reorder.cpp - RCM, degree and BFS vertex orderings */
+#include "reorder.h"
+
+#include <stdlib.h>
+#include <algorithm>
+
+using namespace std;
+
+const char *vertexOrderName(VertexOrder kind){
+    switch(kind){
+        case ORDER_RCM:    return "RCM";
+        case ORDER_DEGREE: return "degree";
+        case ORDER_BFS:    return "BFS";
+    }
+    return "?";
+}
+
+/* --- Out- plus in-edges of a directed graph (an undirected CSR already
+   lists every edge both ways) --- */
+static CsrGraph symmetric(const CsrView &g){
+    CsrGraph s;
+    s.offsets.assign(g.n + 1, 0);
+    for(int u=0;u<g.n;u++)
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){ s.offsets[u+1]++; s.offsets[g.targets[i]+1]++; }
+    for(int u=0;u<g.n;u++) s.offsets[u+1] += s.offsets[u];
+    s.targets.resize(s.offsets[g.n]);
+    vector<int64_t> pos(s.offsets.begin(), s.offsets.end() - 1);
+    for(int u=0;u<g.n;u++)
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v = g.targets[i];
+            s.targets[pos[u]++] = v;
+            s.targets[pos[v]++] = u;
+        }
+    return s;
+}
+
+/* --- Vertices by degree, ascending or descending, ties by id (counting sort) --- */
+static void byDegree(const CsrView &g, bool descending, vector<int> &out){
+    int maxDeg = 0;
+    for(int u=0;u<g.n;u++) maxDeg = max(maxDeg, g.degree(u));
+    vector<int> start(maxDeg + 2, 0);
+    for(int u=0;u<g.n;u++) start[(descending ? maxDeg - g.degree(u) : g.degree(u)) + 1]++;
+    for(int d=0;d<=maxDeg;d++) start[d+1] += start[d];
+    out.resize(g.n);
+    for(int u=0;u<g.n;u++) out[start[descending ? maxDeg - g.degree(u) : g.degree(u)]++] = u;
+}
+
+/* --- BFS over the component of s, appended to `queue`; visited vertices
+   get stamp[v] = mark.  Returns the index in `queue` where the last level
+   starts, and the number of levels in *levels.  sortByDegree: each
+   vertex's new neighbours join in increasing degree order (Cuthill-McKee)
+   instead of row order. --- */
+static size_t bfsComponent(const CsrView &g, int s, vector<int> &stamp, int mark, vector<int> &queue,
+                           bool sortByDegree, vector< pair<int,int> > &scratch, int *levels){
+    size_t head = queue.size(), levelStart = head, levelEnd = head + 1;
+    queue.push_back(s); stamp[s] = mark;
+    *levels = 1;
+    while(head < queue.size()){
+        if(head == levelEnd){ levelStart = levelEnd; levelEnd = queue.size(); ++*levels; }
+        int u = queue[head++];
+        if(!sortByDegree){
+            for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+                int v = g.targets[i];
+                if(stamp[v] != mark){ stamp[v] = mark; queue.push_back(v); }
+            }
+            continue;
+        }
+        scratch.clear();
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v = g.targets[i];
+            if(stamp[v] != mark){ stamp[v] = mark; scratch.push_back(make_pair(g.degree(v), v)); }
+        }
+        sort(scratch.begin(), scratch.end());
+        for(size_t k=0;k<scratch.size();k++) queue.push_back(scratch[k].second);
+    }
+    return levelStart;
+}
+
+/* --- George-Liu: move to a smallest-degree vertex of the last BFS level
+   while that makes the level structure deeper --- */
+static int pseudoPeripheral(const CsrView &g, int s, vector<int> &stamp, int &mark, vector<int> &queue,
+                            vector< pair<int,int> > &scratch){
+    int depth = 0;
+    for(int round=0; round<8; round++){             // rarely more than two or three
+        queue.clear();
+        int levels;
+        size_t last = bfsComponent(g, s, stamp, ++mark, queue, false, scratch, &levels);
+        if(round > 0 && levels <= depth) break;
+        depth = levels;
+        int best = queue[last];
+        for(size_t k=last+1;k<queue.size();k++) if(g.degree(queue[k]) < g.degree(best)) best = queue[k];
+        if(best == s) break;
+        s = best;
+    }
+    return s;
+}
+
+void computeVertexOrder(const CsrView &graph, VertexOrder kind, vector<int> &perm){
+    CsrGraph sym;
+    CsrView g = graph;
+    if(graph.directed){ sym = symmetric(graph); g = sym.view(); g.n = graph.n; }
+    int n = g.n;
+    vector<int> order, seeds;
+    order.reserve(n);
+
+    if(kind == ORDER_DEGREE){
+        byDegree(g, true, order);
+    } else {
+        /* RCM starts each component at its smallest degree vertex (then
+           pseudo-peripheral); BFS order at its largest */
+        byDegree(g, kind == ORDER_BFS, seeds);
+        vector<int> stamp(n, 0), queue;
+        vector< pair<int,int> > scratch;
+        vector<char> placed(n, 0);
+        int mark = 0;
+        for(int k=0;k<n;k++){
+            int s = seeds[k];
+            if(placed[s]) continue;
+            if(kind == ORDER_RCM) s = pseudoPeripheral(g, s, stamp, mark, queue, scratch);
+            queue.clear();
+            int levels;
+            bfsComponent(g, s, stamp, ++mark, queue, kind == ORDER_RCM, scratch, &levels);
+            for(size_t i=0;i<queue.size();i++){ placed[queue[i]] = 1; order.push_back(queue[i]); }
+        }
+        if(kind == ORDER_RCM) reverse(order.begin(), order.end());
+    }
+    perm.resize(n);
+    for(int i=0;i<n;i++) perm[order[i]] = i;
+}
+
+CsrGraph permuteCsr(const CsrView &g, const vector<int> &perm){
+    CsrGraph p;
+    p.weighted = g.weighted; p.directed = g.directed;
+    vector<int> inv(g.n);
+    for(int u=0;u<g.n;u++) inv[perm[u]] = u;
+    p.offsets.assign(g.n + 1, 0);
+    for(int v=0;v<g.n;v++) p.offsets[v+1] = p.offsets[v] + g.degree(inv[v]);
+    p.targets.resize(g.m);
+    if(g.weights) p.weights.resize(g.m);
+    vector< pair<int32_t,int32_t> > row;
+    for(int v=0;v<g.n;v++){
+        int u = inv[v];
+        row.clear();
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++)
+            row.push_back(make_pair(perm[g.targets[i]], g.weights ? g.weights[i] : 1));
+        sort(row.begin(), row.end());
+        int64_t at = p.offsets[v];
+        for(size_t k=0;k<row.size();k++){
+            p.targets[at + k] = row[k].first;
+            if(g.weights) p.weights[at + k] = row[k].second;
+        }
+    }
+    return p;
+}
+
+OrderProfile orderProfile(const CsrView &g){
+    OrderProfile p = { 0, 0.0 };
+    double sum = 0;
+    for(int u=0;u<g.n;u++)
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int64_t gap = llabs((int64_t)g.targets[i] - u);
+            p.bandwidth = max(p.bandwidth, gap);
+            sum += (double)gap;
+        }
+    p.meanGap = g.m ? sum / g.m : 0.0;
+    return p;
+}
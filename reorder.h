@@ -0,0 +1,42 @@
+/* reorder.h - vertex orderings for memory locality.  Editor ids are click
+   (or file) order, which says nothing about structure, so a traversal
+   jumps around the node and adjacency arrays.  Renumbering so that
+   neighbours get nearby ids keeps the vertices a level touches on the
+   same cache lines:
+
+     ORDER_RCM     reverse Cuthill-McKee: BFS from a pseudo-peripheral
+                   vertex of each component, neighbours by increasing
+                   degree, then reversed; narrows the bandwidth
+     ORDER_DEGREE  by decreasing degree: the hubs most rows point at are
+                   packed together at the front
+     ORDER_BFS     BFS from the highest-degree vertex of each component,
+                   neighbours in row order
+
+   Directed graphs are ordered by their underlying undirected structure.
+   A permutation maps old id -> new id; Graph::permute and History::permute
+   apply one (labels travel with their nodes, so what the user sees does
+   not change), permuteCsr applies one to a frozen CSR. */
+#ifndef REORDER_H
+#define REORDER_H
+
+#include "graph_core.h"
+
+#include <stdint.h>
+#include <vector>
+
+enum VertexOrder { ORDER_RCM, ORDER_DEGREE, ORDER_BFS };
+
+const char *vertexOrderName(VertexOrder kind);
+
+/* perm[old] = new, a permutation of 0..n-1 */
+void computeVertexOrder(const CsrView &g, VertexOrder kind, std::vector<int> &perm);
+
+/* rows in the new order, targets renumbered and sorted within each row */
+CsrGraph permuteCsr(const CsrView &g, const std::vector<int> &perm);
+
+/* locality of the current numbering: the largest and the mean |u - v|
+   over all adjacency entries */
+struct OrderProfile { int64_t bandwidth; double meanGap; };
+OrderProfile orderProfile(const CsrView &g);
+
+#endif
@@ -0,0 +1,258 @@
+/* scene.cpp - the editor's scene drawing over a Canvas */
+#include "scene.h"
+#include "profile.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+
+using namespace std;
+
+/* --- SceneText --- */
+SceneText::SceneText(): garbage(0), epoch(0), interned(0) {}
+
+void SceneText::clear(){
+    arena.clear();
+    labels.clear();
+    smallWeights.clear();
+    otherWeights.clear();
+    garbage = 0;
+}
+
+SceneText::Entry SceneText::intern(Canvas &c, const char *s){
+    Entry e;
+    e.at = (uint32_t)arena.size();
+    arena.insert(arena.end(), s, s + strlen(s) + 1);
+    e.w = (int16_t)c.textWidth(s);
+    e.h = (int16_t)c.textHeight(s);
+    interned++;
+    return e;
+}
+
+SceneText::Entry SceneText::label(Canvas &c, const Graph &g, int v){
+    if(g.epoch != epoch){ clear(); epoch = g.epoch; }
+    if(v >= (int)labels.size()){
+        Entry none = { NONE, 0, 0 };
+        labels.resize(g.slotCount(), none);
+    }
+    if(labels[v].at == NONE) labels[v] = intern(c, g.nodes[v].label.c_str());
+    return labels[v];
+}
+
+SceneText::Entry SceneText::weight(Canvas &c, int w){
+    Entry *e;
+    if(w >= 0 && w < SMALL_WEIGHTS){
+        if(smallWeights.empty()){
+            Entry none = { NONE, 0, 0 };
+            smallWeights.assign(SMALL_WEIGHTS, none);
+        }
+        e = &smallWeights[w];
+    } else {
+        unordered_map<int, Entry>::iterator it = otherWeights.find(w);
+        if(it != otherWeights.end()) return it->second;
+        Entry none = { NONE, 0, 0 };
+        e = &otherWeights.insert(make_pair(w, none)).first->second;
+    }
+    if(e->at == NONE){
+        char buf[16];
+        snprintf(buf, sizeof buf, "%d", w);
+        *e = intern(c, buf);
+    }
+    return *e;
+}
+
+/* --- Observer: a (re)occupied slot may carry a new label; once replaced
+   labels make up half the arena, start over --- */
+void SceneText::nodeInserted(const Graph &,int id){
+    if(id >= (int)labels.size() || labels[id].at == NONE) return;
+    garbage += strlen(&arena[labels[id].at]) + 1;
+    labels[id].at = NONE;
+    if(garbage > 4096 && garbage > arena.size()/2) clear();
+}
+
+void SceneText::nodeRemoved(const Graph &,int){}
+void SceneText::nodeMoved(const Graph &,int){}
+void SceneText::edgeAdded(const Graph &,int,int){}
+void SceneText::edgeRemoved(const Graph &,int,int){}
+
+/* positions-only resets (layout steps) keep the epoch and the labels */
+void SceneText::graphReset(const Graph &g){
+    if(g.epoch != epoch){ clear(); epoch = g.epoch; }
+}
+
+static const Viewport IDENTITY;
+
+/* --- Draw an arrow head between two points --- */
+void drawArrowHead(Canvas &c, int x1,int y1,int x2,int y2){
+    double dx = x2 - x1, dy = y2 - y1;
+    double len = sqrt(dx*dx + dy*dy);
+    if(len < 1.0) return;
+    double ux = dx/len, uy = dy/len;
+    int back = 12, side = 6;
+    double bx = x2 - ux*back, by = y2 - uy*back;
+    double sx = -uy*side, sy = ux*side;
+    int ax = (int)(bx + sx), ay = (int)(by + sy);
+    int bx2 = (int)(bx - sx), by2 = (int)(by - sy);
+    c.line(x2,y2,ax,ay); c.line(ax,ay,bx2,by2); c.line(bx2,by2,x2,y2);
+}
+
+/* --- A weight's text and size: interned, or formatted into buf --- */
+static const char *weightText(Canvas &c, int weight, SceneText *text, char *buf, size_t size, int *tw, int *th){
+    if(text){
+        SceneText::Entry e = text->weight(c, weight);
+        *tw = e.w; *th = e.h;
+        return text->str(e);
+    }
+    snprintf(buf, size, "%d", weight);
+    *tw = c.textWidth(buf); *th = c.textHeight(buf);
+    return buf;
+}
+
+/* --- Weight label: grey box with the number centred on (mx,my) --- */
+static void drawWeightText(Canvas &c, int mx, int my, const char *ws, int tw, int th){
+    c.setFillColor(PAL_LIGHTGRAY);
+    c.setTextBackground(PAL_LIGHTGRAY);
+    c.bar(mx-tw/2-4,my-th/2-2,mx+tw/2+4,my+th/2+2);
+    c.text(mx-tw/2,my-th/2,ws);
+}
+
+/* --- Draw an edge between two nodes --- */
+void drawEdge(Canvas &c, const Graph &g, int a, int b, int weight, SceneText *text, const Viewport *view){
+    const Viewport &v = view ? *view : IDENTITY;
+    int x1 = v.toScreenX(g.nodes[a].x), y1 = v.toScreenY(g.nodes[a].y);
+    int x2 = v.toScreenX(g.nodes[b].x), y2 = v.toScreenY(g.nodes[b].y);
+    double dx = x2 - x1, dy = y2 - y1;
+    double dist = sqrt(dx*dx + dy*dy);
+    if(dist < 1.0) return;
+    PROFILE_COUNT("scene.edges", 1);
+    double ux = dx/dist, uy = dy/dist, r = v.toScreenLen(NODE_RADIUS);
+    int sx = (int)(x1 + ux*r), sy = (int)(y1 + uy*r);
+    int ex = (int)(x2 - ux*r), ey = (int)(y2 - uy*r);
+    c.setColor(PAL_DARKGRAY);
+    c.line(sx,sy,ex,ey);
+    if(g.weighted && v.showText()){
+        char buf[16];
+        int tw, th;
+        const char *ws = weightText(c, weight, text, buf, sizeof buf, &tw, &th);
+        drawWeightText(c, (sx+ex)/2, (sy+ey)/2, ws, tw, th);
+    }
+    if(g.directed && v.showArrows()) drawArrowHead(c,sx,sy,ex,ey);
+}
+
+/* --- Draw a self-loop clearly outside the node (always visible) --- */
+void drawSelfLoop(Canvas &c, const Graph &g, int i, SceneText *text, const Viewport *view){
+    const Viewport &v = view ? *view : IDENTITY;
+    int r = NODE_RADIUS;
+    int ovalW = v.toScreenLen(r + 10);
+    int ovalH = v.toScreenLen(r/2 + 6);
+    int cx = v.toScreenX(g.nodes[i].x + r + 8);
+    int cy = v.toScreenY(g.nodes[i].y - r - 8);
+
+    c.setColor(PAL_DARKGRAY);
+    c.setLineWidth(2);
+    c.ellipse(cx, cy, ovalW, ovalH);
+    if(v.showArrows()){
+        int ax = cx - ovalW/2 + 2;
+        int ay = cy + ovalH/2 - 2;
+        drawArrowHead(c, ax-4, ay-3, ax, ay);
+    }
+    c.setLineWidth(1);
+
+    if(g.weighted && v.showText()){
+        int w = g.edgeWeight(i,i);
+        if(w >= 0){
+            char buf[16];
+            int tw, th;
+            const char *ws = weightText(c, w, text, buf, sizeof buf, &tw, &th);
+            drawWeightText(c, cx, cy - ovalH - th/2 - 4, ws, tw, th);
+        }
+    }
+}
+
+/* --- Draw one node disk with its label --- */
+void drawNode(Canvas &c, const Graph &g, int i, int fill, SceneText *text, const Viewport *view){
+    const Viewport &v = view ? *view : IDENTITY;
+    const Node &nd = g.nodes[i];
+    PROFILE_COUNT("scene.nodes", 1);
+    int x = v.toScreenX(nd.x), y = v.toScreenY(nd.y), r = v.toScreenLen(NODE_RADIUS);
+    c.setFillColor(fill);
+    c.setColor(PAL_BLACK);
+    c.fillEllipse(x,y,r,r);
+    c.setTextBackground(fill);
+    c.circle(x,y,r);
+    if(!v.showText()) return;
+    if(text){
+        SceneText::Entry e = text->label(c, g, i);
+        c.text(x-e.w/2,y-e.h/2,text->str(e));
+    } else {
+        const char *s = nd.label.c_str();
+        int tw = c.textWidth(s), th = c.textHeight(s);
+        c.text(x-tw/2,y-th/2,s);
+    }
+}
+
+void drawEdges(Canvas &c, const Graph &g, SceneText *text, const Viewport *view){
+    for(int i=0;i<g.slotCount();i++)
+        for(int j=0;j<g.degree(i);j++){
+            int to = g.target(i,j);
+            if(to != i && (g.directed || to > i)) drawEdge(c,g,i,to,g.weight(i,j),text,view);
+        }
+}
+
+void drawScene(Canvas &c, const Graph &g, SceneText *text, const Viewport *view){
+    drawEdges(c, g, text, view);
+    for(int i=0;i<g.slotCount();i++)
+        if(g.nodes[i].alive) drawNode(c, g, i, g.nodes[i].visited ? PAL_LIGHTGREEN : PAL_LIGHTCYAN, text, view);
+    for(int i=0;i<g.slotCount();i++)
+        if(g.nodes[i].alive && g.hasSelfLoop(i)) drawSelfLoop(c, g, i, text, view);
+}
+
+/* --- Culled drawing --- */
+bool viewAggregated(const SpatialIndex &index, const Viewport &view, const Rect &world){
+    if(view.scale < LOD_BUNDLE_SCALE) return true;
+    return index.countInRect(world.x0, world.y0, world.x1, world.y1, LOD_ITEM_BUDGET + 1) > LOD_ITEM_BUDGET;
+}
+
+void drawEdgesInView(Canvas &c, const Graph &g, const SpatialIndex &index, const Viewport &view,
+                     const Rect &world, SceneText *text){
+    static vector< pair<int,int> > edges;   // reused: a steady frame allocates nothing
+    index.edgesInRect(world.x0, world.y0, world.x1, world.y1, edges);
+    sort(edges.begin(), edges.end());
+    for(size_t k=0;k<edges.size();k++){
+        int u = edges[k].first, v = edges[k].second;
+        if(u != v) drawEdge(c, g, u, v, g.edgeWeight(u, v, 1), text, &view);
+    }
+}
+
+void drawBundles(Canvas &c, GridBundles &bundles, const Graph &g, const Viewport &view, const Rect &world){
+    static vector<int> cells;
+    const GridBundles::Level &L = bundles.level(g, view.toWorldLen(LOD_CELL_PX));
+    int gx0, gy0, gx1, gy1;
+    bundles.cellsInRect(L, world, cells, &gx0, &gy0, &gx1, &gy1);
+
+    /* a bundle is drawn from its first cell, or from the second when the
+       first is off screen */
+    c.setColor(PAL_DARKGRAY);
+    for(size_t k=0;k<cells.size();k++){
+        int cell = cells[k];
+        for(int i=L.first[cell]; i<L.first[cell+1]; i++){
+            const GridBundles::Bundle &b = L.bundles[L.refs[i]];
+            if(b.a != cell){
+                const GridBundles::Cell &o = L.cells[b.a];
+                if(o.gx >= gx0 && o.gx <= gx1 && o.gy >= gy0 && o.gy <= gy1) continue;
+            }
+            const GridBundles::Cell &p = L.cells[b.a], &q = L.cells[b.b];
+            c.setLineWidth(b.edges < 4 ? 1 : b.edges < 32 ? 2 : 3);
+            c.line(view.toScreenX(p.x), view.toScreenY(p.y), view.toScreenX(q.x), view.toScreenY(q.y));
+        }
+    }
+    c.setLineWidth(1);
+    c.setFillColor(PAL_LIGHTCYAN);
+    c.setColor(PAL_DARKGRAY);
+    for(size_t k=0;k<cells.size();k++){
+        const GridBundles::Cell &cl = L.cells[cells[k]];
+        int r = cl.nodes < 4 ? 2 : cl.nodes < 32 ? 3 : 4;
+        c.fillEllipse(view.toScreenX(cl.x), view.toScreenY(cl.y), r, r);
+    }
+}
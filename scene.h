@@ -0,0 +1,130 @@
+/* scene.h - the editor's scene drawing, written against an abstract Canvas.
+   Edges (with weight labels and arrow heads), node disks with their labels
+   and self-loops are drawn by the same code whether the Canvas is WinBGIm
+   in the editor, the headless rasterizer (raster.h) or a counting stub in
+   the benchmarks.  Text passes through as C strings, so a frame drawn
+   with a warm SceneText allocates nothing.
+
+   Node positions are world coordinates; with a Viewport (viewport.h) they
+   are zoomed and panned onto the Canvas and the zoom's level of detail
+   applies, without one they are drawn 1:1. */
+#ifndef SCENE_H
+#define SCENE_H
+
+#include "graph_core.h"
+#include "spatial_index.h"
+#include "viewport.h"
+
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+/* --- The 16 BGI colours, numbered as in graphics.h --- */
+enum PaletteColor {
+    PAL_BLACK, PAL_BLUE, PAL_GREEN, PAL_CYAN, PAL_RED, PAL_MAGENTA, PAL_BROWN, PAL_LIGHTGRAY,
+    PAL_DARKGRAY, PAL_LIGHTBLUE, PAL_LIGHTGREEN, PAL_LIGHTCYAN, PAL_LIGHTRED, PAL_LIGHTMAGENTA,
+    PAL_YELLOW, PAL_WHITE
+};
+
+/* --- Drawing backend ---
+   Immediate-mode primitives with BGI semantics: corners are inclusive,
+   fillEllipse fills with the fill colour and outlines with the line colour,
+   text is anchored at its top-left corner on an opaque background. */
+class Canvas {
+public:
+    virtual ~Canvas() {}
+
+    virtual void setColor(int c) = 0;           // lines, outlines and text
+    virtual void setFillColor(int c) = 0;       // bar, fillEllipse
+    virtual void setTextBackground(int c) = 0;
+    virtual void setLineWidth(int w) = 0;
+
+    virtual void line(int x1,int y1,int x2,int y2) = 0;
+    virtual void bar(int x1,int y1,int x2,int y2) = 0;
+    virtual void rect(int x1,int y1,int x2,int y2) = 0;
+    virtual void fillEllipse(int x,int y,int rx,int ry) = 0;
+    virtual void circle(int x,int y,int r) = 0;
+    virtual void ellipse(int x,int y,int rx,int ry) = 0;
+    virtual void text(int x,int y,const char *s) = 0;
+
+    virtual int textWidth(const char *s) = 0;
+    virtual int textHeight(const char *s) = 0;
+};
+
+/* --- Interned scene text ---
+   Node labels and weight values as drawn: formatted once, NUL-terminated
+   in one character arena, with the size the Canvas measured for them.  A
+   label is re-interned only when its slot is (re)occupied or the ids are
+   replaced; a weight's text depends on its value alone, so changing a
+   weight just looks up (or adds) another value.  Attach it as an observer
+   of the graph it draws, and keep one per Canvas (the sizes are that
+   Canvas's). */
+class SceneText : public GraphObserver {
+public:
+    struct Entry { uint32_t at; int16_t w, h; };    // arena offset, measured size
+
+    SceneText();
+
+    Entry label(Canvas &c, const Graph &g, int v);
+    Entry weight(Canvas &c, int w);
+    const char *str(const Entry &e) const { return &arena[e.at]; }
+
+    void clear();                       // drop everything (the arena keeps its capacity)
+    size_t arenaBytes() const { return arena.size(); }
+    int64_t misses() const { return interned; }     // strings formatted and measured so far
+
+    void nodeInserted(const Graph &g,int id);
+    void nodeRemoved(const Graph &g,int id);
+    void nodeMoved(const Graph &g,int id);
+    void edgeAdded(const Graph &g,int u,int v);
+    void edgeRemoved(const Graph &g,int u,int v);
+    void graphReset(const Graph &g);
+
+private:
+    static const uint32_t NONE = 0xffffffffu;
+    static const int SMALL_WEIGHTS = 1024;          // direct table; larger values are hashed
+
+    std::vector<char> arena;
+    std::vector<Entry> labels;                      // per slot
+    std::vector<Entry> smallWeights;
+    std::unordered_map<int, Entry> otherWeights;
+    size_t garbage;                                 // arena bytes of replaced labels
+    unsigned epoch;
+    int64_t interned;
+
+    Entry intern(Canvas &c, const char *s);
+};
+
+const int NODE_RADIUS = 22;
+
+/* With text == 0 labels and weights are measured (and weights formatted)
+   on every call, which still allocates nothing. */
+void drawArrowHead(Canvas &c, int x1,int y1,int x2,int y2);        // screen coordinates
+void drawEdge(Canvas &c, const Graph &g, int a, int b, int weight, SceneText *text = 0, const Viewport *view = 0);
+void drawSelfLoop(Canvas &c, const Graph &g, int i, SceneText *text = 0, const Viewport *view = 0);
+void drawNode(Canvas &c, const Graph &g, int i, int fill, SceneText *text = 0, const Viewport *view = 0);
+
+/* every non-loop edge once (an undirected edge from its lower endpoint) */
+void drawEdges(Canvas &c, const Graph &g, SceneText *text = 0, const Viewport *view = 0);
+
+/* the whole graph as a full editor redraw paints it: edges, then nodes
+   (visited ones green), then self-loops on top; the background is left
+   to the caller */
+void drawScene(Canvas &c, const Graph &g, SceneText *text = 0, const Viewport *view = 0);
+
+/* --- Drawing only what a camera sees; `world` is the visible world
+   rectangle (view.toWorld of the screen area) --- */
+
+/* true when the view should be drawn from GridBundles: zoomed out below
+   LOD_BUNDLE_SCALE, or more than LOD_ITEM_BUDGET index entries in view */
+bool viewAggregated(const SpatialIndex &index, const Viewport &view, const Rect &world);
+
+/* the non-loop edges the index has in `world`, in id order */
+void drawEdgesInView(Canvas &c, const Graph &g, const SpatialIndex &index, const Viewport &view,
+                     const Rect &world, SceneText *text = 0);
+
+/* the aggregated graph: a line per bundle touching a visible cell (wider
+   for more edges), then a dot per cell (larger for more nodes) */
+void drawBundles(Canvas &c, GridBundles &bundles, const Graph &g, const Viewport &view, const Rect &world);
+
+#endif
@@ -0,0 +1,170 @@
+/* script.cpp - batch command scripts */
+#include "script.h"
+
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+using namespace std;
+
+enum { CMD_ADD_NODE, CMD_ADD_EDGE, CMD_DELETE_NODE, CMD_DELETE_EDGE, CMD_CLEAR, CMD_BFS, CMD_DFS, CMD_COMMIT };
+
+struct Command { int op, a, b, c, argc, line; };
+
+struct Keyword { const char *name; int op, minArgs, maxArgs; };
+static const Keyword KEYWORDS[] = {
+    { "add_node", CMD_ADD_NODE, 2, 2 },    { "add_edge", CMD_ADD_EDGE, 2, 3 },
+    { "delete_node", CMD_DELETE_NODE, 1, 1 }, { "delete_edge", CMD_DELETE_EDGE, 2, 2 },
+    { "clear", CMD_CLEAR, 0, 0 },          { "bfs", CMD_BFS, 1, 1 },
+    { "dfs", CMD_DFS, 1, 1 },              { "commit", CMD_COMMIT, 0, 0 }
+};
+static const int KEYWORD_COUNT = sizeof(KEYWORDS)/sizeof(KEYWORDS[0]);
+
+static bool fail(string *err, const string &msg){ if(err) *err = msg; return false; }
+
+static bool failAt(string *err, int line, const string &msg){
+    char buf[32];
+    snprintf(buf, sizeof buf, "line %d: ", line);
+    return fail(err, buf + msg);
+}
+
+static double nowSec(){
+    return chrono::duration<double>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* --- One line: keyword and integer arguments; *blank for empty and
+   comment-only lines --- */
+static bool parseLine(char *s, int line, Command &c, bool *blank, string *err){
+    while(isspace((unsigned char)*s)) s++;
+    *blank = *s == 0 || *s == '#';
+    if(*blank) return true;
+    char *word = s;
+    while(*s && !isspace((unsigned char)*s)) s++;
+    size_t len = s - word;
+    int k = 0;
+    while(k < KEYWORD_COUNT && (strlen(KEYWORDS[k].name) != len || strncmp(KEYWORDS[k].name, word, len) != 0)) k++;
+    if(k == KEYWORD_COUNT) return failAt(err, line, "unknown command '" + string(word, len) + "'");
+
+    int args[3] = { 0, 0, 0 }, argc = 0;
+    for(;;){
+        while(isspace((unsigned char)*s)) s++;
+        if(*s == 0 || *s == '#') break;
+        char *end;
+        long v = strtol(s, &end, 10);
+        if(end == s || (*end && !isspace((unsigned char)*end) && *end != '#'))
+            return failAt(err, line, "expected an integer");
+        if(argc == 3) return failAt(err, line, "too many arguments");
+        args[argc++] = (int)v;
+        s = end;
+    }
+    const Keyword &kw = KEYWORDS[k];
+    if(argc < kw.minArgs || argc > kw.maxArgs) return failAt(err, line, string(kw.name) + ": wrong number of arguments");
+    c.op = kw.op; c.a = args[0]; c.b = args[1]; c.c = args[2]; c.argc = argc; c.line = line;
+    return true;
+}
+
+/* --- Lines up to `commit` or the end of the input --- */
+static bool readBatch(FILE *in, int &lineNo, vector<Command> &batch, bool *more, string *err){
+    batch.clear();
+    *more = false;
+    char buf[512];
+    while(fgets(buf, sizeof buf, in)){
+        lineNo++;
+        if(!strchr(buf, '\n') && !feof(in)) return failAt(err, lineNo, "line too long");
+        Command c = Command();
+        bool blank;
+        if(!parseLine(buf, lineNo, c, &blank, err)) return false;
+        if(blank) continue;
+        if(c.op == CMD_COMMIT){ *more = true; return true; }
+        batch.push_back(c);
+    }
+    if(ferror(in)) return fail(err, "read error");
+    return true;
+}
+
+static bool needNode(const Graph &g, int id, int line, string *err){
+    if(g.isAlive(id)) return true;
+    char buf[48];
+    snprintf(buf, sizeof buf, "no node %d", id);
+    return failAt(err, line, buf);
+}
+
+static bool apply(Graph &g, History &h, const Command &c, ScriptHost *host, ScriptStats &st, string *err){
+    switch(c.op){
+    case CMD_ADD_NODE:
+        h.addNode(g, c.a, c.b);
+        break;
+    case CMD_ADD_EDGE: {
+        if(!needNode(g, c.a, c.line, err) || !needNode(g, c.b, c.line, err)) return false;
+        int w = c.argc == 3 ? c.c : 1;
+        if(w <= 0) return failAt(err, c.line, "weights must be positive");
+        if(g.hasEdge(c.a, c.b)){ st.skipped++; break; }
+        h.addEdge(g, c.a, c.b, w);
+        break;
+    }
+    case CMD_DELETE_NODE:
+        if(!needNode(g, c.a, c.line, err)) return false;
+        h.deleteNode(g, c.a);
+        break;
+    case CMD_DELETE_EDGE: {
+        if(!needNode(g, c.a, c.line, err) || !needNode(g, c.b, c.line, err)) return false;
+        int k = g.findEdge(c.a, c.b);
+        if(k < 0) return failAt(err, c.line, "no such edge");
+        h.deleteEdge(g, c.a, k);
+        break;
+    }
+    case CMD_CLEAR:
+        h.clear(g);
+        break;
+    case CMD_BFS: case CMD_DFS:
+        if(!needNode(g, c.a, c.line, err)) return false;
+        if(host) host->traverse(g, c.op == CMD_BFS, c.a);
+        break;
+    }
+    st.commands++;
+    return true;
+}
+
+bool runScript(FILE *in, Graph &g, History &h, ScriptHost *host, ScriptStats *stOut, string *err){
+    ScriptStats st;
+    vector<Command> batch;
+    int lineNo = 0;
+    bool more = true, ok = true;
+    while(ok && more){
+        /* a bad line still lets the commands before it run */
+        ok = readBatch(in, lineNo, batch, &more, err);
+        if(batch.empty()) continue;
+
+        /* reserve for everything the batch adds before applying any of it */
+        int nodes = 0;
+        int64_t entries = 0;
+        for(size_t i=0;i<batch.size();i++){
+            if(batch[i].op == CMD_ADD_NODE) nodes++;
+            else if(batch[i].op == CMD_ADD_EDGE) entries += g.directed || batch[i].a == batch[i].b ? 1 : 2;
+        }
+        double t0 = nowSec();
+        int64_t before = st.commands;
+        g.reserve(nodes, entries);
+        h.beginBatch(batch.size());
+        for(size_t i=0;i<batch.size();i++)
+            if(!apply(g, h, batch[i], host, st, err)){ ok = false; break; }
+        h.endBatch();
+        st.seconds += nowSec() - t0;
+        if(st.commands == before) continue;
+        st.batches++;
+        if(host) host->batchApplied(g);
+    }
+    if(stOut) *stOut = st;
+    return ok;
+}
+
+bool runScriptFile(const char *path, Graph &g, History &h, ScriptHost *host, ScriptStats *st, string *err){
+    bool useStdin = strcmp(path, "-") == 0;
+    FILE *f = useStdin ? stdin : fopen(path, "r");
+    if(!f) return fail(err, string("cannot open ") + path);
+    bool ok = runScript(f, g, h, host, st, err);
+    if(!useStdin) fclose(f);
+    return ok;
+}
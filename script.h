@@ -0,0 +1,59 @@
+/* script.h - batch command scripts: build or edit a graph from a file or
+   a stream instead of the mouse, one command per line ('#' comments):
+
+       add_node X Y        new node at (X,Y); it takes the next free id
+       add_edge U V [W]    edge U->V (U-V when undirected), weight W (1);
+                           U == V adds a self-loop
+       delete_node U
+       delete_edge U V
+       clear
+       bfs S / dfs S       traversal from S, handed to the host
+       commit              ends the current batch
+
+   Ids are the editor's node ids (the labels it draws).  On an empty graph
+   without deletions, add_node hands out 0, 1, 2, ... in order.  Adding an
+   edge that already exists is skipped, as in the editor.
+
+   Commands are read one batch at a time (up to `commit` or the end of the
+   input) and parsed before anything is applied, so the batch can reserve
+   graph and history capacity for its additions.  The whole batch is then
+   applied as one undo entry, and the host gets one batchApplied() call,
+   which is where the editor repaints. */
+#ifndef SCRIPT_H
+#define SCRIPT_H
+
+#include "graph_core.h"
+#include "history.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+struct ScriptStats {
+    int64_t commands;       // commands applied
+    int64_t batches;        // non-empty batches (= undo entries)
+    int64_t skipped;        // edges that already existed
+    double seconds;
+
+    ScriptStats(): commands(0), batches(0), skipped(0), seconds(0) {}
+    double commandsPerSecond() const { return seconds > 0 ? commands / seconds : 0; }
+};
+
+/* --- Receives what a script does besides editing --- */
+class ScriptHost {
+public:
+    virtual ~ScriptHost() {}
+    virtual void batchApplied(const Graph &) {}
+    virtual void traverse(const Graph &, bool bfs, int start) { (void)bfs; (void)start; }
+};
+
+/* Runs the commands in `in` against g, logging each batch in h.  At the
+   first bad line (unknown command, dead node id, missing edge) it stops
+   with "line N: ..." in *err; everything before that line stays applied
+   and undoable. */
+bool runScript(FILE *in, Graph &g, History &h, ScriptHost *host = 0, ScriptStats *st = 0, std::string *err = 0);
+
+/* path "-" reads standard input */
+bool runScriptFile(const char *path, Graph &g, History &h, ScriptHost *host = 0, ScriptStats *st = 0, std::string *err = 0);
+
+#endif
@@ -0,0 +1,282 @@
+#include "shortest_path.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+
+using namespace std;
+
+static void initResult(SsspResult &out, int n){
+    out.dist.assign(n, SSSP_INF);
+    out.parent.assign(n, -1);
+    out.order.clear();
+    out.reached = 0; out.relaxations = 0;
+    out.buckets = 0; out.phases = 0;
+}
+
+static inline int64_t edgeWeight(const CsrView &g, int64_t e){
+    int64_t w = g.weights ? g.weights[e] : 1;
+    return w < 0 ? 0 : w;
+}
+
+/* --- Index of the highest set bit (x != 0) --- */
+static inline int highBit(uint64_t x){
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(x);
+#else
+    int b = 0;
+    while(x >>= 1) b++;
+    return b;
+#endif
+}
+
+/* --- Radix heap: bucket 0 holds keys equal to the last minimum, bucket
+   i>0 keys whose highest bit differing from it is i-1.  Popping from an
+   empty bucket 0 redistributes the first non-empty bucket around its
+   minimum; every key moves to a strictly lower bucket, so each push costs
+   at most 64 moves over its lifetime. --- */
+class RadixHeap {
+public:
+    RadixHeap(): last(0), count(0) {}
+
+    bool empty() const { return count == 0; }
+
+    void push(uint64_t key, int32_t v){
+        buckets[bucketOf(key)].push_back(make_pair(key, v));
+        count++;
+    }
+
+    void pop(uint64_t &key, int32_t &v){
+        if(buckets[0].empty()){
+            int i = 1;
+            while(buckets[i].empty()) i++;
+            vector< pair<uint64_t,int32_t> > &b = buckets[i];
+            uint64_t mn = b[0].first;
+            for(size_t k=1;k<b.size();k++) if(b[k].first < mn) mn = b[k].first;
+            last = mn;
+            for(size_t k=0;k<b.size();k++) buckets[bucketOf(b[k].first)].push_back(b[k]);
+            b.clear();
+        }
+        key = buckets[0].back().first;
+        v = buckets[0].back().second;
+        buckets[0].pop_back();
+        count--;
+    }
+
+private:
+    vector< pair<uint64_t,int32_t> > buckets[65];
+    uint64_t last;
+    size_t count;
+
+    int bucketOf(uint64_t key) const { return key == last ? 0 : highBit(key ^ last) + 1; }
+};
+
+void dijkstra(const CsrView &g, int source, SsspResult &out, const atomic<bool> *cancel){
+    initResult(out, g.n);
+    if(source<0 || source>=g.n) return;
+    out.order.reserve(g.n);
+    int64_t *dist = &out.dist[0];
+    int32_t *parent = &out.parent[0];
+    vector<char> done(g.n, 0);
+    RadixHeap heap;
+    dist[source] = 0; parent[source] = source;
+    heap.push(0, source);
+    while(!heap.empty()){
+        uint64_t d; int32_t u;
+        heap.pop(d, u);
+        if(done[u]) continue;               // stale entry
+        if(cancel && !(out.order.size() & 255) && cancel->load(memory_order_relaxed)) break;
+        done[u] = 1;
+        out.order.push_back(u);
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v = g.targets[i];
+            int64_t nd = (int64_t)d + edgeWeight(g, i);
+            if(nd < dist[v]){
+                dist[v] = nd; parent[v] = u;
+                heap.push((uint64_t)nd, v);
+                out.relaxations++;
+            }
+        }
+    }
+    out.reached = (int64_t)out.order.size();
+}
+
+void dijkstraBinaryHeap(const CsrView &g, int source, SsspResult &out){
+    initResult(out, g.n);
+    if(source<0 || source>=g.n) return;
+    out.order.reserve(g.n);
+    int64_t *dist = &out.dist[0];
+    int32_t *parent = &out.parent[0];
+    typedef pair<int64_t,int32_t> Item;
+    priority_queue< Item, vector<Item>, greater<Item> > heap;
+    dist[source] = 0; parent[source] = source;
+    heap.push(Item(0, source));
+    while(!heap.empty()){
+        Item top = heap.top(); heap.pop();
+        int u = top.second;
+        if(top.first > dist[u]) continue;   // stale entry
+        out.order.push_back(u);
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v = g.targets[i];
+            int64_t nd = top.first + edgeWeight(g, i);
+            if(nd < dist[v]){
+                dist[v] = nd; parent[v] = u;
+                heap.push(Item(nd, v));
+                out.relaxations++;
+            }
+        }
+    }
+    out.reached = (int64_t)out.order.size();
+}
+
+/* --- Default bucket width: about the mean weight over the mean degree,
+   so a bucket holds roughly one "layer" of relaxations --- */
+static int64_t pickDelta(const CsrView &g){
+    if(!g.weights || g.m == 0) return 1;
+    int64_t sum = 0;
+    int64_t step = g.m > 4096 ? g.m / 4096 : 1;
+    int64_t samples = 0;
+    for(int64_t e=0; e<g.m; e+=step){ sum += edgeWeight(g, e); samples++; }
+    double meanW = (double)sum / samples;
+    double meanDeg = g.n ? (double)g.m / g.n : 1.0;
+    int64_t d = (int64_t)(meanW * 4.0 / max(1.0, meanDeg));
+    return d < 1 ? 1 : d;
+}
+
+/* --- Lower the atomic distance to `nd`; true if this call lowered it --- */
+static inline bool relaxMin(atomic<int64_t> &slot, int64_t nd){
+    int64_t cur = slot.load(memory_order_relaxed);
+    while(nd < cur){
+        if(slot.compare_exchange_weak(cur, nd, memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+void deltaStepping(const CsrView &g, int source, SsspResult &out, const DeltaOptions &opt, ThreadPool &pool){
+    int n = g.n;
+    initResult(out, n);
+    if(source<0 || source>=n) return;
+    const int64_t delta = opt.delta > 0 ? opt.delta : pickDelta(g);
+
+    unique_ptr< atomic<int64_t>[] > dist(new atomic<int64_t>[n]);
+    pool.parallelFor(0, n, 4096, [&](int64_t lo, int64_t hi, int){
+        for(int64_t v=lo; v<hi; v++) dist[v].store(SSSP_INF, memory_order_relaxed);
+    });
+    dist[source].store(0, memory_order_relaxed);
+
+    /* per-worker bins indexed by absolute bucket number, plus the list of
+       bins each worker touched so merging does not scan all of them */
+    int workers = pool.size();
+    vector< vector< vector<int32_t> > > local(workers);
+    vector< vector<size_t> > touched(workers);
+    vector<int64_t> localRelax(workers, 0);
+
+    vector< vector<int32_t> > global(1);
+    global[0].push_back(source);
+    vector<int32_t> frontier;
+
+    for(size_t b=0; b<global.size(); b++){
+        if(global[b].empty()) continue;
+        out.buckets++;
+        frontier.swap(global[b]);
+        global[b].clear();
+        while(!frontier.empty()){
+            out.phases++;
+            pool.parallelFor(0, (int64_t)frontier.size(), 64, [&](int64_t lo, int64_t hi, int w){
+                vector< vector<int32_t> > &bins = local[w];
+                int64_t relax = 0;
+                for(int64_t f=lo; f<hi; f++){
+                    int u = frontier[f];
+                    int64_t du = dist[u].load(memory_order_relaxed);
+                    if((size_t)(du / delta) != b) continue;     // moved to an earlier bucket since queued
+                    for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+                        int v = g.targets[i];
+                        int64_t nd = du + edgeWeight(g, i);
+                        if(!relaxMin(dist[v], nd)) continue;
+                        relax++;
+                        size_t bin = (size_t)(nd / delta);
+                        if(bin >= bins.size()) bins.resize(bin + 1);
+                        if(bins[bin].empty()) touched[w].push_back(bin);
+                        bins[bin].push_back(v);
+                    }
+                }
+                localRelax[w] += relax;
+            });
+            frontier.clear();
+            for(int w=0; w<workers; w++){
+                for(size_t t=0; t<touched[w].size(); t++){
+                    size_t bin = touched[w][t];
+                    vector<int32_t> &src = local[w][bin];
+                    if(bin >= global.size()) global.resize(bin + 1);
+                    vector<int32_t> &dst = bin == b ? frontier : global[bin];
+                    dst.insert(dst.end(), src.begin(), src.end());
+                    src.clear();
+                }
+                touched[w].clear();
+            }
+        }
+    }
+
+    int64_t *outDist = &out.dist[0];
+    int32_t *parent = &out.parent[0];
+    vector<int64_t> localReached(workers, 0);
+    pool.parallelFor(0, n, 4096, [&](int64_t lo, int64_t hi, int w){
+        int64_t r = 0;
+        for(int64_t v=lo; v<hi; v++){
+            outDist[v] = dist[v].load(memory_order_relaxed);
+            if(outDist[v] != SSSP_INF) r++;
+        }
+        localReached[w] += r;
+    });
+    /* parents: pull from the incoming side when the graph is undirected
+       (rows are symmetric), otherwise push along out-edges with a CAS-min */
+    if(!g.directed){
+        pool.parallelFor(0, n, 1024, [&](int64_t lo, int64_t hi, int){
+            for(int64_t v=lo; v<hi; v++){
+                if(v == source || outDist[v] == SSSP_INF) continue;
+                int32_t best = -1;
+                for(int64_t i=g.offsets[v]; i<g.offsets[v+1]; i++){
+                    int u = g.targets[i];
+                    if(outDist[u] != SSSP_INF && outDist[u] + edgeWeight(g, i) == outDist[v] && (best < 0 || u < best)) best = u;
+                }
+                parent[v] = best;
+            }
+        });
+    } else {
+        unique_ptr< atomic<int32_t>[] > par(new atomic<int32_t>[n]);
+        for(int v=0; v<n; v++) par[v].store(INT32_MAX, memory_order_relaxed);
+        pool.parallelFor(0, n, 1024, [&](int64_t lo, int64_t hi, int){
+            for(int64_t u=lo; u<hi; u++){
+                if(outDist[u] == SSSP_INF) continue;
+                for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+                    int v = g.targets[i];
+                    if(v == source || outDist[u] + edgeWeight(g, i) != outDist[v]) continue;
+                    int32_t cur = par[v].load(memory_order_relaxed);
+                    while((int32_t)u < cur && !par[v].compare_exchange_weak(cur, (int32_t)u, memory_order_relaxed)) {}
+                }
+            }
+        });
+        for(int v=0; v<n; v++){
+            int32_t p = par[v].load(memory_order_relaxed);
+            parent[v] = p == INT32_MAX ? -1 : p;
+        }
+    }
+    parent[source] = source;
+    for(int w=0; w<workers; w++){ out.reached += localReached[w]; out.relaxations += localRelax[w]; }
+}
+
+void shortestPath(const SsspResult &r, int target, vector<int> &path){
+    path.clear();
+    if(target<0 || target>=(int)r.parent.size() || r.parent[target]<0) return;
+    int v = target;
+    while(true){
+        path.push_back(v);
+        int p = r.parent[v];
+        if(p == v || p < 0 || (int)path.size() > (int)r.parent.size()) break;
+        v = p;
+    }
+    reverse(path.begin(), path.end());
+}
@@ -0,0 +1,82 @@
+/* shortest_path.h - single-source shortest paths over non-negative
+   integer weights.  The sequential engine is Dijkstra on a radix heap
+   (a monotone priority queue: popped keys never decrease, so a push only
+   has to look at the bits where the key differs from the last minimum).
+   The parallel engine is delta-stepping (Meyer & Sanders): vertices are
+   kept in buckets of width delta and a whole bucket is relaxed at once
+   across the thread pool.  Both give a distance and a parent per vertex. */
+#ifndef SHORTEST_PATH_H
+#define SHORTEST_PATH_H
+
+#include "graph_core.h"
+#include "parallel.h"
+#include "trace.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+const int64_t SSSP_INF = INT64_MAX;
+
+struct SsspResult {
+    std::vector<int64_t> dist;      // SSSP_INF when unreached
+    std::vector<int32_t> parent;    // parent[source] = source, -1 when unreached
+    std::vector<int32_t> order;     // vertices in the order they were settled (sequential engines only)
+    int64_t reached;
+    int64_t relaxations;            // successful distance decreases
+    int buckets, phases;            // delta-stepping: non-empty buckets, relaxation rounds
+};
+
+/* Dijkstra on a radix heap; negative weights are treated as 0.  cancel,
+   if given, is polled every few hundred settled vertices; once it reads
+   true the search stops with only part of the graph settled. */
+void dijkstra(const CsrView &g, int source, SsspResult &out, const std::atomic<bool> *cancel = 0);
+
+/* Same search on a std::priority_queue with lazy deletion (baseline). */
+void dijkstraBinaryHeap(const CsrView &g, int source, SsspResult &out);
+
+struct DeltaOptions {
+    int64_t delta;              // bucket width; 0 = pick from the weights
+
+    DeltaOptions(): delta(0) {}
+};
+
+/* Delta-stepping.  Parents are chosen after the fact among the tight
+   edges (dist[u] + w == dist[v]), the smallest such u; with zero-weight
+   cycles that choice may not form a tree, so use dijkstra() there. */
+void deltaStepping(const CsrView &g, int source, SsspResult &out,
+                   const DeltaOptions &opt = DeltaOptions(), ThreadPool &pool = defaultPool());
+
+/* Vertices on the path source..target (empty when unreached). */
+void shortestPath(const SsspResult &r, int target, std::vector<int> &path);
+
+/* Replays a settled order as a Trace (or any recorder output, see
+   trace.h): step t settles order[t] (tree edge from its parent) and
+   discovers the neighbours it improves. */
+template<class Out>
+void recordSsspTrace(const CsrView &g, const SsspResult &r, Out &tr){
+    tr.clear(g.n);
+    if(r.order.empty()){ tr.finish(0); return; }
+    std::vector<int32_t> rank(g.n, INT32_MAX);
+    for(size_t t=0; t<r.order.size(); t++) rank[r.order[t]] = (int32_t)t;
+    std::vector<char> seen(g.n, 0);
+    int root = r.order[0];
+    seen[root] = 1;
+    tr.add(TRACE_DISCOVER, root, -1, 0);
+    for(size_t t=0; t<r.order.size(); t++){
+        int u = r.order[t];
+        uint32_t step = (uint32_t)t;
+        if(u != root) tr.add(TRACE_TREE, u, r.parent[u], step);
+        tr.add(TRACE_VISIT, u, u == root ? -1 : r.parent[u], step);
+        for(int64_t i=g.offsets[u]; i<g.offsets[u+1]; i++){
+            int v = g.targets[i];
+            if(seen[v] || rank[v] <= (int32_t)t) continue;
+            seen[v] = 1;
+            tr.add(TRACE_DISCOVER, v, u, step);
+        }
+        if(!tr.endStep(step + 1)) return;
+    }
+    tr.finish((uint32_t)r.order.size());
+}
+
+#endif
@@ -0,0 +1,267 @@
+#include "spatial_index.h"
+
+#include <math.h>
+#include <algorithm>
+
+using namespace std;
+
+/* --- Geometry helper: distance point-to-segment --- */
+double distPointToSegment(int px,int py,int ax,int ay,int bx,int by){
+    double vx=bx-ax,vy=by-ay;
+    double wx=px-ax,wy=py-ay;
+    double c1=vx*wx+vy*wy;
+    double c2=vx*vx+vy*vy;
+    double t=(c2<1e-6)?0.0:c1/c2;
+    if(t<0)t=0;
+    if(t>1)t=1;
+    double cx=ax+t*vx,cy=ay+t*vy;
+    double dx=px-cx,dy=py-cy;
+    return sqrt(dx*dx+dy*dy);
+}
+
+static void eraseValue(vector<int> &v,int x){
+    for(size_t i=0;i<v.size();i++) if(v[i]==x){ v[i]=v.back(); v.pop_back(); return; }
+}
+
+SpatialIndex::SpatialIndex(int nodeRadius, int edgePad, int cellSize)
+    : radius(nodeRadius), pad(edgePad), cell(cellSize > 0 ? cellSize : 64), stampGen(0) {}
+
+/* --- floor(v / cell) for negative coordinates too --- */
+int SpatialIndex::cellOf(int v) const {
+    return v >= 0 ? v / cell : -((-v + cell - 1) / cell);
+}
+
+void SpatialIndex::insertNodeCell(int id){
+    nodeGrid[key(cellOf(pos[id].x), cellOf(pos[id].y))].push_back(id);
+}
+
+void SpatialIndex::eraseNodeCell(int id){
+    CellMap::iterator it = nodeGrid.find(key(cellOf(pos[id].x), cellOf(pos[id].y)));
+    if(it==nodeGrid.end()) return;
+    eraseValue(it->second, id);
+    if(it->second.empty()) nodeGrid.erase(it);
+}
+
+/* --- Cells touched by an edge: the padded segment walked column by column,
+   or the hit circle of a self-loop --- */
+void SpatialIndex::edgeCells(const EdgeRec &e, vector<int64_t> &out) const {
+    out.clear();
+    const Pt &a = pos[e.u], &b = pos[e.v];
+    if(e.u==e.v){
+        int cx = a.x, cy = a.y - radius - radius/2, r = radius/2 + 8;
+        for(int gx=cellOf(cx-r); gx<=cellOf(cx+r); gx++)
+            for(int gy=cellOf(cy-r); gy<=cellOf(cy+r); gy++) out.push_back(key(gx,gy));
+        return;
+    }
+    int minx = min(a.x,b.x), maxx = max(a.x,b.x);
+    for(int gx=cellOf(minx-pad); gx<=cellOf(maxx+pad); gx++){
+        double xl = max((double)minx, (double)gx*cell - pad);
+        double xr = min((double)maxx, (double)(gx+1)*cell - 1 + pad);
+        if(xl > xr){ xl = xr = (xl < minx ? minx : maxx); }
+        double yl, yr;
+        if(a.x==b.x){ yl = min(a.y,b.y); yr = max(a.y,b.y); }
+        else {
+            double s = (double)(b.y-a.y)/(b.x-a.x);
+            double y1 = a.y + (xl-a.x)*s, y2 = a.y + (xr-a.x)*s;
+            yl = min(y1,y2); yr = max(y1,y2);
+        }
+        for(int gy=cellOf((int)floor(yl)-pad); gy<=cellOf((int)ceil(yr)+pad); gy++) out.push_back(key(gx,gy));
+    }
+}
+
+void SpatialIndex::linkEdge(int r){
+    vector<int64_t> ks; edgeCells(recs[r], ks);
+    for(size_t i=0;i<ks.size();i++) edgeGrid[ks[i]].push_back(r);
+}
+
+void SpatialIndex::unlinkEdge(int r){
+    vector<int64_t> ks; edgeCells(recs[r], ks);
+    for(size_t i=0;i<ks.size();i++){
+        CellMap::iterator it = edgeGrid.find(ks[i]);
+        if(it==edgeGrid.end()) continue;
+        eraseValue(it->second, r);
+        if(it->second.empty()) edgeGrid.erase(it);
+    }
+}
+
+int SpatialIndex::addRec(int u,int v){
+    int r;
+    if(!freeRecs.empty()){ r = freeRecs.back(); freeRecs.pop_back(); }
+    else { r = (int)recs.size(); recs.push_back(EdgeRec()); }
+    recs[r].u = u; recs[r].v = v; recs[r].live = true;
+    incident[u].push_back(r);
+    if(v!=u) incident[v].push_back(r);
+    linkEdge(r);
+    return r;
+}
+
+void SpatialIndex::dropRec(int r){
+    unlinkEdge(r);
+    eraseValue(incident[recs[r].u], r);
+    if(recs[r].v!=recs[r].u) eraseValue(incident[recs[r].v], r);
+    recs[r].live = false;
+    freeRecs.push_back(r);
+}
+
+void SpatialIndex::rebuild(const Graph &g){
+    nodeGrid.clear(); edgeGrid.clear(); recs.clear(); freeRecs.clear();
+    int n = g.slotCount();
+    pos.resize(n);
+    incident.assign(n, vector<int>());
+    for(int i=0;i<n;i++){
+        pos[i].x = g.nodes[i].x; pos[i].y = g.nodes[i].y;
+        if(g.nodes[i].alive) insertNodeCell(i);
+    }
+    for(int u=0;u<n;u++)
+        for(int k=0;k<(int)g.adj[u].size();k++){
+            int v = g.adj[u][k].first;
+            if(g.directed || v>=u) addRec(u,v);
+        }
+}
+
+/* --- Queries --- */
+int SpatialIndex::nodeAt(int x,int y) const {
+    int best = -1;
+    for(int gx=cellOf(x-radius); gx<=cellOf(x+radius); gx++)
+        for(int gy=cellOf(y-radius); gy<=cellOf(y+radius); gy++){
+            CellMap::const_iterator it = nodeGrid.find(key(gx,gy));
+            if(it==nodeGrid.end()) continue;
+            const vector<int> &ns = it->second;
+            for(size_t i=0;i<ns.size();i++){
+                int dx = x - pos[ns[i]].x, dy = y - pos[ns[i]].y;
+                if(dx*dx + dy*dy <= radius*radius && (best<0 || ns[i]<best)) best = ns[i];
+            }
+        }
+    return best;
+}
+
+/* --- Closest segment within threshold wins; self-loops only if no segment
+   is close (same priority as the old two-pass scan).  Segments are filed
+   with `pad` around them, so a wider threshold (a zoomed-out view) also
+   looks at the neighbouring cells. --- */
+pair<int,int> SpatialIndex::edgeNear(int x,int y,double threshold) const {
+    int reach = threshold > pad ? (int)ceil(threshold - pad) : 0;
+    int bestSeg = -1, bestLoop = -1;
+    double bestD = threshold;
+    int lr = radius/2 + 8;
+    for(int gx=cellOf(x-reach); gx<=cellOf(x+reach); gx++)
+        for(int gy=cellOf(y-reach); gy<=cellOf(y+reach); gy++){
+            CellMap::const_iterator it = edgeGrid.find(key(gx,gy));
+            if(it==edgeGrid.end()) continue;
+            const vector<int> &es = it->second;
+            for(size_t i=0;i<es.size();i++){
+                const EdgeRec &e = recs[es[i]];
+                const Pt &a = pos[e.u];
+                if(e.u==e.v){
+                    int dx = x - a.x, dy = y - (a.y - radius - radius/2);
+                    if(dx*dx + dy*dy <= lr*lr && bestLoop<0) bestLoop = es[i];
+                    continue;
+                }
+                const Pt &b = pos[e.v];
+                double d = distPointToSegment(x,y,a.x,a.y,b.x,b.y);
+                if(d<=bestD){ bestD = d; bestSeg = es[i]; }
+            }
+        }
+    int r = bestSeg>=0 ? bestSeg : bestLoop;
+    if(r<0) return make_pair(-1,-1);
+    return make_pair(recs[r].u, recs[r].v);
+}
+
+/* --- Occupied cells of `map` overlapping a world rectangle: looked up
+   one by one when the rectangle spans fewer cells than are occupied,
+   otherwise the occupied ones are scanned.  visit returns false to stop. --- */
+template<class F>
+void SpatialIndex::forEachCell(const CellMap &map, int x0,int y0,int x1,int y1, F visit) const {
+    int gx0 = cellOf(x0), gy0 = cellOf(y0), gx1 = cellOf(x1), gy1 = cellOf(y1);
+    if(gx0 > gx1 || gy0 > gy1) return;
+    int64_t span = (int64_t)(gx1 - gx0 + 1) * (gy1 - gy0 + 1);
+    if(span > (int64_t)map.size()){
+        for(CellMap::const_iterator it = map.begin(); it != map.end(); ++it){
+            int gx = (int)(int32_t)(uint32_t)((uint64_t)it->first >> 32), gy = (int)(int32_t)(uint32_t)it->first;
+            if(gx >= gx0 && gx <= gx1 && gy >= gy0 && gy <= gy1 && !visit(it->second)) return;
+        }
+        return;
+    }
+    for(int gx=gx0; gx<=gx1; gx++)
+        for(int gy=gy0; gy<=gy1; gy++){
+            CellMap::const_iterator it = map.find(key(gx,gy));
+            if(it!=map.end() && !visit(it->second)) return;
+        }
+}
+
+void SpatialIndex::nodesInRect(int x0,int y0,int x1,int y1, vector<int> &out) const {
+    out.clear();
+    int r = radius;
+    forEachCell(nodeGrid, x0-r, y0-r, x1+r, y1+r, [&](const vector<int> &ns){
+        for(size_t i=0;i<ns.size();i++){
+            const Pt &p = pos[ns[i]];
+            if(p.x+r>=x0 && p.x-r<=x1 && p.y+r>=y0 && p.y-r<=y1) out.push_back(ns[i]);
+        }
+        return true;
+    });
+}
+
+void SpatialIndex::edgesInRect(int x0,int y0,int x1,int y1, vector< pair<int,int> > &out) const {
+    out.clear();
+    if(stamp.size()<recs.size()) stamp.resize(recs.size(), 0);
+    if(++stampGen==0){ fill(stamp.begin(), stamp.end(), 0); stampGen = 1; }
+    forEachCell(edgeGrid, x0, y0, x1, y1, [&](const vector<int> &es){
+        for(size_t i=0;i<es.size();i++){
+            if(stamp[es[i]]==stampGen) continue;
+            stamp[es[i]] = stampGen;
+            out.push_back(make_pair(recs[es[i]].u, recs[es[i]].v));
+        }
+        return true;
+    });
+}
+
+int64_t SpatialIndex::countInRect(int x0,int y0,int x1,int y1,int64_t limit) const {
+    int64_t n = 0;
+    forEachCell(nodeGrid, x0, y0, x1, y1, [&](const vector<int> &ns){ n += (int64_t)ns.size(); return n < limit; });
+    if(n < limit) forEachCell(edgeGrid, x0, y0, x1, y1, [&](const vector<int> &es){ n += (int64_t)es.size(); return n < limit; });
+    return min(n, limit);
+}
+
+/* --- GraphObserver --- */
+void SpatialIndex::nodeInserted(const Graph &g,int id){
+    if(id >= (int)pos.size()){ pos.resize(id+1); incident.resize(id+1); }
+    pos[id].x = g.nodes[id].x; pos[id].y = g.nodes[id].y;
+    insertNodeCell(id);
+}
+
+void SpatialIndex::nodeRemoved(const Graph &,int id){
+    vector<int> inc = incident[id];
+    for(size_t i=0;i<inc.size();i++) dropRec(inc[i]);
+    eraseNodeCell(id);
+}
+
+void SpatialIndex::nodeMoved(const Graph &g,int id){
+    const vector<int> &inc = incident[id];
+    for(size_t i=0;i<inc.size();i++) unlinkEdge(inc[i]);
+    eraseNodeCell(id);
+    pos[id].x = g.nodes[id].x; pos[id].y = g.nodes[id].y;
+    insertNodeCell(id);
+    for(size_t i=0;i<inc.size();i++) linkEdge(inc[i]);
+}
+
+void SpatialIndex::edgeAdded(const Graph &,int u,int v){
+    addRec(u,v);
+}
+
+void SpatialIndex::edgeRemoved(const Graph &g,int u,int v){
+    const vector<int> &inc = incident[u];
+    int found = -1;
+    for(size_t i=0;i<inc.size() && found<0;i++){
+        const EdgeRec &e = recs[inc[i]];
+        if(e.u==u && e.v==v) found = inc[i];
+    }
+    for(size_t i=0;i<inc.size() && found<0 && !g.directed;i++){
+        const EdgeRec &e = recs[inc[i]];
+        if(e.u==v && e.v==u) found = inc[i];
+    }
+    if(found>=0) dropRec(found);
+}
+
+void SpatialIndex::graphReset(const Graph &g){
+    rebuild(g);
+}
@@ -0,0 +1,79 @@
+/* spatial_index.h - uniform hashed grid over node centres and edge
+   segments, used for mouse hit testing (node under cursor, edge near
+   cursor) without scanning the whole graph.
+
+   Attach it to a Graph with g.addObserver(&index) after rebuild(g); it then
+   follows every edit incrementally.  Node hits use the node radius, edge
+   hits pad each segment by `edgePad` pixels, self-loops use the same
+   circle the editor has always used for them. */
+#ifndef SPATIAL_INDEX_H
+#define SPATIAL_INDEX_H
+
+#include "graph_core.h"
+
+#include <stdint.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* --- Geometry helper: distance point-to-segment --- */
+double distPointToSegment(int px,int py,int ax,int ay,int bx,int by);
+
+class SpatialIndex : public GraphObserver {
+public:
+    SpatialIndex(int nodeRadius, int edgePad = 8, int cellSize = 64);
+
+    void rebuild(const Graph &g);
+
+    int nodeAt(int x,int y) const;                                 // lowest id hit, or -1
+    std::pair<int,int> edgeNear(int x,int y,double threshold) const; // (u,v) or (-1,-1)
+
+    /* everything whose indexed area overlaps the rectangle (for redraws);
+       ids are unique, in no particular order.  Rectangle queries cost
+       the smaller of the cells it spans and the occupied cells, so a
+       zoomed-out view does not walk empty space. */
+    void nodesInRect(int x0,int y0,int x1,int y1, std::vector<int> &out) const;
+    void edgesInRect(int x0,int y0,int x1,int y1, std::vector< std::pair<int,int> > &out) const;
+    /* node and edge entries filed in the cells the rectangle overlaps,
+       counted up to `limit` (a density estimate costing one lookup per cell) */
+    int64_t countInRect(int x0,int y0,int x1,int y1, int64_t limit) const;
+
+    size_t cellCount() const { return nodeGrid.size() + edgeGrid.size(); }   // node and edge cells apart
+
+    /* GraphObserver */
+    void nodeInserted(const Graph &g,int id);
+    void nodeRemoved(const Graph &g,int id);
+    void nodeMoved(const Graph &g,int id);
+    void edgeAdded(const Graph &g,int u,int v);
+    void edgeRemoved(const Graph &g,int u,int v);
+    void graphReset(const Graph &g);
+
+private:
+    typedef std::unordered_map<int64_t, std::vector<int> > CellMap;
+    struct EdgeRec { int u, v; bool live; };
+    struct Pt { int x, y; };
+
+    int radius, pad, cell;
+    std::vector<Pt> pos;                        // copy of node centres (per slot)
+    std::vector< std::vector<int> > incident;   // edge records per node
+    std::vector<EdgeRec> recs;
+    std::vector<int> freeRecs;
+    CellMap nodeGrid;                           // node ids per cell
+    CellMap edgeGrid;                           // indices into recs per cell
+    mutable std::vector<int> stamp;             // dedupe for rect queries
+    mutable int stampGen;
+
+    static int64_t key(int cx,int cy) { return (int64_t)(((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy); }
+    int cellOf(int v) const;
+    template<class F> void forEachCell(const CellMap &map, int x0,int y0,int x1,int y1, F visit) const;
+
+    void insertNodeCell(int id);
+    void eraseNodeCell(int id);
+    void edgeCells(const EdgeRec &e, std::vector<int64_t> &out) const;
+    void linkEdge(int r);
+    void unlinkEdge(int r);
+    int  addRec(int u,int v);
+    void dropRec(int r);
+};
+
+#endif
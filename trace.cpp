@@ -0,0 +1,73 @@
+#include "trace.h"
+
+using namespace std;
+
+TracePlayer::TracePlayer(): trace(0), cursor(0), pos(0), rate(1000.0/220.0), clock(0.0), paused(false) {}
+
+void TracePlayer::load(const Trace &tr){
+    trace = &tr;
+    states.assign(tr.nodeCount, UNSEEN);
+    parents.assign(tr.nodeCount, -1);
+    cursor = 0; pos = 0; clock = 0.0;
+}
+
+void TracePlayer::unload(){
+    trace = 0;
+    states.clear(); parents.clear();
+    cursor = 0; pos = 0; clock = 0.0;
+}
+
+void TracePlayer::setSpeed(double stepsPerSecond){
+    if(stepsPerSecond < 0.1) stepsPerSecond = 0.1;
+    rate = stepsPerSecond;
+}
+
+bool TracePlayer::atEnd() const {
+    return !trace || pos >= trace->steps;
+}
+
+void TracePlayer::apply(const TraceEvent &e, vector<int> &changed){
+    switch(e.kind()){
+        case TRACE_DISCOVER: states[e.node] = FRONTIER; break;
+        case TRACE_VISIT:    states[e.node] = DONE; break;
+        case TRACE_TREE:     parents[e.node] = e.parent; return;
+    }
+    changed.push_back(e.node);
+}
+
+void TracePlayer::revert(const TraceEvent &e, vector<int> &changed){
+    switch(e.kind()){
+        case TRACE_DISCOVER: states[e.node] = UNSEEN; break;
+        case TRACE_VISIT:    states[e.node] = FRONTIER; break;
+        case TRACE_TREE:     parents[e.node] = -1; return;
+    }
+    changed.push_back(e.node);
+}
+
+/* --- Move to `target` steps applied; cost is proportional to the distance --- */
+void TracePlayer::seek(uint32_t target, vector<int> &changed){
+    if(!trace) return;
+    if(target > trace->steps) target = trace->steps;
+    const vector<TraceEvent> &ev = trace->events;
+    while(cursor < ev.size() && ev[cursor].step() < target) apply(ev[cursor++], changed);
+    while(cursor > 0 && ev[cursor-1].step() >= target) revert(ev[--cursor], changed);
+    pos = target;
+    clock = target;
+}
+
+void TracePlayer::step(vector<int> &changed){ seek(pos+1, changed); }
+
+void TracePlayer::stepBack(vector<int> &changed){ if(pos>0) seek(pos-1, changed); }
+
+void TracePlayer::skipToEnd(vector<int> &changed){ if(trace) seek(trace->steps, changed); }
+
+void TracePlayer::advance(double seconds, vector<int> &changed){
+    if(!trace || paused || atEnd()) return;
+    clock += seconds * rate;
+    uint32_t target = clock >= trace->steps ? trace->steps : (uint32_t)clock;
+    if(target != pos){
+        double keep = clock;
+        seek(target, changed);
+        clock = keep;
+    }
+}
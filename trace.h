@@ -0,0 +1,157 @@
+/* trace.h - record a traversal once at full speed, replay it later.
+   A Trace is a flat list of events stamped with a logical step number:
+   step t visits one vertex and discovers the neighbours it reaches.
+   TracePlayer walks that list forwards or backwards at any speed and
+   reports which vertices changed state, so the editor repaints only those.
+
+   The recorders write to any `Out` with Trace's clear / add / endStep /
+   finish members: the background worker (algo_worker.h) streams events out
+   in chunks that way, and stops a traversal when endStep returns false. */
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+enum TraceKind {
+    TRACE_DISCOVER = 0,     // node first reached (queued / pushed)
+    TRACE_VISIT    = 1,     // node processed
+    TRACE_TREE     = 2      // tree edge parent -> node
+};
+
+/* --- 16 bytes per event: node, parent, step:32 | kind:8.  A step visits
+   one vertex, so any traversal fits; a 24-bit step wrapped past 16M. --- */
+struct TraceEvent {
+    int32_t  node;
+    int32_t  parent;        // -1 for the root
+    uint64_t packed;
+
+    uint32_t step() const { return (uint32_t)(packed >> 8); }
+    TraceKind kind() const { return (TraceKind)(packed & 0xff); }
+
+    static TraceEvent make(TraceKind k, int node, int parent, uint32_t step){
+        TraceEvent e; e.node = node; e.parent = parent; e.packed = ((uint64_t)step << 8) | (uint32_t)k;
+        return e;
+    }
+};
+
+class Trace {
+public:
+    std::vector<TraceEvent> events;
+    int nodeCount;          // vertex count of the graph it was recorded on
+    uint32_t steps;         // number of visit steps
+
+    Trace(): nodeCount(0), steps(0) {}
+
+    void clear(int n) { events.clear(); nodeCount = n; steps = 0; }
+    void add(TraceKind k, int node, int parent, uint32_t step){ events.push_back(TraceEvent::make(k, node, parent, step)); }
+    bool endStep(uint32_t) { return true; }             // `done` steps complete; false stops the recorder
+    void finish(uint32_t done) { steps = done; }
+};
+
+/* --- Record a BFS: discover on enqueue, visit on dequeue --- */
+template<class G, class Out>
+void recordBfsTrace(const G &g, int start, Out &tr){
+    int n = g.vertexCount();
+    tr.clear(n);
+    if(start<0||start>=n){ tr.finish(0); return; }
+    std::vector<char> seen(n, 0);
+    std::vector<int> q; q.reserve(n);
+    size_t head = 0;
+    q.push_back(start); seen[start]=1;
+    tr.add(TRACE_DISCOVER, start, -1, 0);
+    uint32_t step = 0;
+    while(head<q.size()){
+        int u=q[head++];
+        tr.add(TRACE_VISIT, u, -1, step);
+        int d=g.degree(u);
+        for(int k=0;k<d;k++){
+            int v=g.target(u,k);
+            if(!seen[v]){
+                seen[v]=1; q.push_back(v);
+                tr.add(TRACE_DISCOVER, v, u, step);
+                tr.add(TRACE_TREE, v, u, step);
+            }
+        }
+        step++;
+        if(!tr.endStep(step)) return;
+    }
+    tr.finish(step);
+}
+
+/* --- Record a DFS (same stack discipline as dfsOrder): a tree edge is
+   emitted when a vertex is actually visited, from the vertex that pushed it --- */
+template<class G, class Out>
+void recordDfsTrace(const G &g, int start, Out &tr){
+    int n = g.vertexCount();
+    tr.clear(n);
+    if(start<0||start>=n){ tr.finish(0); return; }
+    std::vector<char> seen(n, 0), pushed(n, 0);
+    std::vector< std::pair<int,int> > st;        // (vertex, pusher)
+    st.push_back(std::make_pair(start,-1)); pushed[start]=1;
+    tr.add(TRACE_DISCOVER, start, -1, 0);
+    uint32_t step = 0;
+    while(!st.empty()){
+        int u=st.back().first, p=st.back().second; st.pop_back();
+        if(seen[u]) continue;
+        seen[u]=1;
+        if(p>=0) tr.add(TRACE_TREE, u, p, step);
+        tr.add(TRACE_VISIT, u, p, step);
+        for(int i=g.degree(u)-1;i>=0;i--){
+            int v=g.target(u,i);
+            if(seen[v]) continue;
+            if(!pushed[v]){ pushed[v]=1; tr.add(TRACE_DISCOVER, v, u, step); }
+            st.push_back(std::make_pair(v,u));
+        }
+        step++;
+        if(!tr.endStep(step)) return;
+    }
+    tr.finish(step);
+}
+
+/* --- Replays a Trace; per-node state is UNSEEN -> FRONTIER -> DONE --- */
+class TracePlayer {
+public:
+    enum NodeState { UNSEEN = 0, FRONTIER = 1, DONE = 2 };
+
+    TracePlayer();
+
+    void load(const Trace &tr);             // copies nothing; `tr` must outlive playback
+    void unload();
+    bool loaded() const { return trace != 0; }
+
+    void   setSpeed(double stepsPerSecond);
+    double speed() const { return rate; }
+    void   play() { paused = false; }
+    void   pause() { paused = true; }
+    bool   isPaused() const { return paused; }
+    bool   atEnd() const;
+
+    /* each call appends the vertices whose state changed to `changed` */
+    void advance(double seconds, std::vector<int> &changed);   // plays if not paused
+    void step(std::vector<int> &changed);                       // one step forward
+    void stepBack(std::vector<int> &changed);
+    void seek(uint32_t step, std::vector<int> &changed);        // first `step` steps applied
+    void skipToEnd(std::vector<int> &changed);
+
+    uint32_t position() const { return pos; }
+    uint32_t length() const { return trace ? trace->steps : 0; }
+    NodeState state(int v) const { return (v>=0 && v<(int)states.size()) ? (NodeState)states[v] : UNSEEN; }
+    int treeParent(int v) const { return (v>=0 && v<(int)parents.size()) ? parents[v] : -1; }
+
+private:
+    const Trace *trace;
+    std::vector<unsigned char> states;
+    std::vector<int> parents;
+    size_t cursor;                          // events [0, cursor) applied
+    uint32_t pos;                           // steps applied
+    double rate, clock;
+    bool paused;
+
+    void apply(const TraceEvent &e, std::vector<int> &changed);
+    void revert(const TraceEvent &e, std::vector<int> &changed);
+};
+
+#endif
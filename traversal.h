@@ -0,0 +1,49 @@
+/* traversal.h - BFS / DFS over any adjacency that exposes
+   vertexCount(), degree(u) and target(u,i) (Graph and CsrView both do).
+   Visited state is kept in a local array, not in Node::visited. */
+#ifndef TRAVERSAL_H
+#define TRAVERSAL_H
+
+#include <vector>
+
+/* --- BFS: vertices in dequeue order --- */
+template<class G>
+void bfsOrder(const G &g, int start, std::vector<int> &order){
+    order.clear();
+    int n = g.vertexCount();
+    if(start<0||start>=n) return;
+    std::vector<char> seen(n, 0);
+    order.reserve(n);
+    size_t head = 0;                        // `order` doubles as the FIFO queue
+    order.push_back(start); seen[start]=1;
+    while(head<order.size()){
+        int u=order[head++];
+        int d=g.degree(u);
+        for(int k=0;k<d;k++){
+            int v=g.target(u,k);
+            if(!seen[v]){ seen[v]=1; order.push_back(v); }
+        }
+    }
+}
+
+/* --- DFS: vertices in visit order; neighbours pushed in reverse so the
+   first listed neighbour is explored first --- */
+template<class G>
+void dfsOrder(const G &g, int start, std::vector<int> &order){
+    order.clear();
+    int n = g.vertexCount();
+    if(start<0||start>=n) return;
+    std::vector<char> seen(n, 0);
+    std::vector<int> st; st.push_back(start);
+    while(!st.empty()){
+        int u=st.back(); st.pop_back();
+        if(seen[u]) continue;
+        seen[u]=1; order.push_back(u);
+        for(int i=g.degree(u)-1;i>=0;i--){
+            int v=g.target(u,i);
+            if(!seen[v]) st.push_back(v);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,135 @@
+/* viewport.cpp - camera transforms and the aggregated level of detail */
+#include "viewport.h"
+
+#include <algorithm>
+
+using namespace std;
+
+Rect Viewport::toScreen(const Rect &w, int pad) const {
+    return makeRect(toScreenX(w.x0)-pad-1, toScreenY(w.y0)-pad-1, toScreenX(w.x1)+pad+1, toScreenY(w.y1)+pad+1);
+}
+
+Rect Viewport::toWorld(const Rect &s) const {
+    return makeRect((int)floor((s.x0 - tx)/scale), (int)floor((s.y0 - ty)/scale),
+                    (int)ceil((s.x1 - tx)/scale), (int)ceil((s.y1 - ty)/scale));
+}
+
+void Viewport::zoomAbout(int x,int y,double factor){
+    double next = min(VIEW_MAX_SCALE, max(VIEW_MIN_SCALE, scale*factor));
+    double wx = (x - tx)/scale, wy = (y - ty)/scale;
+    scale = next;
+    tx = x - wx*scale;
+    ty = y - wy*scale;
+}
+
+/* --- floor(v / 2^s) for negative coordinates too --- */
+static int floorShift(int v,int s){
+    int64_t c = (int64_t)1 << s;
+    return v >= 0 ? (int)(v >> s) : -(int)((-(int64_t)v + c - 1) >> s);
+}
+
+static int64_t gridKey(int gx,int gy){ return (int64_t)(((uint64_t)(uint32_t)gx << 32) | (uint32_t)gy); }
+
+void GridBundles::invalidate(){
+    for(size_t i=0;i<levels.size();i++) levels[i].built = levels[i].over = false;
+}
+
+void GridBundles::build(const Graph &g, Level &L){
+    int s = L.shift;
+    L.cells.clear(); L.bundles.clear(); L.index.clear();
+    L.built = true;
+    L.over = false;
+    buildCount++;
+    vector<int> cellOf(g.slotCount(), -1);
+    vector<int64_t> sumX, sumY;
+    for(int v=0;v<g.slotCount();v++){
+        if(!g.nodes[v].alive) continue;
+        int gx = floorShift(g.nodes[v].x, s), gy = floorShift(g.nodes[v].y, s);
+        pair<unordered_map<int64_t,int>::iterator,bool> in = L.index.insert(make_pair(gridKey(gx,gy), (int)L.cells.size()));
+        if(in.second){
+            Cell c = { gx, gy, 0, 0, 0 };
+            L.cells.push_back(c); sumX.push_back(0); sumY.push_back(0);
+        }
+        int c = in.first->second;
+        cellOf[v] = c;
+        L.cells[c].nodes++;
+        sumX[c] += g.nodes[v].x; sumY[c] += g.nodes[v].y;
+    }
+    for(size_t c=0;c<L.cells.size();c++){
+        L.cells[c].x = (int)(sumX[c] / L.cells[c].nodes);
+        L.cells[c].y = (int)(sumY[c] / L.cells[c].nodes);
+    }
+
+    /* an undirected edge counts once (from its lower endpoint), a directed
+       one in either direction joins the same bundle */
+    unordered_map<int64_t,int> pairs;
+    for(int u=0;u<g.slotCount();u++){
+        for(int k=0;k<g.degree(u);k++){
+            int v = g.target(u,k);
+            if(!g.directed && v < u) continue;
+            int a = cellOf[u], b = cellOf[v];
+            if(a == b) continue;
+            if(a > b) swap(a, b);
+            pair<unordered_map<int64_t,int>::iterator,bool> in = pairs.insert(make_pair(gridKey(a,b), (int)L.bundles.size()));
+            if(in.second){
+                Bundle bd = { a, b, 0 };
+                L.bundles.push_back(bd);
+                /* too fine to draw: stop here, the caller moves to a
+                   coarser level (a finer grid never has fewer bundles) */
+                if(L.bundles.size() > MAX_BUNDLES && s < 30){
+                    L.over = true;
+                    vector<Cell>().swap(L.cells);
+                    vector<Bundle>().swap(L.bundles);
+                    unordered_map<int64_t,int>().swap(L.index);
+                    return;
+                }
+            }
+            L.bundles[in.first->second].edges++;
+        }
+    }
+    L.first.assign(L.cells.size() + 1, 0);
+    for(size_t i=0;i<L.bundles.size();i++){ L.first[L.bundles[i].a + 1]++; L.first[L.bundles[i].b + 1]++; }
+    for(size_t c=0;c<L.cells.size();c++) L.first[c+1] += L.first[c];
+    L.refs.resize(L.first[L.cells.size()]);
+    vector<int> at(L.first.begin(), L.first.end() - 1);
+    for(size_t i=0;i<L.bundles.size();i++){ L.refs[at[L.bundles[i].a]++] = (int)i; L.refs[at[L.bundles[i].b]++] = (int)i; }
+}
+
+const GridBundles::Level &GridBundles::level(const Graph &g, double minCell){
+    int shift = 0;
+    while(shift < 30 && (double)((int64_t)1 << shift) < minCell) shift++;
+    if(levels.size() < 31){
+        size_t old = levels.size();
+        levels.resize(31);
+        for(size_t i=old;i<levels.size();i++){ levels[i].shift = (int)i; levels[i].built = levels[i].over = false; }
+    }
+    /* the same zoom as last time resumes where that search ended, so an
+       edit (or a layout frame) rebuilds one level, not every finer one */
+    int asked = shift;
+    if(asked == hintAsked) shift = max(shift, hintGiven);
+    for(;; shift++){
+        Level &L = levels[shift];
+        if(!L.built) build(g, L);
+        if(!L.over){ hintAsked = asked; hintGiven = shift; return L; }
+    }
+}
+
+void GridBundles::cellsInRect(const Level &L, const Rect &w, vector<int> &out,
+                              int *gx0, int *gy0, int *gx1, int *gy1) const {
+    out.clear();
+    *gx0 = floorShift(w.x0, L.shift); *gy0 = floorShift(w.y0, L.shift);
+    *gx1 = floorShift(w.x1, L.shift); *gy1 = floorShift(w.y1, L.shift);
+    int64_t range = (int64_t)(*gx1 - *gx0 + 1) * (*gy1 - *gy0 + 1);
+    if(range > (int64_t)L.cells.size()){
+        for(size_t c=0;c<L.cells.size();c++){
+            const Cell &cl = L.cells[c];
+            if(cl.gx >= *gx0 && cl.gx <= *gx1 && cl.gy >= *gy0 && cl.gy <= *gy1) out.push_back((int)c);
+        }
+        return;
+    }
+    for(int gx=*gx0; gx<=*gx1; gx++)
+        for(int gy=*gy0; gy<=*gy1; gy++){
+            unordered_map<int64_t,int>::const_iterator it = L.index.find(gridKey(gx,gy));
+            if(it != L.index.end()) out.push_back(it->second);
+        }
+}
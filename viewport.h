@@ -0,0 +1,118 @@
+/* viewport.h - the editor's camera.  Nodes live in world coordinates
+   (what files store and the spatial index holds); a Viewport maps them to
+   screen pixels with a zoom and a pan, and back for hit testing.  At
+   scale 1 with no pan, world and screen coincide, as before there was a
+   camera.
+
+   Level of detail follows the zoom: labels and weight boxes go first,
+   then arrow heads, and far out (or wherever the view holds more than a
+   frame's budget of geometry) the graph is drawn from GridBundles
+   instead - one dot per occupied grid cell and one line per pair of cells
+   with edges between them - so a frame costs what is on screen, not what
+   is in the graph. */
+#ifndef VIEWPORT_H
+#define VIEWPORT_H
+
+#include "damage.h"
+#include "graph_core.h"
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <unordered_map>
+#include <vector>
+
+const double VIEW_MIN_SCALE = 1.0/256;
+const double VIEW_MAX_SCALE = 8.0;
+const double LOD_TEXT_SCALE = 0.6;      // labels and weight boxes from this zoom up
+const double LOD_ARROW_SCALE = 0.35;    // arrow heads from this zoom up
+const double LOD_BUNDLE_SCALE = 0.2;    // below this zoom the graph is always aggregated
+const int LOD_CELL_PX = 8;              // aggregate grid cells are at least this many pixels wide
+const int64_t LOD_ITEM_BUDGET = 20000;  // spatial-index entries in view before aggregating anyway
+
+/* --- World <-> screen: screen = world * scale + (tx, ty) --- */
+class Viewport {
+public:
+    double scale;
+    double tx, ty;                      // screen position of the world origin
+
+    Viewport(): scale(1.0), tx(0.0), ty(0.0) {}
+
+    int toScreenX(double x) const { return (int)floor(x*scale + tx + 0.5); }
+    int toScreenY(double y) const { return (int)floor(y*scale + ty + 0.5); }
+    int toScreenLen(double d) const { int l = (int)(d*scale + 0.5); return l < 1 ? 1 : l; }
+    int toWorldX(int x) const { return (int)floor((x - tx)/scale + 0.5); }
+    int toWorldY(int y) const { return (int)floor((y - ty)/scale + 0.5); }
+    double toWorldLen(double d) const { return d/scale; }
+
+    /* screen rectangle covering a world one, grown by pad pixels (text
+       keeps its pixel size at any zoom); and the world rectangle under a
+       screen one */
+    Rect toScreen(const Rect &world, int pad = 0) const;
+    Rect toWorld(const Rect &screen) const;
+
+    void panBy(int dx,int dy){ tx += dx; ty += dy; }
+    void zoomAbout(int x,int y,double factor);      // keeps the world point under (x,y) in place
+    void reset(){ scale = 1.0; tx = ty = 0.0; }
+    bool identity() const { return scale == 1.0 && tx == 0.0 && ty == 0.0; }
+
+    bool showText() const { return scale >= LOD_TEXT_SCALE; }
+    bool showArrows() const { return scale >= LOD_ARROW_SCALE; }
+};
+
+/* --- The graph aggregated on square grids of 2^shift world units ---
+   A level is built on first use (O(nodes + edges)) and kept until the
+   graph changes; attach the object as an observer of the graph. */
+class GridBundles : public GraphObserver {
+public:
+    struct Cell {
+        int gx, gy;                     // grid coordinates
+        int x, y;                       // mean position of its nodes (world)
+        int nodes;
+    };
+    struct Bundle {
+        int a, b;                       // cell indices, a < b
+        int edges;                      // edges between the two cells (either direction)
+    };
+    struct Level {
+        int shift;
+        bool built;
+        bool over;                      // more than MAX_BUNDLES: skipped, contents dropped
+        std::vector<Cell> cells;
+        std::vector<Bundle> bundles;
+        std::vector<int> first, refs;   // bundles touching cell c: refs[first[c] .. first[c+1])
+        std::unordered_map<int64_t, int> index;     // grid key -> cell
+    };
+
+    static const size_t MAX_BUNDLES = 20000;
+
+    GridBundles(): buildCount(0), hintAsked(-1), hintGiven(-1) {}
+
+    /* the finest level whose cells are at least minCell world units wide
+       and which has at most MAX_BUNDLES bundles (after an edit, the level
+       chosen before it, if coarser) */
+    const Level &level(const Graph &g, double minCell);
+
+    /* cells of L overlapping a world rectangle; grid range in *gx0.. */
+    void cellsInRect(const Level &L, const Rect &world, std::vector<int> &out,
+                     int *gx0, int *gy0, int *gx1, int *gy1) const;
+
+    int64_t builds() const { return buildCount; }
+
+    void nodeInserted(const Graph &,int){ invalidate(); }
+    void nodeRemoved(const Graph &,int){ invalidate(); }
+    void nodeMoved(const Graph &,int){ invalidate(); }
+    void edgeAdded(const Graph &,int,int){ invalidate(); }
+    void edgeRemoved(const Graph &,int,int){ invalidate(); }
+    void graphReset(const Graph &){ invalidate(); }
+
+private:
+    std::vector<Level> levels;          // by shift
+    int64_t buildCount;
+    int hintAsked, hintGiven;           // the last level() search: first shift tried, shift returned
+
+    void invalidate();
+    void build(const Graph &g, Level &L);
+};
+
+#endif